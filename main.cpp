@@ -8,9 +8,12 @@
 #include "params/ParamStoreSimple.h"
 #include "devices/SamplerNode.h"
 #include "devices/SynthNode.h"
+#include "devices/Wavetable.h"
 #include "mixer/MixerSimple.h"
 #include "sequencer/Sequencer.h"
 #include "project/Project.h"
+#include "fx/FxRegistry.h"
+#include "utils/CacheDir.h"
 #include "utils/WavLoader.h"
 #ifdef __APPLE__
 #include "platform/macos/AudioOut.h"
@@ -23,6 +26,13 @@ int main() {
     engine.bus    = std::make_shared<EventBusSimple>();
     engine.params = std::make_shared<ParameterStoreSimple>();
 
+    // FX: встроенные эффекты; пулы прогреваются в engine.prepare по размерам из проекта
+    Project prj;
+    prj.load("alchemy_project.txt");
+    engine.fx = std::make_shared<FxRegistry>();
+    registerBuiltinFx(*engine.fx);
+    for (const auto& fp : prj.fxPools) engine.fx->setPoolSize(fp.type, fp.count);
+
     // Create nodes
     auto sampler = std::make_shared<SamplerNode>("sampler1");
     std::string wavPath = "assets/BRUSTREET-KICK.wav"; // поменяй на свой путь
@@ -44,6 +54,13 @@ int main() {
     //ЗАГРУЗКА СЕМПЛА ОКОНЧЕНА
 
     auto synth   = std::make_shared<SynthNode>("synth1");
+
+    // Волновые таблицы: первый старт генерирует мипы и пишет кеш, дальше — mmap кеша.
+    // Кеш — в пользовательском каталоге (не в текущем), ALCHEMY_CACHE_DIR переопределяет
+    auto wavetables = std::make_shared<WavetableBank>();
+    if (wavetables->build(WavetableBank::builtinSources(), userCachePath("wavetables.cache"))) {
+        synth->setWavetable(wavetables, wavetables->find("saw"));
+    }
     auto mixer   = std::make_shared<MixerSimple>("mixer");
 
 
@@ -60,18 +77,11 @@ int main() {
     engine.prepare(ctx);
 
     // Wire EventBus to respond to Sequencer events (very simple demo)
-    engine.bus->subscribe([&](const Event& e){
-        if (std::holds_alternative<EvPadPressed>(e)) {
-            auto ev = std::get<EvPadPressed>(e);
-            if (ev.on) sampler->noteOnPad(ev.pad, 1.0f);
-        } else if (std::holds_alternative<EvNoteOn>(e)) {
-            auto ev = std::get<EvNoteOn>(e);
-            synth->noteOn(ev.note, ev.vel);
-        } else if (std::holds_alternative<EvNoteOff>(e)) {
-            auto ev = std::get<EvNoteOff>(e);
-            synth->noteOff(ev.note);
-        }
+    engine.bus->on<EvPadPressed>([&](const EvPadPressed& ev){
+        if (ev.on) sampler->noteOnPad(ev.pad, 1.0f);
     });
+    engine.bus->on<EvNoteOn>([&](const EvNoteOn& ev){ synth->noteOn(ev.note, ev.vel); });
+    engine.bus->on<EvNoteOff>([&](const EvNoteOff& ev){ synth->noteOff(ev.note); });
     engine.bus->commit();
 
 
@@ -91,7 +101,6 @@ int main() {
     seq.setPattern(pat);
 
     // Save project
-    Project prj;
     prj.pattern = pat;
     prj.save("alchemy_project.txt");
 
@@ -127,8 +136,11 @@ int main() {
         engine.process(buf, midi, c);
     });
 
-    // держим процесс живым (без потоков, без ввода)
-    for(;;) std::this_thread::sleep_for(std::chrono::seconds(1));
+    // держим процесс живым; ~30 кадров/с разбираем журнал параметров (слушатели UI — здесь, не в аудио)
+    for(;;) {
+        engine.params->dispatchChanges();
+        std::this_thread::sleep_for(std::chrono::milliseconds(33));
+    }
 #else
     // Если НЕ macOS — можно оставить оффлайн тест (не звучит, но проверяет процессинг)
     float ch0[512] = {0};
@@ -140,6 +152,7 @@ int main() {
     for (int i=0;i<16;i++) {
         seq.tick();
         engine.process(buf, midi, ctx);
+        engine.params->dispatchChanges();
     }
 #endif
 }
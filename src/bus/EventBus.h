@@ -1,8 +1,11 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
-#include <string>
-#include <variant>
-#include <vector>
+#include <type_traits>
+#include "bus/StringArena.h"
 
 /**
  * EvPadPressed
@@ -63,9 +66,11 @@ struct EvNoteOff { int note; };
  *     декодировать → поместить буфер в кеш → затем атомарно
  *     привязать к пэду (или отправить вторичное EvAssignSampleToPad).
  *
+ * Путь — в StringArena шины (IEventBus::strings().intern/view), в событии — только id.
+ *
  * Типичный обработчик: SampleLibrary/Loader + PadAssignment.
  */
-struct EvLoadSample { int pad; std::string path; };
+struct EvLoadSample { int pad; StringId path; };
 
 /**
  * EvTransport
@@ -134,8 +139,23 @@ struct EvSeqSetPattern { int index; };
  *   - Любое РАЗОВОЕ действие, богатое данными → событие (EventBus).
  *   - Любой НЕПРЕРЫВНЫЙ параметр (ADSR, DRAG, SEND, макросы) → ParamStore (атомики),
  *     читается DSP-тредом и сглаживается на стороне DSP.
+ *
+ * Event — фиксированного размера и тривиально копируется (тег типа + байты полезной нагрузки):
+ * push в MPSC-кольцо — memcpy без аллокаций; строки — через StringArena.
+ * Индекс типа известен при компиляции (eventTypeOf<T>) — по нему таблица обработчиков шины.
  */
-using Event = std::variant<
+template<class... Ts> struct EventList {
+    static constexpr size_t size = sizeof...(Ts);
+    template<class T> static constexpr size_t indexOf() {
+        size_t i = 0, r = sizeof...(Ts);
+        ((std::is_same_v<T, Ts> ? (r = i, ++i) : ++i), ...);
+        return r;
+    }
+    static constexpr size_t maxSize  = std::max({sizeof(Ts)...});
+    static constexpr bool   trivial  = (std::is_trivially_copyable_v<Ts> && ...);
+};
+
+using Events = EventList<
         EvPadPressed,
         EvNoteOn,
         EvNoteOff,
@@ -145,13 +165,40 @@ using Event = std::variant<
         EvSeqSetSwing,
         EvSeqSetPattern
 >;
+static_assert(Events::trivial, "события должны быть тривиально копируемыми (строки — через StringArena)");
+
+using EventType = uint8_t;
+inline constexpr size_t kEventTypeCount = Events::size;
+template<class T> inline constexpr EventType eventTypeOf = (EventType)Events::indexOf<T>();
+
+struct Event {
+    EventType type = 0;
+    alignas(8) unsigned char payload[Events::maxSize]{};
+
+    Event() = default;
+    template<class T, class = std::enable_if_t<(Events::indexOf<T>() < Events::size)>>
+    Event(const T& e) noexcept : type(eventTypeOf<T>) { std::memcpy(payload, &e, sizeof e); }
+
+    template<class T> bool is() const noexcept { return type == eventTypeOf<T>; }
+    template<class T> T as() const noexcept { T v; std::memcpy(&v, payload, sizeof v); return v; } // is<T>() обязателен
+};
+static_assert(std::is_trivially_copyable_v<Event>);
 
 struct IEventBus {
     virtual ~IEventBus() = default;
     using Handler = std::function<void(const Event&)>;
     virtual void publish(const Event& e) = 0;          // UI -> Engine
-    virtual void subscribe(Handler h) = 0;             // Engine -> UI updates
     virtual void commit() = 0;
-    virtual void publishFromUI(const Event& e) = 0;
-    virtual void drainUIEvents() = 0;
-};
\ No newline at end of file
+    virtual void publishFromUI(const Event& e) = 0;    // любой поток (UI/MIDI/OSC/секвенсор)
+    virtual void drainUIEvents() = 0;                  // один поток-потребитель (аудио)
+    virtual StringArena& strings() = 0;                // строковые полезные нагрузки событий
+
+    // Подписка на ОДИН тип: обработчик видит только свои события (до commit)
+    template<class T, class F>
+    void on(F&& f) {
+        subscribe(eventTypeOf<T>, [f = std::forward<F>(f)](const Event& e) { f(e.as<T>()); });
+    }
+
+protected:
+    virtual void subscribe(EventType type, Handler h) = 0;
+};
@@ -1,26 +1,20 @@
 #pragma once
 #include "bus/EventBus.h"
+#include <array>
 #include <mutex>
-#include <utils/SpscRing.h>
+#include <vector>
+#include <utils/MpscRing.h>
 
 class EventBusSimple : public IEventBus {
 public:
     void publishFromUI(const Event& e) override {
-        spscQueue_.push(e);
+        (void)queue_.push(e);                    // memcpy фиксированного Event; полна — событие теряется
     }
     void drainUIEvents() override {
-        Event ev;
-
-        while (spscQueue_.pop(ev)) {
-            publish(ev);
-        }
+        queue_.drain([this](const Event& ev) { publish(ev); }); // прямо из ячеек кольца
     }
-    void publish(const Event& e) override {
-        for (auto& h : handlers_) h(e);
-    }
-    void subscribe(Handler h) override {
-        std::lock_guard<std::mutex> lk(mu_);
-        staging_.push_back(std::move(h));
+    void publish(const Event& e) override {       // только подписчики этого типа
+        for (auto& h : handlers_[e.type]) h(e);
     }
     void commit() override {
         if (freeze_) {
@@ -30,10 +24,21 @@ public:
         handlers_ = staging_;
         freeze_ = true;
     }
+    StringArena& strings() override { return strings_; }
+
+protected:
+    void subscribe(EventType type, Handler h) override {
+        std::lock_guard<std::mutex> lk(mu_);
+        staging_[type].push_back(std::move(h));
+    }
+
 private:
+    using Table = std::array<std::vector<Handler>, kEventTypeCount>; // [тип события] → обработчики
+
     bool freeze_{false};
     std::mutex mu_;
-    std::vector<Handler> handlers_;
-    std::vector<Handler> staging_;
-    SpscRing<Event, 1024> spscQueue_;
-};
\ No newline at end of file
+    Table handlers_;
+    Table staging_;
+    MpscRing<Event, 1024> queue_;             // продюсеров много (UI, MIDI, OSC), читает аудио
+    StringArena strings_;
+};
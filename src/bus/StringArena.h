@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// Ссылка на строку в StringArena (0 — нет строки). Тривиально копируется — годится в Event.
+struct StringId {
+    uint32_t v = 0;
+    explicit operator bool() const noexcept { return v != 0; }
+};
+
+/**
+ * StringArena
+ * ----------------------------------------------------------------
+ * Строковые полезные нагрузки событий (пути файлов и т.п.) живут здесь, а в событии — только StringId.
+ *
+ * ► intern(): НЕ RT (аллокация + mutex), любой не-аудио поток; каждый вызов — новый id в самом
+ *   свежем слоте, даже для уже виденной строки. Без дедупа: старый id повторной строки мог бы
+ *   стоять на вытеснении следующим, и событие с ним читало бы чужую строку/пустоту.
+ * ► view():   любой поток, без локов — string_view на неизменяемую строку.
+ * ► Кольцо на kCapacity строк: id действителен, пока после него не интернировано ещё
+ *   kCapacity строк (вытесненная строка освобождается только ещё через круг) — с запасом
+ *   на любую задержку между publish и обработчиком. Вытесненный id → пустой view.
+ */
+class StringArena {
+public:
+    static constexpr uint32_t kCapacity = 1024;
+
+    StringId intern(std::string_view s) {
+        std::lock_guard<std::mutex> lk(mu_);
+        const uint32_t id = ++seq_ == 0 ? ++seq_ : seq_;   // 0 зарезервирован
+        const size_t slot = id % kCapacity;
+        retired_[slot] = std::move(owned_[slot]);            // прошлый круг — ещё живёт
+        owned_[slot] = std::make_unique<Entry>(Entry{id, std::string(s)});
+        slots_[slot].store(owned_[slot].get(), std::memory_order_release);
+        return StringId{id};
+    }
+
+    std::string_view view(StringId id) const noexcept {
+        if (!id) return {};
+        const Entry* e = slots_[id.v % kCapacity].load(std::memory_order_acquire);
+        return e && e->id == id.v ? std::string_view(e->str) : std::string_view{};
+    }
+
+private:
+    struct Entry {
+        uint32_t    id;
+        std::string str;
+    };
+
+    std::mutex mu_;
+    uint32_t   seq_ = 0;
+    std::array<std::atomic<const Entry*>, kCapacity> slots_{};
+    std::array<std::unique_ptr<Entry>, kCapacity> owned_, retired_;
+};
@@ -0,0 +1,155 @@
+#include "core/FxLifecycle.h"
+#include <utility>   // std::move
+
+FxLifecycle::~FxLifecycle()
+{
+    {
+        std::lock_guard<std::mutex> lk(jobsMx_);
+        stop_ = true;
+    }
+    jobsCv_.notify_all();
+    running_.store(false, std::memory_order_release);
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_all();
+    if (builder_.joinable())   builder_.join();
+    if (reclaimer_.joinable()) reclaimer_.join();
+
+    // Потоки стоят: доудаляем всё, что не успело дойти до аудиопотока или до reclaim
+    TrackCommand cmd;
+    while (jobs_.pop(cmd)) dispose(cmd);
+    while (ready_.pop(cmd)) dispose(cmd);
+    CmdInsertFx ins{};
+    while (stale_.pop(ins)) delete ins.fx;
+    drainRetired();
+}
+
+void FxLifecycle::prepare(int sampleRate, int blockSize)
+{
+    if (sampleRate == sr_.load(std::memory_order_relaxed) && blockSize == bs_.load(std::memory_order_relaxed)) return;
+    sr_.store(sampleRate, std::memory_order_relaxed);
+    bs_.store(blockSize, std::memory_order_relaxed);
+    resync_.store(true, std::memory_order_release); // будить builder — дело reclaim-потока
+}
+
+void FxLifecycle::start()
+{
+    if (running_.exchange(true, std::memory_order_acq_rel)) return;
+    builder_   = std::thread([this]{ builderLoop(); });
+    reclaimer_ = std::thread([this]{ reclaimLoop(); });
+}
+
+bool FxLifecycle::submit(const TrackCommand& cmd)
+{
+    if (!jobs_.push(cmd)) return false;
+    wake_.fetch_add(1, std::memory_order_release);
+    wake_.notify_one();
+    return true;
+}
+
+void FxLifecycle::retire(IFx* fx) noexcept
+{
+    if (!fx) return;
+    // Кольцо полно только если reclaim-поток стоит дольше 1024 удалений подряд —
+    // крайний случай, удаляем на месте, чем теряем память.
+    if (!retired_.push(fx)) delete fx;
+}
+
+void FxLifecycle::requeue(const CmdInsertFx& cmd) noexcept
+{
+    if (!stale_.push(cmd)) retire(cmd.fx);
+}
+
+void FxLifecycle::builderLoop()
+{
+    bool refill = false; // после CmdAddFx — IFxRegistry::maintain() в простое
+    for (;;) {
+        // счётчик — ДО pop: submit, опубликованный после проверки, сменит его, и wait() не уснёт
+        const uint32_t seen = wake_.load(std::memory_order_acquire);
+        if (!running_.load(std::memory_order_acquire)) return;
+
+        // SR/блок сменились: пулы реестра — под новые (до команд, чтобы create() брал из пула)
+        if (resync_.exchange(false, std::memory_order_acq_rel)) {
+            if (IFxRegistry* reg = registry_.load(std::memory_order_acquire))
+                reg->prepare(sr_.load(std::memory_order_relaxed), bs_.load(std::memory_order_relaxed));
+            continue;
+        }
+
+        TrackCommand cmd;
+        if (!jobs_.pop(cmd)) {
+            if (refill) { // простой: доливаем пулы реестра
+                refill = false;
+                if (IFxRegistry* reg = registry_.load(std::memory_order_acquire)) reg->maintain();
+                continue;
+            }
+            wake_.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+
+        // Тяжёлая часть — здесь, а не в аудиопотоке: аллокации, таблицы, загрузка IR и т.п.
+        if (const auto* add = std::get_if<CmdAddFx>(&cmd)) {
+            IFxRegistry* reg = registry_.load(std::memory_order_acquire);
+            if (!reg) continue;
+            const int sr = sr_.load(std::memory_order_relaxed);
+            const int bs = bs_.load(std::memory_order_relaxed);
+            auto fx = reg->createPrepared(add->type, sr, bs);
+            if (!fx) continue;
+            cmd = CmdInsertFx{add->track, add->index, fx.release(), sr, bs};
+            refill = true;
+        } else if (auto* ins = std::get_if<CmdInsertFx>(&cmd)) { // вернулась из аудио (requeue)
+            const int sr = sr_.load(std::memory_order_relaxed);
+            const int bs = bs_.load(std::memory_order_relaxed);
+            if (ins->sampleRate != sr || ins->blockSize != bs) {
+                ins->fx->prepare(sr, bs);
+                ins->sampleRate = sr;
+                ins->blockSize  = bs;
+            }
+        }
+
+        // Аудиопоток забирает раз в блок; если кольцо полно — ждём, порядок команд не ломаем
+        while (!ready_.push(cmd)) {
+            if (!running_.load(std::memory_order_acquire)) { dispose(cmd); return; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void FxLifecycle::reclaimLoop()
+{
+    while (running_.load(std::memory_order_acquire)) {
+        drainRetired();
+        resubmitStale();
+        if (resync_.load(std::memory_order_acquire)) { // SR/блок из аудиопотока — builder сам не проснётся
+            wake_.fetch_add(1, std::memory_order_release);
+            wake_.notify_one();
+        }
+        std::unique_lock<std::mutex> lk(jobsMx_);
+        if (jobsCv_.wait_for(lk, kReclaimPeriod, [this]{ return stop_; })) break;
+    }
+    drainRetired();
+}
+
+void FxLifecycle::drainRetired() noexcept
+{
+    IFx* fx = nullptr;
+    while (retired_.pop(fx)) delete fx;
+}
+
+void FxLifecycle::resubmitStale()
+{
+    CmdInsertFx ins{};
+    while (stale_.pop(ins)) {
+        // очередь builder-а полна — подождать его (как builder ждёт аудио на ready_)
+        while (!submit(ins)) {
+            if (!running_.load(std::memory_order_acquire)) { delete ins.fx; break; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void FxLifecycle::dispose(TrackCommand& cmd) noexcept
+{
+    if (auto* ins = std::get_if<CmdInsertFx>(&cmd)) {
+        delete ins->fx;
+        ins->fx = nullptr;
+    }
+}
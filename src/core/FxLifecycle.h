@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "core/TrackCommands.h"
+#include "devices/IFXFactory.h"
+#include "utils/MpscRing.h"
+#include "utils/SpscRing.h"
+
+/**
+ * \brief Жизненный цикл FX вне аудиопотока: создание/prepare — на рабочем потоке,
+ *        удаление — на потоке утилизации.
+ *
+ * Поток команд трекового слоя:
+ *   UI/MIDI/OSC → submit(cmd) → MpscRing → builder-поток
+ *      → (CmdAddFx: registry->create + prepare → CmdInsertFx с готовым IFx*)
+ *      → SpscRing → аудиопоток: drainCommands() → TrackManager::apply(...)
+ *
+ * Все команды идут через builder-поток, поэтому порядок команд одного продюсера сохраняется:
+ * CmdSetFxParam сразу после CmdAddFx попадёт уже в вставленный эффект. Продюсеры не делят
+ * мьютекс — каждый занимает ячейку кольца CAS-ом; builder спит на счётчике wake_.
+ *
+ * В простое (очередь пуста после CmdAddFx) builder зовёт IFxRegistry::maintain() —
+ * реестр доливает пулы готовых экземпляров, не задерживая уже поданные команды.
+ * Смена SR/блока (prepare) доходит до реестра тоже через builder: IFxRegistry::prepare()
+ * переготавливает пулы под новые SR/блок (builder будит reclaim-поток, как и для requeue).
+ *
+ * Удаление: аудиопоток отдаёт снятый с цепочки эффект в retire() (lock-free кольцо),
+ * reclaim-поток периодически забирает и удаляет их. Аудиопоток никогда не будит
+ * другие потоки — reclaim опрашивает кольцо сам (kReclaimPeriod).
+ *
+ * Устаревшие вставки: если SR/блок сменились, пока CmdInsertFx шла к аудиопотоку, тот
+ * не зовёт prepare(), а отдаёт команду в requeue(). Reclaim-поток переподаёт её в очередь
+ * builder-а, builder переготавливает эффект под текущие SR/блок и шлёт вставку снова
+ * (после команд, поданных тем временем).
+ *
+ * \note Потоки стартуют в start() (движок зовёт из prepare) и останавливаются в деструкторе.
+ *       Команды, поданные до start(), ждут в очереди.
+ */
+class FxLifecycle {
+public:
+    FxLifecycle() = default;
+    ~FxLifecycle();
+
+    FxLifecycle(const FxLifecycle&) = delete;
+    FxLifecycle& operator=(const FxLifecycle&) = delete;
+
+    /// Фабрика эффектов (не владеем). НЕ RT; можно менять на ходу.
+    void setRegistry(IFxRegistry* registry) { registry_.store(registry, std::memory_order_release); }
+
+    /// SR/размер блока, с которыми builder готовит новые эффекты. RT-безопасно (только атомики):
+    /// реестр синхронизирует builder, его будит reclaim-поток в течение kReclaimPeriod.
+    void prepare(int sampleRate, int blockSize);
+
+    /// Запустить builder/reclaim потоки (повторный вызов — no-op). НЕ RT.
+    void start();
+
+    /**
+     * \brief Подать команду трекового слоя (любой не-RT поток, без блокировок).
+     *
+     * CmdAddFx превращается builder-потоком в CmdInsertFx с уже подготовленным эффектом;
+     * остальные команды пересылаются как есть.
+     * \return false — очередь полна (kJobs команд не разобраны builder-ом), команда не принята.
+     */
+    bool submit(const TrackCommand& cmd);
+
+    /// RT: f(const TrackCommand&) на все готовые команды — прямо в ячейках кольца, одной пачкой
+    /// (без копий; строки команд освобождает builder, перезаписывая ячейку). f не бросает.
+    template<class F>
+    size_t drainCommands(F&& f) noexcept { return ready_.drain([&](TrackCommand& c) { f(std::as_const(c)); }); }
+
+    /**
+     * \brief RT: отдать снятый с цепочки эффект на удаление вне аудиопотока.
+     *
+     * Владение передаётся. nullptr игнорируется.
+     */
+    void retire(IFx* fx) noexcept;
+
+    /**
+     * \brief RT: вернуть вставку, подготовленную под прежние SR/блок, на переготовку.
+     *
+     * Владение эффектом передаётся. Кольцо полно — эффект уходит в retire() (вставка теряется).
+     */
+    void requeue(const CmdInsertFx& cmd) noexcept;
+
+private:
+    static constexpr auto kReclaimPeriod = std::chrono::milliseconds(20);
+    static constexpr size_t kJobs = 1024;
+
+    void builderLoop();
+    void reclaimLoop();
+    void drainRetired() noexcept;
+    void resubmitStale();                     // reclaim: устаревшие вставки → очередь builder-а
+    void dispose(TrackCommand& cmd) noexcept; // удалить эффект из непримененной CmdInsertFx
+
+    std::atomic<IFxRegistry*> registry_{nullptr};
+    std::atomic<int> sr_{48000};
+    std::atomic<int> bs_{512};
+    std::atomic<bool> resync_{true};         // SR/блок сменились — builder отдаст их реестру
+
+    // продюсеры → builder
+    MpscRing<TrackCommand, kJobs> jobs_;
+    std::atomic<uint32_t>   wake_{0};        // растёт на каждый submit/останов — builder ждёт его смены
+
+    // останов reclaim-потока
+    std::mutex              jobsMx_;
+    std::condition_variable jobsCv_;
+    bool                    stop_ = false;   // под jobsMx_
+
+    // builder → аудио, аудио → reclaim
+    SpscRing<TrackCommand, 1024> ready_;
+    SpscRing<IFx*, 1024>         retired_;
+    SpscRing<CmdInsertFx, 64>    stale_;
+
+    std::atomic<bool> running_{false};
+    std::thread builder_;
+    std::thread reclaimer_;
+};
@@ -6,6 +6,7 @@
 Track::Track(int id)
         : id_(id)
 {
+    chain_.reserve(kMaxChain);
 }
 
 void Track::prepare(int sampleRate, int blockSize)
@@ -40,12 +41,22 @@ void Track::processChain()
     }
 }
 
+void Track::setTempo(double bpm) noexcept
+{
+    if (bpm <= 0.0 || bpm == tempo_) return;
+    tempo_ = bpm;
+    for (auto& fx : chain_) {
+        if (fx) fx->setTempo(tempo_);
+    }
+}
+
 // ===== редактирование цепочки (НЕ RT) =====
 
 bool Track::addEffect(std::unique_ptr<IFx> fx)
 {
     if (!fx) return false;
     fx->prepare(sr_, bs_);
+    fx->setTempo(tempo_);
     chain_.push_back(std::move(fx));
     return true;
 }
@@ -55,6 +66,7 @@ bool Track::insertEffect(size_t index, std::unique_ptr<IFx> fx)
     if (!fx) return false;
     if (index > chain_.size()) return false; // можно вставлять только до/в конец
     fx->prepare(sr_, bs_);
+    fx->setTempo(tempo_);
     chain_.insert(chain_.begin() + static_cast<std::ptrdiff_t>(index), std::move(fx));
     return true;
 }
@@ -76,6 +88,29 @@ bool Track::moveEffect(size_t from, size_t to)
     return true;
 }
 
+// ===== редактирование цепочки (RT) =====
+
+bool Track::insertPrepared(int index, IFx* fx, int sampleRate, int blockSize) noexcept
+{
+    if (!fx || chain_.size() >= chain_.capacity()) return false;
+    if (sampleRate != sr_ || blockSize != bs_) return false; // prepare здесь нельзя — аудиопоток
+    fx->setTempo(tempo_);
+
+    const size_t at = (index < 0 || static_cast<size_t>(index) > chain_.size())
+                      ? chain_.size() : static_cast<size_t>(index);
+    // unique_ptr из сырого указателя и сдвиг элементов — без аллокаций (capacity хватает)
+    chain_.insert(chain_.begin() + static_cast<std::ptrdiff_t>(at), std::unique_ptr<IFx>(fx));
+    return true;
+}
+
+IFx* Track::detachEffect(size_t index) noexcept
+{
+    if (index >= chain_.size()) return nullptr;
+    IFx* fx = chain_[index].release();
+    chain_.erase(chain_.begin() + static_cast<std::ptrdiff_t>(index));
+    return fx;
+}
+
 // ===== параметры FX (НЕ RT) =====
 
 bool Track::setFxParam(size_t fxIndex, std::string_view paramId, float value)
@@ -100,3 +135,12 @@ std::span<const FxParamDesc> Track::fxParams(size_t fxIndex) const
 
 size_t Track::chainSize() const { return chain_.size(); }
 int    Track::id()        const { return id_;           }
+
+int Track::latencySamples() const
+{
+    int sum = 0;
+    for (const auto& fx : chain_) {
+        if (fx) sum += fx->latencySamples();
+    }
+    return sum;
+}
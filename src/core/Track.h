@@ -32,6 +32,8 @@ struct TrackBus {
  */
 class Track {
 public:
+    static constexpr size_t kMaxChain = 16; ///< ёмкость цепочки (резерв под RT-вставку)
+
     explicit Track(int id);
 
     /**
@@ -69,6 +71,13 @@ public:
      */
     void processChain();
 
+    /**
+     * \brief RT: темп транспорта для всех FX цепочки (и для вставляемых позже).
+     *
+     * Передаётся эффектам только при изменении.
+     */
+    void setTempo(double bpm) noexcept;
+
     // ====== редактирование цепочки (НЕ RT) ======
 
     /// Добавить FX в конец цепочки. Вызовет fx->prepare(sr_, bs_).
@@ -83,6 +92,28 @@ public:
     /// Переместить FX внутри цепочки. Возвращает false если индексы невалидны.
     bool moveEffect(size_t from, size_t to);
 
+    // ====== редактирование цепочки (RT) ======
+
+    /**
+     * \brief RT: вставить уже подготовленный FX по индексу (-1/больше size = в конец).
+     *
+     * Ёмкость цепочки зарезервирована заранее (kMaxChain), поэтому вставка
+     * не аллоцирует. prepare() не зовётся — эффект готовят вне аудиопотока
+     * (FxLifecycle); подготовленный под другой SR/блок не вставляется.
+     *
+     * \return false, если цепочка полна, fx == nullptr или sampleRate/blockSize не совпадают
+     *         с треком; владение тогда остаётся у вызывающего.
+     */
+    bool insertPrepared(int index, IFx* fx, int sampleRate, int blockSize) noexcept;
+
+    /**
+     * \brief RT: снять FX с цепочки, не удаляя его.
+     *
+     * \return владеющий указатель (удалять вне аудиопотока, см. FxLifecycle::retire)
+     *         или nullptr при невалидном индексе.
+     */
+    IFx* detachEffect(size_t index) noexcept;
+
     // ====== параметры FX (НЕ RT) ======
 
     /// Установить параметр FX по индексу/идентификатору.
@@ -98,11 +129,14 @@ public:
 
     size_t chainSize() const;
     int    id()        const;
+    /// Суммарная латентность цепочки (IFx::latencySamples), сэмплы.
+    int    latencySamples() const;
 
 private:
     int id_ = -1;
     int sr_ = 48000;
     int bs_ = 64;
+    double tempo_ = 120.0;
 
     TrackBus bus_{};  // актуальные буферы на текущий блок (не владеем)
     std::vector<std::unique_ptr<IFx>> chain_;
@@ -21,9 +21,15 @@ struct CmdSetFxParam {
     int track; int index; std::string paramId; float value;
 };
 
+// Внутренняя: готовый эффект от FxLifecycle (создан и подготовлен вне аудиопотока).
+// Владение fx передаётся вместе с командой; sampleRate/blockSize — с чем сделан prepare.
+struct CmdInsertFx {
+    int track; int index; IFx* fx; int sampleRate; int blockSize;
+};
+
 // Можно расширять: CmdSetTrackGain/Pan, CmdBypassFx, CmdReplaceFx, ...
 
-using TrackCommand = std::variant<CmdAddFx, CmdRemoveFx, CmdMoveFx, CmdSetFxParam>;
+using TrackCommand = std::variant<CmdAddFx, CmdRemoveFx, CmdMoveFx, CmdSetFxParam, CmdInsertFx>;
 
 struct ITrackCommandQueue {
     virtual ~ITrackCommandQueue() = default;
@@ -2,6 +2,7 @@
 #include "core/TrackManager.h"
 #include "core/Track.h"
 #include "core/TrackCommands.h"
+#include "core/FxLifecycle.h"
 #include "devices/IFXFactory.h"
 #include <cassert>
 #include <utility>   // std::move
@@ -25,6 +26,7 @@ void TrackManager::prepare(int sampleRate, int blockSize)
     for (auto& t : tracks_) {
         t.prepare(sr_, bs_);
     }
+    master_.prepare(sr_, bs_);
 }
 
 void TrackManager::reset()
@@ -32,6 +34,7 @@ void TrackManager::reset()
     for (auto& t : tracks_) {
         t.reset();
     }
+    master_.reset();
 }
 
 void TrackManager::bindBuses(float** L, float** R, int frames)
@@ -57,45 +60,86 @@ void TrackManager::processAll()
     }
 }
 
+void TrackManager::setTempo(double bpm) noexcept
+{
+    for (auto& t : tracks_) {
+        t.setTempo(bpm);
+    }
+    master_.setTempo(bpm);
+}
+
+void TrackManager::processMaster(float* L, float* R, int frames)
+{
+    master_.bindBus(TrackBus{L, R, frames});
+    master_.processChain();
+}
+
+Track* TrackManager::find(int track)
+{
+    if (track == kMasterTrack) return &master_;
+    if (track < 0 || track >= numTracks()) return nullptr;
+    return &tracks_[static_cast<size_t>(track)];
+}
+
 bool TrackManager::apply(const TrackCommand& cmd)
 {
-    // ВНИМАНИЕ: НЕ RT. Вызывается между аудиоблоками.
+    // CmdAddFx — НЕ RT; остальное безопасно для аудиопотока (см. заголовок).
     if (std::holds_alternative<CmdAddFx>(cmd)) {
         const auto& c = std::get<CmdAddFx>(cmd);
-        if (c.track < 0 || c.track >= numTracks() || !registry_) return false;
+        Track* t = find(c.track);
+        if (!t || !registry_) return false;
 
         auto fx = registry_->create(c.type);
         if (!fx) return false;
 
         if (c.index < 0) {
-            return tracks_[static_cast<size_t>(c.track)]
-                    .addEffect(std::move(fx));
+            return t->addEffect(std::move(fx));
         } else {
-            return tracks_[static_cast<size_t>(c.track)]
-                    .insertEffect(static_cast<size_t>(c.index), std::move(fx));
+            return t->insertEffect(static_cast<size_t>(c.index), std::move(fx));
+        }
+    }
+
+    if (std::holds_alternative<CmdInsertFx>(cmd)) {
+        const auto& c = std::get<CmdInsertFx>(cmd);
+        Track* t = find(c.track);
+        if (t && lifecycle_ && (c.sampleRate != sr_ || c.blockSize != bs_)) {
+            lifecycle_->requeue(c); // SR/блок сменились, пока команда шла: переготовит builder
+            return false;
         }
+        const bool ok = t && t->insertPrepared(c.index, c.fx, c.sampleRate, c.blockSize);
+        if (!ok) retire(c.fx); // владение пришло с командой — не теряем эффект
+        return ok;
     }
 
     if (std::holds_alternative<CmdRemoveFx>(cmd)) {
         const auto& c = std::get<CmdRemoveFx>(cmd);
-        if (c.track < 0 || c.track >= numTracks()) return false;
-        return tracks_[static_cast<size_t>(c.track)]
-                .removeEffect(static_cast<size_t>(c.index));
+        Track* t = find(c.track);
+        if (!t || c.index < 0) return false;
+        IFx* fx = t->detachEffect(static_cast<size_t>(c.index));
+        if (!fx) return false;
+        retire(fx);
+        return true;
     }
 
     if (std::holds_alternative<CmdMoveFx>(cmd)) {
         const auto& c = std::get<CmdMoveFx>(cmd);
-        if (c.track < 0 || c.track >= numTracks()) return false;
-        return tracks_[static_cast<size_t>(c.track)]
-                .moveEffect(static_cast<size_t>(c.from), static_cast<size_t>(c.to));
+        Track* t = find(c.track);
+        if (!t) return false;
+        return t->moveEffect(static_cast<size_t>(c.from), static_cast<size_t>(c.to));
     }
 
     if (std::holds_alternative<CmdSetFxParam>(cmd)) {
         const auto& c = std::get<CmdSetFxParam>(cmd);
-        if (c.track < 0 || c.track >= numTracks()) return false;
-        return tracks_[static_cast<size_t>(c.track)]
-                .setFxParam(static_cast<size_t>(c.index), c.paramId, c.value);
+        Track* t = find(c.track);
+        if (!t) return false;
+        return t->setFxParam(static_cast<size_t>(c.index), c.paramId, c.value);
     }
 
     return false; // неизвестная команда
 }
+
+void TrackManager::retire(IFx* fx)
+{
+    if (lifecycle_) lifecycle_->retire(fx);
+    else            delete fx;
+}
@@ -4,6 +4,9 @@
 #include "Track.h"
 #include "devices/IFXFactory.h"
 #include "TrackCommands.h"
+#include "utils/TrackPath.h"
+
+class FxLifecycle;
 
 /**
  * \brief TrackManager — владелец массива треков и их жизненного цикла.
@@ -77,7 +80,7 @@ public:
      *
      * \param L      массив указателей на левый канал по каждому треку
      * \param R      массив указателей на правый канал по каждому треку
-     * \param frames количество сэмплов в текущем блоке (должно совпадать с blockSize)
+     * \param frames количество сэмплов в текущем блоке (не больше blockSize из prepare)
      *
      * \note Метод RT-безопасен (не аллоцирует/не блокирует). Предполагается,
      *       что сами буферы уже существуют и правильного размера.
@@ -94,38 +97,70 @@ public:
      */
     void processAll();
 
+    /**
+     * \brief RT: темп транспорта → всем трекам (Track::setTempo; эффектам — только при смене).
+     */
+    void setTempo(double bpm) noexcept;
+
+    /**
+     * \brief RT-метод: мастер-цепочка по уже сведённому стерео (in-place).
+     *
+     * Мастер — отдельный Track с id kMasterTrack; команды с track = kMasterTrack
+     * редактируют его цепочку так же, как у обычных треков.
+     */
+    void processMaster(float* L, float* R, int frames);
+
     // ===================== ДОСТУП =====================
 
     /// Доступ к треку по индексу (без проверок диапазона).
     Track&       track(int i)       { return tracks_[i]; }
     /// Константный доступ к треку по индексу (без проверок диапазона).
     const Track& track(int i) const { return tracks_[i]; }
-    /// Количество треков, управляемых менеджером.
+    /// Количество треков, управляемых менеджером (без мастера).
     int          numTracks() const  { return (int)tracks_.size(); }
+    /// Мастер-трек (kMasterTrack).
+    Track&       master()           { return master_; }
+    const Track& master() const     { return master_; }
 
-    // ===================== КОМАНДЫ (НЕ RT) =====================
+    // ===================== КОМАНДЫ =====================
+
+    /**
+     * \brief Куда отдавать снятые с цепочек эффекты (не владеем; может быть nullptr).
+     *
+     * С lifecycle удаление FX (CmdRemoveFx) уходит на reclaim-поток; без него —
+     * удаляем на месте (годится только вне аудиопотока).
+     */
+    void setLifecycle(FxLifecycle* lifecycle) { lifecycle_ = lifecycle; }
 
     /**
      * \brief Применяет команду редактирования треков/FX-цепочек.
      *
      * Поддерживаемые команды:
-     *   - CmdAddFx      { track, type, index }
-     *   - CmdRemoveFx   { track, index }
-     *   - CmdMoveFx     { track, from, to }
+     *   - CmdAddFx      { track, type, index }           — НЕ RT (create + prepare здесь же)
+     *   - CmdInsertFx   { track, index, fx, sr, bs }     — RT: готовый эффект от FxLifecycle;
+     *                                                       подготовленный под прежний SR/блок
+     *                                                       уходит обратно (FxLifecycle::requeue)
+     *   - CmdRemoveFx   { track, index }                 — RT при заданном lifecycle
+     *   - CmdMoveFx     { track, from, to }              — RT (перестановка в резерве)
      *   - CmdSetFxParam { track, index, paramId, value }
      *
+     * Аудиопоток получает команды уже через FxLifecycle::drainCommands — там CmdAddFx
+     * заменена на CmdInsertFx, так что аллокаций и prepare() в блоке нет.
+     *
      * \return true при успешном применении, false — при ошибке (невалидные
      *         индексы, неизвестный тип FX, отсутствует registry и т.п.)
-     *
-     * \warning НЕ RT. Вызывайте между аудиоблоками (например, из очереди,
-     *          слитой в начале блока).
      */
     bool apply(const TrackCommand& cmd);
 
 private:
+    void retire(IFx* fx); ///< удалить снятый FX (через lifecycle_, если задан)
+    Track* find(int track);  ///< трек по id (kMasterTrack → мастер), nullptr вне диапазона
+
     std::vector<Track> tracks_;   ///< собственно треки
+    Track master_{kMasterTrack};  ///< мастер-шина (после суммирования треков)
     int sr_ = 48000;              ///< текущий sample rate (для prepare FX)
     int bs_ = 64;                 ///< текущий block size (для prepare FX)
     IFxRegistry* registry_ = nullptr; ///< фабрика FX (не владеем; может быть nullptr)
+    FxLifecycle* lifecycle_ = nullptr; ///< утилизация снятых FX (не владеем; может быть nullptr)
 };
 
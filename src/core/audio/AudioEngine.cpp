@@ -2,74 +2,156 @@
 #include "core/audio/GraphSimple.h"
 #include "devices/SamplerNode.h"
 #include "utils/TrackPath.h"
+#include <algorithm>
 #include <iostream>
 
 void AudioEngine::prepare(const ProcessContext& ctx) {
     // 1) треки: реши количество (напр. банки*пэды сэмплера, либо из конфига проекта)
-    tracksCount_ = 16 * 4; // пример; вынеси в конфиг
+    tracksCount_ = 16 * 4 + 1; // 4 банка × 16 пэдов сэмплера + трек синта (SynthNode::kDefaultTrack); вынеси в конфиг
+    maxBlock_ = std::max(1, ctx.blockSize);
+    if (!fx) {
+        fx = std::make_shared<FxRegistry>();
+        registerBuiltinFx(*fx);
+    }
+    fx->prepare((int) ctx.sampleRate, maxBlock_); // прогрев пулов (размеры — из проекта)
     if (!trackMgr_) {
-        // передай реальный IFxRegistry*, когда будет готов (можешь хранить его в AudioEngine)
-        trackMgr_ = std::make_unique<TrackManager>(tracksCount_, ctx.blockSize, /*registry*/nullptr);
+        trackMgr_ = std::make_unique<TrackManager>(tracksCount_, maxBlock_, fx.get());
     }
-    trackMgr_->prepare((int) ctx.sampleRate, ctx.blockSize);
-
-    // 2) per-track буферы
-    ensureTrackBuffers(tracksCount_, ctx.blockSize);
+    trackMgr_->prepare((int) ctx.sampleRate, maxBlock_);
+    trackMgr_->setLifecycle(&fxLife_);
+    // треки и мастер готовятся только здесь, под maxBlock_: в process() look-ahead мастера не сбрасывается
+    if (trackMgr_->master().chainSize() == 0) { // мастер по умолчанию: шинный компрессор → true-peak лимитер
+        trackMgr_->master().addEffect(fx->create("compressor"));
+        trackMgr_->master().addEffect(fx->create("limiter"));
+    }
+    fxLife_.setRegistry(fx.get());
+    fxLife_.prepare((int) ctx.sampleRate, maxBlock_);
+    fxLife_.start();
+
+    // 2) per-track буферы + return-бас ревера
+    ensureTrackBuffers(tracksCount_, maxBlock_);
+    if (!reverb_) reverb_ = fx->create("reverb");
+    // ревер готовится только здесь: prepare() чистит линии (обрыв хвоста), process() — любой длины блок
+    if (reverb_) reverb_->prepare((int) ctx.sampleRate, maxBlock_);
+    // сатураторы — один раз здесь: скретч под блок prepare(), длинный блок process() режет сам
+    trackSat_.resize((size_t)tracksCount_);
+    for (auto& s : trackSat_) {
+        if (!s) s = std::make_unique<Saturator>();
+        s->prepare((int) ctx.sampleRate, maxBlock_);
+    }
+    satOn_.assign((size_t)tracksCount_, 0);
 
     // 3) граф + шина событий остаются как были
     graph->forEachNode([&](INode& n){ n.registerParams(*params); });
+    registerTrackParams();
     params->commitParams();
     graph->forEachNode([&](INode& n){ n.bindParams(*params); });
+    bindTrackParams();
+    sendSm_.prepare((int) ctx.sampleRate);
+    morph_.prepare(*params);
 
     if (graph) graph->prepare(ctx);
 
     if (bus) {
-        bus->subscribe([this](const Event& e){ this->handleEvent(e); });
+        bus->on<EvTransport>([this](const EvTransport& e){ this->handleEvent(Event{e}); });
     }
 }
 
 void AudioEngine::process(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx) {
-    // 0) применить команды для треков (между блоками)
+    if (maxBlock_ <= 0) return; // prepare() ещё не было
+    if (ctx.blockSize <= maxBlock_) { processBlock(io, midi, ctx); return; }
+
+    // хост прислал блок длиннее, чем в prepare(): переготовить FX в аудиопотоке нельзя (аллокации,
+    // сброс хвостов) — режем на куски по maxBlock_. MIDI — целиком первому куску: источники
+    // разбирают события на старте блока, без сэмпл-точности.
+    const int nch = std::min(io.numChannels, kMaxIoChannels);
+    ProcessContext part = ctx;
+    for (int off = 0; off < ctx.blockSize; off += maxBlock_) {
+        part.blockSize = std::min(maxBlock_, ctx.blockSize - off);
+        for (int ch = 0; ch < nch; ++ch) chunkCh_[(size_t)ch] = io.channels[ch] + off;
+        AlchemyAudioBuffer chunk{chunkCh_.data(), nch, part.blockSize};
+        noMidi_.clear();
+        processBlock(chunk, off == 0 ? midi : noMidi_, part);
+    }
+}
+
+void AudioEngine::processBlock(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx) {
+    // 0) применить команды для треков (между блоками; FX уже созданы и подготовлены вне RT)
     drainTrackCommands();
+    morph_.process(*params); // веса снимков сдвинулись — все параметры одним проходом
 
-    // 1) синхронизировать размеры на случай изменений
-    if ((int)trackBufL_.size() != tracksCount_ || (int)trackBufL_[0].size() != ctx.blockSize) {
-        ensureTrackBuffers(tracksCount_, ctx.blockSize);
-        trackMgr_->prepare((int) ctx.sampleRate, ctx.blockSize);
-    }
+    // 0.1) транспорт + автоматизация: значения полос в конце блока (сглаживатели дойдут ровно за блок)
+    if (const double loc = locate_.exchange(-1.0, std::memory_order_relaxed); loc >= 0.0) posBeats_ = loc;
+    const double blockBeats = ctx.playing && ctx.tempoBpm > 0.0 && ctx.sampleRate > 0.0
+            ? ctx.blockSize * ctx.tempoBpm / (60.0 * ctx.sampleRate) : 0.0;
+    automation_.process(*params, posBeats_ + blockBeats, ctx.playing);
 
-    // 2) подготовить указатели и dirty-флаги на блок
-    trackPtrsL_.resize(tracksCount_);
-    trackPtrsR_.resize(tracksCount_);
+    // 1) указатели и dirty-флаги на блок (буферы — под maxBlock_, из prepare)
+    const int n = ctx.blockSize;
     for (int t=0; t<tracksCount_; ++t) {
         trackPtrsL_[t] = trackBufL_[t].data();
         trackPtrsR_[t] = trackBufR_[t].data();
         trackDirty_[t] = 0;
     }
 
-    // 3) привязать буферы к TrackManager (они же будут обработаны in-place)
-    trackMgr_->bindBuses(trackPtrsL_.data(), trackPtrsR_.data(), ctx.blockSize);
+    // 2) привязать буферы к TrackManager (они же будут обработаны in-place)
+    trackMgr_->bindBuses(trackPtrsL_.data(), trackPtrsR_.data(), n);
 
-    // 4) прогнать граф источников, но с trackSink в контексте
+    // 3) прогнать граф источников, но с trackSink в контексте
     ProcessContext ctx2 = ctx;
     ctx2.tracks = &trackSink_;      // <-- вот куда Sampler/Synth будут писать DRY
+    ctx2.transportPosBeats = posBeats_;
 
     // очень важно: контекст всё ещё несёт params и bus (как и раньше)
     if (graph) graph->process(io, midi, ctx2);
 
-    // 5) пер-трековые вставки (processChain по каждому треку)
-    //trackMgr_->processAll();
+    // 4) пер-трековые вставки (processChain по каждому треку).
+    //    Трек с FX, в который сегодня никто не писал, всё равно обрабатываем с тишиной —
+    //    иначе оборвутся хвосты (ревер/дилей); молчащий фильтр при этом «спит».
+    for (int t=0; t<tracksCount_; ++t) {
+        if (trackDirty_[t] || trackMgr_->track(t).chainSize() == 0) continue;
+        std::fill(trackBufL_[t].begin(), trackBufL_[t].begin() + n, 0.f);
+        std::fill(trackBufR_[t].begin(), trackBufR_[t].begin() + n, 0.f);
+        trackDirty_[t] = 1;
+    }
+    trackMgr_->setTempo(ctx.tempoBpm); // темп-синк FX (дилей); 0 — темп не задан, остаётся прежний
+    trackMgr_->processAll();
+
+    // 4.1) сатурация треков (ADAA, векторная fast-math): только где ручка > 0
+    const ParamValues* vals = params->values();
+    for (int t=0; t<tracksCount_; ++t) {
+        const ParamHandle h = satAmount_[(size_t)t];
+        const float sat = vals && h ? vals->get(h) : 0.f;
+        Saturator& s = *trackSat_[(size_t)t];
+        if (sat <= 0.f) {
+            if (satOn_[(size_t)t]) { s.reset(); satOn_[(size_t)t] = 0; }
+            continue;
+        }
+        if (!trackDirty_[t]) {
+            // трек замолчал: хвост (задержка 2× фильтров + DC-блокер) доигрываем тишиной, пока не уснёт
+            if (!satOn_[(size_t)t] || s.asleep()) continue;
+            std::fill(trackBufL_[t].begin(), trackBufL_[t].begin() + n, 0.f);
+            std::fill(trackBufR_[t].begin(), trackBufR_[t].begin() + n, 0.f);
+            trackDirty_[t] = 1;
+        }
+        satOn_[(size_t)t] = 1;
+        s.setAmount(sat);
+        s.process(trackBufL_[t].data(), trackBufR_[t].data(), n);
+    }
 
-    // 6) (опц.) глобальные aux FX-ноды — если есть и работают как ноды графа, граф их уже прогонит
+    // 5) (опц.) глобальные aux FX-ноды — если есть и работают как ноды графа, граф их уже прогонит
     //    либо сделай отдельный проход здесь
 
-    // 7) суммирование обработанных треков в мастер (io)
+    // 6) суммирование обработанных треков в мастер (io)
     float* outL = io.channels[0];
     float* outR = io.channels[1];
-    const int n = ctx.blockSize;
     std::fill(outL, outL+n, 0.f);
     std::fill(outR, outR+n, 0.f);
 
+    std::fill(sendL_.begin(), sendL_.begin() + n, 0.f);
+    std::fill(sendR_.begin(), sendR_.begin() + n, 0.f);
+    sendSm_.process(n);
+
     for (int t=0; t<tracksCount_; ++t) {
         if (!trackDirty_[t]) {
             continue;
@@ -78,10 +160,30 @@ void AudioEngine::process(AlchemyAudioBuffer& io, MidiBuffer& midi, const Proces
         const float* srcL = trackBufL_[t].data();
         const float* srcR = trackBufR_[t].data();
         for (int i=0; i<n; ++i) { outL[i] += srcL[i]; outR[i] += srcR[i]; }
+
+        // post-fader сенд в ревер: только сложение в общий бас — цена не растёт с числом сендов;
+        // движущийся сенд — по рампе, стоящий — константой (0 — пропуск)
+        const ParamSmoother& send = sendSm_[t];
+        if (send.moving()) {
+            for (int i=0; i<n; ++i) { const float s = send.at(i); sendL_[i] += srcL[i] * s; sendR_[i] += srcR[i] * s; }
+        } else if (const float s = send.end(); s > 0.f) {
+            for (int i=0; i<n; ++i) { sendL_[i] += srcL[i] * s; sendR_[i] += srcR[i] * s; }
+        }
     }
 
+    // 6.1) return-бас: один ревер на все треки (спит, пока сенды молчат и хвост погас)
+    if (reverb_) {
+        reverb_->process(sendL_.data(), sendR_.data(), n);
+        for (int i=0; i<n; ++i) { outL[i] += sendL_[i]; outR[i] += sendR_[i]; }
+    }
+
+    // 7) мастер-цепочка (kMasterTrack): по сведённому стерео in-place
+    trackMgr_->processMaster(outL, outR, n);
 
-    // 8) (опц.) мастер-цепочка здесь же или как отдельная нода в graph
+    // 8) изменения параметров за блок → журнал для UI (слушатели — на UI-потоке, dispatchChanges)
+    params->flushChanges();
+    posBeats_ += blockBeats;
+    automation_.setPosition(posBeats_);
 }
 
 void AudioEngine::handleEvent(const Event& e) {
@@ -97,11 +199,35 @@ void AudioEngine::ensureTrackBuffers(int numTracks, int blockSize) {
         trackBufL_[t].resize((size_t)blockSize);
         trackBufR_[t].resize((size_t)blockSize);
     }
+    sendL_.resize((size_t)blockSize);
+    sendR_.resize((size_t)blockSize);
+    trackPtrsL_.resize((size_t)numTracks);
+    trackPtrsR_.resize((size_t)numTracks);
+}
+
+void AudioEngine::registerTrackParams() {
+    for (int t=0; t<tracksCount_; ++t) {
+        params->add(std::make_unique<ParamFloat>(
+                ParamMeta{TrackPath::trackParam(t, "fx.reverb.send"), "", ParamType::kFloat, 0.f, 1.f, 0.f, 0.f}));
+        params->add(std::make_unique<ParamFloat>(
+                ParamMeta{TrackPath::trackParam(t, "fx.saturation"), "", ParamType::kFloat, 0.f, 1.f, 0.f, 0.f}));
+    }
+}
+
+void AudioEngine::bindTrackParams() {
+    revSend_.assign((size_t)tracksCount_, nullptr);
+    satAmount_.assign((size_t)tracksCount_, ParamHandle{});
+    sendSm_.clear();
+    for (int t=0; t<tracksCount_; ++t) {
+        revSend_[(size_t)t] = params->find(TrackPath::trackParam(t, "fx.reverb.send"));
+        satAmount_[(size_t)t] = params->handle(TrackPath::trackParam(t, "fx.saturation"));
+        sendSm_.add(revSend_[(size_t)t], params->handle(TrackPath::trackParam(t, "fx.reverb.send")));
+    }
+    sendSm_.bind(params->values());
 }
 
 void AudioEngine::drainTrackCommands() {
-    TrackCommand cmd;
-    while (trackCmdQ_.pop(cmd)) {
+    fxLife_.drainCommands([this](const TrackCommand& cmd) {
         if (trackMgr_) (void)trackMgr_->apply(cmd);
-    }
+    });
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <memory>
 #include "IGraph.h"
 #include "AudioDefs.h"
 #include "bus/EventBus.h"
 #include "params/Param.h"
+#include "params/Smoothing.h"
+#include "params/Morph.h"
+#include "params/Automation.h"
 #include "core/TrackManager.h"
+#include "core/FxLifecycle.h"
+#include "fx/FxRegistry.h"
+#include "fx/Saturator.h"
 #include "core/TrackSinkImpl.h"
 #include "utils/SpscRing.h"
 
@@ -12,17 +20,41 @@ struct AudioEngine {
     std::unique_ptr<IGraph>          graph;
     std::shared_ptr<IParameterStore> params;
     std::shared_ptr<IEventBus>       bus;
+    std::shared_ptr<FxRegistry>      fx;      // реестр FX с пулами; не задан — prepare создаст со встроенными
 
+    // НЕ RT. ctx.blockSize — максимальный блок (JUCE: samplesPerBlockExpected): под него готовятся
+    // все FX и буферы, в аудиопотоке prepare() больше не зовётся
     void prepare(const ProcessContext& ctx);
-    void process(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx); // JUCE audio callback
-    void handleEvent(const Event& e); // subscribed via bus->subscribe
+    // JUCE audio callback; блок длиннее подготовленного режется на куски (MIDI — первому куску)
+    void process(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx);
+    void handleEvent(const Event& e); // подписан через bus->on<EvTransport>
 
     // --- новое: трековый слой ---
-    void pushTrackCommand(const TrackCommand& cmd) { (void)trackCmdQ_.push(cmd); }
+    // НЕ RT, любой поток (без локов): команда идёт через builder-поток FxLifecycle (FX создаются там);
+    // false — очередь команд полна
+    bool pushTrackCommand(const TrackCommand& cmd) { return fxLife_.submit(cmd); }
+
+    // латентность выхода (look-ahead мастер-цепочки) — для компенсации у хоста/драйвера
+    int latencySamples() const { return trackMgr_ ? trackMgr_->master().latencySamples() : 0; }
+
+    // морф снимков микса: load() — НЕ RT, setMorph/setWeights — любой поток; применяется в начале блока
+    MorphEngine& morph() { return morph_; }
+
+    // автоматизация параметров по транспорту; позиция транспорта — своя у движка (ctx.transportPosBeats
+    // на входе не используется, нодам уходит позиция движка); locate() — перемотка, любой поток
+    AutomationEngine& automation() { return automation_; }
+    void locate(double beats) { locate_.store(std::max(0.0, beats), std::memory_order_relaxed); }
 
 private:
+    FxLifecycle                   fxLife_;           // создание/удаление FX вне аудиопотока (живёт дольше trackMgr_)
     std::unique_ptr<TrackManager> trackMgr_;         // владелец треков/FX цепей
     int tracksCount_ = 0;
+    int maxBlock_ = 0;                                 // блок из prepare(): под него готовы FX и буферы
+
+    // нарезка длинного блока хоста: смещённые каналы io и пустой MIDI для кусков после первого
+    static constexpr int kMaxIoChannels = 8;
+    std::array<float*, kMaxIoChannels> chunkCh_{};
+    MidiBuffer                      noMidi_;
 
     // per-track рабочие буферы (dry → после processChain остаются там же)
     std::vector<std::vector<float>> trackBufL_;
@@ -31,11 +63,26 @@ private:
     std::vector<float*>             trackPtrsR_;
     std::vector<uint8_t>            trackDirty_;     // ленивое нуление на первый вклад
 
-    SpscRing<TrackCommand, 1024>          trackCmdQ_; // команды от UI → трековый слой
+    // общий return-бас ревера: сенды всех треков суммируются сюда, ревер — один на движок
+    std::unique_ptr<IFx>            reverb_;
+    std::vector<IParam*>            revSend_;        // [track] → "track.N.fx.reverb.send"
+    SmootherBank                    sendSm_;         // [track] сглаженные сенды (рампа по блоку)
+    std::vector<float>              sendL_, sendR_;  // [maxBlock_]
 
+    // пер-трековая сатурация (ручка "track.N.fx.saturation"): после цепочки трека, 0 — не считается
+    std::vector<std::unique_ptr<Saturator>> trackSat_;
+    std::vector<ParamHandle>        satAmount_;      // [track]
+    std::vector<uint8_t>            satOn_;          // [track] считалась в прошлом блоке
 
     TrackSinkImpl                   trackSink_{trackBufL_, trackBufR_, trackDirty_};
+    MorphEngine                     morph_;
+    AutomationEngine                automation_;
+    double                          posBeats_ = 0.0;   // транспорт, аудио-поток
+    std::atomic<double>             locate_{-1.0};
 
+    void processBlock(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx); // ctx.blockSize <= maxBlock_
     void ensureTrackBuffers(int numTracks, int blockSize);
+    void registerTrackParams();   // пер-трековые параметры движка (сенды, сатурация)
+    void bindTrackParams();
     void drainTrackCommands();
 };
@@ -0,0 +1,115 @@
+#include "devices/Envelope.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+constexpr float kAttackTarget = 1.2f;  // перелёт цели атаки (форма кривой)
+constexpr float kSegEps       = 1e-3f; // −60 дБ: «сегмент пройден» для decay/release
+constexpr float kFloor        = 1e-4f; // −80 дБ: голос погас
+
+// Коэффициент one-pole, за n кадров сокращающий расстояние до цели в ratio раз
+float coef(float ms, float sr, float ratio) {
+    const double n = (double)ms * 0.001 * (double)sr;
+    if (n < 1.0) return 0.f;
+    return (float)std::pow((double)ratio, 1.0 / n);
+}
+
+// Сколько сэмплов от y0 до границы B при движении к цели T (последний сэмпл — уже на/за B)
+int segLen(float y0, float T, float B, float c) {
+    const double r = (double)(B - T) / (double)(y0 - T);
+    if (r >= 1.0) return 0;
+    if (r <= 0.0 || c <= 0.f) return 1;
+    const double k = std::ceil(std::log(r) / std::log((double)c));
+    return k >= (double)INT_MAX ? INT_MAX : std::max(1, (int)k);
+}
+
+// out[k] = T + (y - T)·c^(k+1), k ∈ [0, n); y ← последний выданный
+void fillExp(float* out, int n, float& y, float T, float c) noexcept {
+    const float d  = y - T;
+    const float c2 = c * c, c4 = c2 * c2;
+    int i = 0;
+    if (n >= 4) {
+        const simd::f32x4 tv = simd::splat4(T);
+        const simd::f32x4 c4v = simd::splat4(c4);
+        simd::f32x4 dv = simd::splat4(d) * simd::f32x4{c, c2, c2 * c, c4};
+        for (; i + 4 <= n; i += 4) {
+            simd::store4(out + i, tv + dv);
+            dv *= c4v;
+        }
+    }
+    float dd = i > 0 ? out[i - 1] - T : d;
+    for (; i < n; ++i) { dd *= c; out[i] = T + dd; }
+    if (n > 0) y = out[n - 1];
+}
+
+} // namespace
+
+void Adsr::setSampleRate(float sr) noexcept {
+    sr_ = sr > 0.f ? sr : 48000.f;
+    setParams(p_);
+}
+
+void Adsr::setParams(const AdsrParams& p) noexcept {
+    p_ = p;
+    p_.sustain = std::clamp(p.sustain, 0.f, 1.f);
+    cA_ = coef(p.attackMs,  sr_, (kAttackTarget - 1.f) / kAttackTarget);
+    cD_ = coef(p.decayMs,   sr_, kSegEps);
+    cR_ = coef(p.releaseMs, sr_, kSegEps);
+}
+
+int Adsr::render(float* out, int n) noexcept {
+    int i = 0;
+    while (i < n) {
+        const int left = n - i;
+        switch (stage_) {
+            case Stage::Idle:
+                std::fill(out + i, out + n, 0.f);
+                return i;
+
+            case Stage::Sustain:
+                y_ = p_.sustain; // live: sustain можно крутить во время ноты
+                std::fill(out + i, out + n, y_);
+                return n;
+
+            case Stage::Attack: {
+                const int len = cA_ > 0.f ? segLen(y_, kAttackTarget, 1.f, cA_) : 0;
+                const int m = std::min(len, left);
+                fillExp(out + i, m, y_, kAttackTarget, cA_);
+                i += m;
+                if (m == len) {
+                    if (m > 0) out[i - 1] = 1.f;
+                    y_ = 1.f;
+                    stage_ = Stage::Decay;
+                }
+                break;
+            }
+
+            case Stage::Decay: {
+                const float S   = p_.sustain;
+                const float thr = kSegEps * (1.f - S);
+                if (cD_ <= 0.f || std::fabs(y_ - S) <= thr) { stage_ = Stage::Sustain; break; }
+                const float B   = y_ > S ? S + thr : S - thr;
+                const int   len = segLen(y_, S, B, cD_);
+                const int   m   = std::min(len, left);
+                fillExp(out + i, m, y_, S, cD_);
+                i += m;
+                if (m == len) stage_ = Stage::Sustain; // остаток пути (≤ −60 дБ) — ступенькой
+                break;
+            }
+
+            case Stage::Release: {
+                if (cR_ <= 0.f || y_ <= kFloor) { y_ = 0.f; stage_ = Stage::Idle; break; }
+                const int len = segLen(y_, 0.f, kFloor, cR_);
+                const int m   = std::min(len, left);
+                fillExp(out + i, m, y_, 0.f, cR_);
+                i += m;
+                if (m == len) { y_ = 0.f; stage_ = Stage::Idle; }
+                break;
+            }
+        }
+    }
+    return n;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+// Параметры ADSR (времена в мс, sustain 0..1)
+struct AdsrParams {
+    float attackMs  = 5.f;
+    float decayMs   = 100.f;
+    float sustain   = 1.f;
+    float releaseMs = 50.f;
+};
+
+// Блочная ADSR с экспоненциальными сегментами (one-pole к цели).
+//  - Внутри сегмента значение считается в замкнутой форме y[k] = T + (y0 - T)·c^k
+//    (вектором по 4 сэмпла), длина сегмента — тоже аналитически (log), так что блок
+//    режется только на границах стадий, без switch на каждый сэмпл.
+//  - Attack целится в 1.2 и обрезается на 1.0 (выпуклая «аналоговая» атака ровно за attackMs).
+//  - Decay/Release: за decayMs/releaseMs проходят 60 дБ пути; голос гаснет на −80 дБ.
+//  - noteOn()/noteOff() стартуют от текущего уровня — ретриггер и ранний релиз без щелчков.
+// Всё RT: без аллокаций; setParams() — три pow, можно звать хоть каждый блок.
+class Adsr {
+public:
+    enum class Stage : uint8_t { Idle, Attack, Decay, Sustain, Release };
+
+    void setSampleRate(float sr) noexcept;
+    void setParams(const AdsrParams& p) noexcept;
+
+    void noteOn()  noexcept { stage_ = Stage::Attack; }
+    void noteOff() noexcept { if (stage_ != Stage::Idle) stage_ = Stage::Release; }
+    void kill()    noexcept { stage_ = Stage::Idle; y_ = 0.f; }
+
+    // Записать n значений огибающей в out. Вернёт число «живых» кадров:
+    // < n — огибающая догасла внутри блока (хвост out занулён).
+    int render(float* out, int n) noexcept;
+
+    Stage stage()    const noexcept { return stage_; }
+    float value()    const noexcept { return y_; }
+    bool  active()   const noexcept { return stage_ != Stage::Idle; }
+    bool  released() const noexcept { return stage_ == Stage::Release || stage_ == Stage::Idle; }
+
+private:
+    float sr_ = 48000.f;
+    AdsrParams p_{};
+    float cA_ = 0.f, cD_ = 0.f, cR_ = 0.f; // коэффициенты за сэмпл; 0 — мгновенный сегмент
+    float y_ = 0.f;
+    Stage stage_ = Stage::Idle;
+};
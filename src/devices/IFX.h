@@ -34,4 +34,7 @@ public:
     virtual void setBypass(bool on) = 0;
     virtual bool bypass() const = 0;
     virtual int  latencySamples() const { return 0; }
+
+    // RT: темп транспорта (BPM) для синхронизируемых эффектов; зовётся между блоками при смене
+    virtual void setTempo(double /*bpm*/) {}
 };
@@ -13,4 +13,15 @@ struct IFxRegistry {
     virtual bool   isRegistered(std::string_view type) const = 0;
     virtual std::unique_ptr<IFx> create(std::string_view type) const = 0;
     virtual std::vector<std::string> listTypes() const = 0;
+    // Экземпляр, уже подготовленный под sampleRate/blockSize. НЕ RT.
+    // Реализация с пулами отдаёт готовый экземпляр без повторного prepare().
+    virtual std::unique_ptr<IFx> createPrepared(std::string_view type, int sampleRate, int blockSize) const {
+        auto fx = create(type);
+        if (fx) fx->prepare(sampleRate, blockSize);
+        return fx;
+    }
+    // Фоновое обслуживание (доливка пулов и т.п.). НЕ RT; зовёт builder-поток FxLifecycle в простое.
+    virtual void maintain() {}
+    // SR/блок, под которые держать готовые экземпляры. НЕ RT; builder-поток FxLifecycle зовёт при смене.
+    virtual void prepare(int /*sampleRate*/, int /*blockSize*/) {}
 };
@@ -1,6 +1,6 @@
 #pragma once
 #include "core/audio/INode.h"
-enum class Wave { Saw, Square, Noise };
+enum class Wave { Saw, Square, Noise, Table }; // Table — волновая таблица (SynthNode::setWavetable)
 struct ISynth : INode {
     virtual void noteOn(int note, float vel) = 0;
     virtual void noteOff(int note) = 0;
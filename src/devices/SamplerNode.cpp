@@ -5,6 +5,11 @@
 #include <cmath>
 #include <algorithm>
 #include "utils/TrackPath.h"
+#include "utils/SampleCache.h"
+#include "devices/ZoneMap.h"
+#include "devices/TimeStretch.h"
+#include "utils/SampleCompact.h"
+#include "utils/Simd.h"
 #include "core/audio/INode.h"
 
 PolyAllocator::PolyAllocator(int maxVoices)
@@ -12,36 +17,30 @@ PolyAllocator::PolyAllocator(int maxVoices)
 
 Voice* PolyAllocator::allocSteal() {
     for (auto& v : voices_) {
-        if (!v.active || v.envPhase == Voice::EnvPhase::Off) {
-            v = Voice{}; // сброс
+        if (!v.active || !v.env.active()) {
+            v = Voice{}; // сброс; огибающую запускает вызывающий (после setParams)
             v.active = true;
-            v.envPhase = Voice::EnvPhase::Attack;
             return &v;
         }
     }
     auto it = std::min_element(voices_.begin(), voices_.end(),
-                               [](const Voice& a, const Voice& b){ return a.env < b.env; });
+                               [](const Voice& a, const Voice& b){ return a.env.value() < b.env.value(); });
     *it = Voice{};
     it->active = true;
-    it->envPhase = Voice::EnvPhase::Attack;
     return &(*it);
 }
 
 // Отпускаем все голоса, рожденные этим padId
 void PolyAllocator::noteOffPad(int padId) {
     for (auto& v : voices_) {
-        if (v.active && v.padId == padId && v.envPhase != Voice::EnvPhase::Release) {
-            v.envPhase = Voice::EnvPhase::Release;
-        }
+        if (v.active && v.padId == padId) v.env.noteOff();
     }
 }
 
 // Отпускаем все голоса, рожденные этим MIDI-нотом
 void PolyAllocator::noteOffChromatic(int midiNote) {
     for (auto& v : voices_) {
-        if (v.active && v.midiNote == midiNote && v.envPhase != Voice::EnvPhase::Release) {
-            v.envPhase = Voice::EnvPhase::Release;
-        }
+        if (v.active && v.midiNote == midiNote) v.env.noteOff();
     }
 }
 
@@ -67,6 +66,8 @@ void SamplerNode::registerParams(IParameterStore& ps) {
             addFloat(ps, TrackPath::trackParam(tr, "gain"), 0.f, 2.f, 1.f);
             addFloat(ps, TrackPath::trackParam(tr, "pan"),  -1.f, 1.f, 0.f);
             addFloat(ps, TrackPath::trackParam(tr, "env.attackMs"), 0.f, 2000.f, 5.f, 0.1f);
+            addFloat(ps, TrackPath::trackParam(tr, "env.decayMs"),  0.f, 5000.f, 200.f, 0.1f);
+            addFloat(ps, TrackPath::trackParam(tr, "env.sustain"),  0.f, 1.f, 1.f);   // 1 — как прежняя A/R
             addFloat(ps, TrackPath::trackParam(tr, "env.releaseMs"),0.f, 5000.f, 50.f, 0.1f);
             addFloat(ps, TrackPath::trackParam(tr, "mode.half"), 0.f, 1.f, 0.f, 1.f);
             addFloat(ps, TrackPath::trackParam(tr, "mode.reverse"), 0.f, 1.f, 0.f, 1.f);
@@ -77,6 +78,11 @@ void SamplerNode::registerParams(IParameterStore& ps) {
             addFloat(ps, TrackPath::trackParam(tr, "region.loopStart"), 0.f, 1e9f, 0.f, 1.f);
             addFloat(ps, TrackPath::trackParam(tr, "region.loopEnd"),   0.f, 1e9f, 0.f, 1.f);
             addFloat(ps, TrackPath::trackParam(tr, "region.loopMode"),  0.f, 2.f, 0.f, 1.f); // enum: 0/1/2
+            // DRAG: time-stretch (0 = Granular/WSOLA, 1 = Vocoder)
+            addFloat(ps, TrackPath::trackParam(tr, "stretch.mode"),  0.f, 1.f, 0.f, 1.f);
+            addFloat(ps, TrackPath::trackParam(tr, "stretch.ratio"), 0.25f, 32.f, 10.f);      // во сколько раз медленнее
+            addFloat(ps, TrackPath::trackParam(tr, "stretch.beats"), 0.f, 64.f, 0.f, 0.25f);  // 0 — выкл, иначе tempo-sync
+            addFloat(ps, TrackPath::trackParam(tr, "stretch.pitch"), -24.f, 24.f, 0.f, 0.01f); // полутоны
         }
     }
 }
@@ -96,6 +102,8 @@ void SamplerNode::bindParams(IParameterStore& ps) {
             const int tr = trackOf(b,p);
             const std::string base = "track."+std::to_string(tr)+".";
             ATK(b,p) = ps.find(TrackPath::trackParam(tr, "env.attackMs"));
+            DEC(b,p) = ps.find(TrackPath::trackParam(tr, "env.decayMs"));
+            SUS(b,p) = ps.find(TrackPath::trackParam(tr, "env.sustain"));
             REL(b,p) = ps.find(TrackPath::trackParam(tr, "env.releaseMs"));
             GAIN(b,p) = ps.find(TrackPath::trackParam(tr, "gain"));
             PAN(b,p) = ps.find(TrackPath::trackParam(tr, "pan"));
@@ -107,10 +115,36 @@ void SamplerNode::bindParams(IParameterStore& ps) {
             RLSTART(b,p) = ps.find(TrackPath::trackParam(tr, "region.loopStart"));
             RLEND(b,p) = ps.find(TrackPath::trackParam(tr, "region.loopEnd"));
             RMODE(b,p) = ps.find(TrackPath::trackParam(tr, "region.loopMode"));
+            STMODE(b,p)  = ps.find(TrackPath::trackParam(tr, "stretch.mode"));
+            STRATIO(b,p) = ps.find(TrackPath::trackParam(tr, "stretch.ratio"));
+            STBEATS(b,p) = ps.find(TrackPath::trackParam(tr, "stretch.beats"));
+            STPITCH(b,p) = ps.find(TrackPath::trackParam(tr, "stretch.pitch"));
+            const int i = refs_.idx(b,p);
+            refs_.hStart[i]  = ps.handle(TrackPath::trackParam(tr, "region.start"));
+            refs_.hEnd[i]    = ps.handle(TrackPath::trackParam(tr, "region.end"));
+            refs_.hLStart[i] = ps.handle(TrackPath::trackParam(tr, "region.loopStart"));
+            refs_.hLEnd[i]   = ps.handle(TrackPath::trackParam(tr, "region.loopEnd"));
+            refs_.hMode[i]   = ps.handle(TrackPath::trackParam(tr, "region.loopMode"));
         }
     }
+    vals_ = ps.values();
+    padGain_.bind(vals_);
+    padPan_.bind(vals_);
+    uint32_t bankParams = 0;
+    for (int b=0; b<cfg_.banks && vals_; ++b)
+        bankParams = std::max(bankParams, vals_->tracksRange(trackOf(b,0), pads).count);
+    bankSnap_.reserve(bankParams);
     std::cout << "[bindParams] ATK(0,0)=" << (void*)ATK(0,0) << "\n";
 
+    padGain_.clear();
+    padPan_.clear();
+    for (int b=0; b<cfg_.banks; ++b) {
+        for (int p=0; p<pads; ++p) {
+            padGain_.add(GAIN(b,p), ps.handle(TrackPath::trackParam(trackOf(b,p), "gain")));
+            padPan_.add(PAN(b,p), ps.handle(TrackPath::trackParam(trackOf(b,p), "pan")));
+        }
+    }
+
 }
 
 SampleRegion SamplerNode::buildRegionFromParams(const PadDesc& pad, int b, int p) noexcept
@@ -119,11 +153,12 @@ SampleRegion SamplerNode::buildRegionFromParams(const PadDesc& pad, int b, int p
     const int total = (pad.sample ? pad.sample->frames : 0);
     if (total <= 1) return r;
 
-    int start    = (int) RSTART(b, p)->getFloat();
-    int end      = (int) REND(b, p)->getFloat();
-    int loopSt   = (int) RLSTART(b, p)->getFloat();
-    int loopEn   = (int) RLEND(b, p)->getFloat();
-    int modeI    = (int) std::lround(RMODE(b,p)->getFloat());
+    const int i  = refs_.idx(b, p);
+    int start    = (int) snapValue(refs_.hStart[i],  RSTART(b, p));
+    int end      = (int) snapValue(refs_.hEnd[i],    REND(b, p));
+    int loopSt   = (int) snapValue(refs_.hLStart[i], RLSTART(b, p));
+    int loopEn   = (int) snapValue(refs_.hLEnd[i],   RLEND(b, p));
+    int modeI    = (int) std::lround(snapValue(refs_.hMode[i], RMODE(b,p)));
 
     // упорядочим и почистим
     if (end <= start) end = std::clamp(start+1, 1, total);
@@ -140,15 +175,87 @@ SampleRegion SamplerNode::buildRegionFromParams(const PadDesc& pad, int b, int p
 }
 
 SamplerNode::SamplerNode(const char* id)
-: pads_(4, std::vector<PadDesc>(kPadsPerBank)), voices_(64) {
+: cache_(std::make_shared<SampleCache>()), pads_(4, std::vector<PadDesc>(kPadsPerBank)), voices_(64),
+  windows_(64), stretch_(kMaxStretchVoices) {
     id_ = id;
 }
 
+SamplerNode::~SamplerNode() { waitZoneLoads(); } // задачи loadZonesAsync держат this
+
+Voice* SamplerNode::allocVoice() noexcept {
+    Voice* v = voices_.allocSteal();
+    // окно ключуется адресом буфера: у нового голоса оно от прошлого владельца слота —
+    // тот же адрес может оказаться уже другим (освобождённым и заново выделенным) буфером
+    windows_[(size_t)(v - voices_.all().data())].src = nullptr;
+    return v;
+}
+
+void SamplerNode::setStorageFormat(SampleFormat fmt) { cfg_.storage = fmt; }
+
+void SamplerNode::setSampleCache(std::shared_ptr<SampleCache> cache) {
+    if (cache) cache_ = std::move(cache);
+}
+
+// Регион в кадрах буфера длиной fromFrames → в кадрах буфера длиной toFrames (тот же семпл в другой
+// частоте), затем страховка корректности границ
+static void conformRegion(SampleRegion& r, int fromFrames, int toFrames) {
+    if (fromFrames > 0 && toFrames > 0 && fromFrames != toFrames) {
+        const double k = (double)toFrames / (double)fromFrames;
+        auto scale = [k](int f){ return (int)std::lround((double)f * k); };
+        r.start     = scale(r.start);
+        r.end       = scale(r.end);
+        r.loopStart = scale(r.loopStart);
+        r.loopEnd   = scale(r.loopEnd);
+    }
+    r.start     = std::max(0, r.start);
+    r.end       = std::max(r.start+1, r.end);
+    r.loopStart = std::clamp(r.loopStart, r.start, r.end-1);
+    r.loopEnd   = std::clamp(r.loopEnd,   r.loopStart+1, r.end);
+}
+
 void SamplerNode::prepare(const ProcessContext &ctx) {
     const int n = ctx.blockSize;
     scratchL_.clear(); scratchR_.clear();
     scratchL_.resize(n, 0.f);
     scratchR_.resize(n, 0.f);
+    envBuf_.assign(n, 0.f);
+    stL_.assign(n, 0.f);
+    stR_.assign(n, 0.f);
+
+    // Смена частоты движка → переконвертировать все пэды из оригиналов (НЕ RT, до старта аудио)
+    const int sr = ctx.sampleRate > 0 ? (int)std::lround(ctx.sampleRate) : cfg_.sr;
+    waitZoneLoads(); // загрузка, начатая под прежнюю частоту, публикуется до пересборки ниже
+    if (sr != cfg_.sr) {
+        cfg_.sr = sr;
+        for (int b = 0; b < (int)pads_.size(); ++b) {
+            for (int p = 0; p < (int)pads_[b].size(); ++p) {
+                auto& pad = pads_[b][p];
+                // мультисэмпл — пересобрать из исходных зон (если таблица строилась с конверсией)
+                if (const ZoneMapPtr zm = atomicLoadZones(pad); zm && zm->targetSr() > 0)
+                    setPadZones(b, p, ZoneMap::build(zm->sources(), cache_.get(), cfg_.sr, zm->format()));
+
+                if (!pad.source) continue;
+                auto conv = cache_->convert(pad.source, cfg_.sr, cfg_.storage);
+                if (!conv) continue;
+                // регион — в кадрах прежнего буфера пэда: в новую частоту вместе с семплом;
+                // ручки региона тоже в кадрах — голос берёт слайс из них
+                const SampleBufferPtr old = atomicLoadSample(pad);
+                const int from = old ? old->frames : pad.source->frames;
+                conformRegion(pad.region, from, conv->frames);
+                if (from > 0 && refs_.idx(b, p) < (int)refs_.rStart.size()) {
+                    const double k = (double)conv->frames / (double)from;
+                    for (IParam* prm : {RSTART(b, p), REND(b, p), RLSTART(b, p), RLEND(b, p)})
+                        if (prm) prm->setFloat((float)std::lround((double)prm->getFloat() * k));
+                }
+                atomicStoreSample(pad, conv);
+            }
+        }
+    }
+
+    for (auto& st : stretch_) st.prepare();
+    stretchOwner_.fill(nullptr);
+    padGain_.prepare(cfg_.sr);
+    padPan_.prepare(cfg_.sr);
 }
 
 void SamplerNode::release() {}
@@ -162,16 +269,74 @@ int SamplerNode::currentBank() const { return currentBank_.load(std::memory_orde
 void SamplerNode::loadSample(int bankId, int padId, const SampleBufferPtr& buf, const SampleRegion& rgn) {
     if (!inRangeBankPad(bankId, padId)) return;
     auto& pad = pads_[bankId][padId];
-    atomicStoreSample(pad, buf);
+
+    // Конверсия в частоту/формат движка — здесь, а не в голосе: play-путь всегда 1:1.
+    // В компактном режиме и оригинал держим в Int16, иначе экономии RAM не будет.
+    SampleBufferPtr source = buf;
+    if (buf && cfg_.storage == SampleFormat::Int16) source = CompactSampleBuffer(buf);
+    SampleBufferPtr play = source;
+    if (source && (source->sr != cfg_.sr || source->format != cfg_.storage)) {
+        play = cache_->convert(source, cfg_.sr, cfg_.storage);
+        if (!play) return;
+    }
+
+    pad.source = source;
+    atomicStoreSample(pad, play);
     std::cout << "SAMPLE LOADED";
     pad.region = rgn; // region — обычная копия; менять его из UI лучше тоже через «двухфазный» путь
-    // Небольшая страховка корректности
-    pad.region.start = std::max(0, pad.region.start);
-    pad.region.end   = std::max(pad.region.start+1, pad.region.end);
-    pad.region.loopStart = std::clamp(pad.region.loopStart, pad.region.start, pad.region.end-1);
-    pad.region.loopEnd   = std::clamp(pad.region.loopEnd,   pad.region.loopStart+1, pad.region.end);
+
+    // Регион задан в кадрах оригинала → пересчитать в кадры сконвертированного буфера
+    conformRegion(pad.region, buf ? buf->frames : 0, play ? play->frames : 0);
+}
+
+
+void SamplerNode::setPadZones(int bankId, int padId, ZoneMapPtr zones) {
+    if (!inRangeBankPad(bankId, padId)) return;
+    ZoneMapPtr old = std::atomic_exchange_explicit(&pads_[bankId][padId].zones, std::move(zones),
+                                                   std::memory_order_acq_rel);
+    std::lock_guard<std::mutex> lk(zonesMx_);
+    // пэд на таблицы больше не ссылается: кого держим только мы — аудио уже не возьмёт, освобождаем
+    std::erase_if(zonesRetired_, [](const ZoneMapPtr& z) { return z.use_count() == 1; });
+    if (old) zonesRetired_.push_back(std::move(old));
 }
 
+void SamplerNode::waitZoneLoads() {
+    std::unique_lock<std::mutex> lk(zonesMx_);
+    zonesCv_.wait(lk, [this] { return zoneLoads_ == 0; });
+}
+
+std::future<bool> SamplerNode::loadZonesAsync(int bankId, int padId, std::vector<SampleZone> zones) {
+    {
+        std::lock_guard<std::mutex> lk(zonesMx_);
+        ++zoneLoads_;
+    }
+    // sr/формат фиксируем сейчас: таблица строится под текущую конфигурацию движка
+    // (prepare со сменой частоты сначала дождётся задачи, затем пересоберёт таблицу)
+    return std::async(std::launch::async,
+                      [this, bankId, padId, zones = std::move(zones),
+                       cache = cache_, sr = cfg_.sr, fmt = cfg_.storage]() mutable {
+                          struct Done { // this жив, пока задача не отметилась: деструктор ждёт
+                              SamplerNode* s;
+                              ~Done() {
+                                  std::lock_guard<std::mutex> lk(s->zonesMx_);
+                                  if (--s->zoneLoads_ == 0) s->zonesCv_.notify_all();
+                              }
+                          } done{this};
+                          auto zm = ZoneMap::build(std::move(zones), cache.get(), sr, fmt);
+                          if (!zm || zm->zoneCount() == 0) return false;
+                          setPadZones(bankId, padId, std::move(zm));
+                          return true;
+                      });
+}
+
+// Слайс/луп голоса из зоны (регион уже нормализован в ZoneMap::build)
+static void applyZoneRegion(Voice& v, const SampleZone& z) {
+    v.start     = z.region.start;
+    v.end       = z.region.end;
+    v.loopStart = z.region.loopStart;
+    v.loopEnd   = z.region.loopEnd;
+    v.loop      = z.region.loop;
+}
 
 void SamplerNode::noteOnPad(int padId, float velocity01) {
     const int bank = currentBank();
@@ -179,10 +344,16 @@ void SamplerNode::noteOnPad(int padId, float velocity01) {
     if (!inRangeBankPad(bank, padId)) return;
     auto& pad = pads_[bank][padId];
 
-    auto sample = atomicLoadSample(pad);
+    // Мультисэмпл: зона по (rootNote пэда, velocity) — одна ячейка таблицы, без поиска.
+    // zm держим до конца функции: фоновая публикация может подменить таблицу в пэде.
+    const ZoneMapPtr  zm   = atomicLoadZones(pad);
+    const SampleZone* zone = zm ? zm->pick(pad.rootNote, velocity01) : nullptr;
+    if (zm && !zone) return; // velocity/нота вне зон — тишина
+
+    auto sample = zone ? zone->sample : atomicLoadSample(pad);
     if (!sample || sample->frames <= 0) return;
 
-    Voice* v = voices_.allocSteal();
+    Voice* v = allocVoice();
     v->active = true;
     v->padId = padId;
     v->bankId = bank;
@@ -190,17 +361,21 @@ void SamplerNode::noteOnPad(int padId, float velocity01) {
     v->sample = sample;
 
     // Копируем слайс/луп и флаги на момент запуска
-    v->start = std::min((int) RSTART(bank, padId)->getFloat(), sample->frames-1);
-    v->end   = std::max((int) REND(bank, padId)->getFloat(), sample->frames);
+    if (zone) {
+        applyZoneRegion(*v, *zone);
+    } else {
+        v->start = std::min((int) RSTART(bank, padId)->getFloat(), sample->frames-1);
+        v->end   = std::max((int) REND(bank, padId)->getFloat(), sample->frames);
 
-    v->loopStart = std::clamp((int) RLSTART(bank, padId)->getFloat(), v->start, v->end-1);
-    v->loopEnd   = std::clamp((int) RLEND(bank, padId)->getFloat(), v->loopStart+1, v->end);
+        v->loopStart = std::clamp((int) RLSTART(bank, padId)->getFloat(), v->start, v->end-1);
+        v->loopEnd   = std::clamp((int) RLEND(bank, padId)->getFloat(), v->loopStart+1, v->end);
 
-    auto loopMode = RMODE(bank, padId)->getFloat();
+        auto loopMode = RMODE(bank, padId)->getFloat();
 
-    if      (loopMode == 1) v->loop = LoopMode::Forward;
-    else if (loopMode == 2) v->loop = LoopMode::PingPong;
-    else v->loop = LoopMode::None;
+        if      (loopMode == 1) v->loop = LoopMode::Forward;
+        else if (loopMode == 2) v->loop = LoopMode::PingPong;
+        else v->loop = LoopMode::None;
+    }
 
     v->fHalf = (bool) HALF(bank, padId)->getFloat();
     v->fRev  = (bool) REV(bank, padId)->getFloat();
@@ -212,21 +387,30 @@ void SamplerNode::noteOnPad(int padId, float velocity01) {
     // Скорость чтения: 1 фрейм за сэмпл (pitch = 0st). HALF/REV учтём в process().
     v->rate = 1.0;
 
-    // Гейн/пан + простая velocity-модуляция
-    v->gainLin = GAIN(bank, padId)->getFloat() * std::clamp(velocity01, 0.f, 1.f);
-    v->pan = std::clamp(PAN(bank, padId)->getFloat(), -1.f, 1.f);
+    // velocity × зона; gain/pan трека — на сумме пэда (applyPadGainPan), голос — в центре
+    v->gainLin = std::clamp(velocity01, 0.f, 1.f);
+    if (zone) v->gainLin *= zone->gainLin;
+    v->pan = 0.f;
 
-    // Огибающая — старт в Attack
-    v->envPhase = Voice::EnvPhase::Attack;
-    v->env = 0.f;
-    // Нормируем envA/envR по sr (чтобы 5 мс/25 мс примерно сохранялись)
-    const float aMs = ATK(bank, padId)->getFloat(), rMs = REL(bank, padId)->getFloat();
-    v->envA = std::max(1e-6f, (1.f / std::max(1.f, cfg_.sr * (aMs/1000.f))));
-    v->envR = std::max(1e-6f, (1.f / std::max(1.f, cfg_.sr * (rMs/1000.f))));
+    // Огибающая — старт в Attack (времена в мс → коэффициенты по sr движка)
+    v->env.setSampleRate((float)cfg_.sr);
+    v->env.setParams(envParams(bank, padId));
+    v->env.noteOn();
+
+    if (v->fDrag) startStretch(*v, bank, padId);
 }
 
 void SamplerNode::noteOffPad(int padId) { voices_.noteOffPad(padId); }
 
+AdsrParams SamplerNode::envParams(int bank, int padId) noexcept {
+    AdsrParams e;
+    e.attackMs  = ATK(bank, padId)->getFloat();
+    e.decayMs   = DEC(bank, padId)->getFloat();
+    e.sustain   = SUS(bank, padId)->getFloat();
+    e.releaseMs = REL(bank, padId)->getFloat();
+    return e;
+}
+
 // --- Хроматический режим (упрощённая версия) ---
 void SamplerNode::setChromaticPad(int padId) { chromaticPad_.store(std::clamp(padId,0,kPadsPerBank-1)); }
 void SamplerNode::setChromaticEnabled(bool on) { chromaticOn_.store(on); }
@@ -238,26 +422,36 @@ void SamplerNode::noteOnChromatic(int midiNote, float velocity01) {
     if (!inRangeBankPad(bank, padId)) return;
 
     auto& pad = pads_[bank][padId];
-    auto sample = atomicLoadSample(pad);
+
+    // Key-зоны: нота × velocity → зона (см. noteOnPad)
+    const ZoneMapPtr  zm   = atomicLoadZones(pad);
+    const SampleZone* zone = zm ? zm->pick(midiNote, velocity01) : nullptr;
+    if (zm && !zone) return;
+
+    auto sample = zone ? zone->sample : atomicLoadSample(pad);
     if (!sample || sample->frames <= 0) return;
 
-    Voice* v = voices_.allocSteal();
+    Voice* v = allocVoice();
     v->active = true;
     v->padId = padId;
     v->bankId = bank;
     v->midiNote = midiNote;
     v->sample = sample;
 
-    v->start = std::min((int) RSTART(bank, padId)->getFloat(), sample->frames-1);
-    v->end   = std::min((int) REND(bank, padId)->getFloat(), sample->frames);
-    v->loopStart = std::clamp((int) RLSTART(bank, padId)->getFloat(), v->start, v->end-1);
-    v->loopEnd   = std::clamp((int) RLEND(bank, padId)->getFloat(), v->loopStart+1, v->end);
+    if (zone) {
+        applyZoneRegion(*v, *zone);
+    } else {
+        v->start = std::min((int) RSTART(bank, padId)->getFloat(), sample->frames-1);
+        v->end   = std::min((int) REND(bank, padId)->getFloat(), sample->frames);
+        v->loopStart = std::clamp((int) RLSTART(bank, padId)->getFloat(), v->start, v->end-1);
+        v->loopEnd   = std::clamp((int) RLEND(bank, padId)->getFloat(), v->loopStart+1, v->end);
 
-    auto loopMode = RMODE(bank, padId)->getFloat();
+        auto loopMode = RMODE(bank, padId)->getFloat();
 
-    if      (loopMode == 1) v->loop = LoopMode::Forward;
-    else if (loopMode == 2) v->loop = LoopMode::PingPong;
-    else v->loop = LoopMode::None;
+        if      (loopMode == 1) v->loop = LoopMode::Forward;
+        else if (loopMode == 2) v->loop = LoopMode::PingPong;
+        else v->loop = LoopMode::None;
+    }
 
     v->fHalf = (bool) HALF(bank, padId)->getFloat();
     v->fRev  = (bool) REV(bank, padId)->getFloat();
@@ -267,25 +461,184 @@ void SamplerNode::noteOnChromatic(int midiNote, float velocity01) {
     v->rate = 1.0;
 
     v->gainLin = pad.gainLin * std::clamp(velocity01, 0.f, 1.f);
+    if (zone) v->gainLin *= zone->gainLin;
     v->pan = std::clamp(pad.pan, -1.f, 1.f);
 
-    // pitch → rate (±48 st допустим)
-    const int semis = std::clamp(midiNote - pad.rootNote, -48, 48);
+    // pitch → rate (±48 st допустим); у зоны свой rootNote
+    const int root  = zone ? zone->rootNote : pad.rootNote;
+    const int semis = std::clamp(midiNote - root, -48, 48);
     v->rate *= std::pow(2.0, semis / 12.0);
 
-    v->envPhase = Voice::EnvPhase::Attack;
-    v->env = 0.f;
-    const float aMs = 5.f, rMs = 25.f;
-    v->envA = std::max(1e-6f, (1.f / std::max(1.f, cfg_.sr * (aMs/1000.f))));
-    v->envR = std::max(1e-6f, (1.f / std::max(1.f, cfg_.sr * (rMs/1000.f))));
+    v->env.setSampleRate((float)cfg_.sr);
+    v->env.setParams(envParams(bank, padId));
+    v->env.noteOn();
+
+    if (v->fDrag) startStretch(*v, bank, padId);
+}
+
+// --- DRAG: time-stretch ---
+void SamplerNode::startStretch(Voice& v, int bank, int padId) {
+    if (stretch_.empty() || stL_.empty()) return; // prepare() ещё не было
+
+    int slot = -1;
+    for (int i = 0; i < kMaxStretchVoices; ++i) {
+        const Voice* o = stretchOwner_[(size_t)i];
+        if (!o || o == &v || o->stretchSlot != i || !o->active || !o->env.active()) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) return; // все заняты → fallback на замедленное чтение (renderVoice)
+
+    const double halfK = v.fHalf ? 0.5 : 1.0;
+    v.stretchSlot  = slot;
+    v.stretchRatio = std::max(0.25, (double)STRATIO(bank, padId)->getFloat());
+    v.stretchBeats = std::max(0.0,  (double)STBEATS(bank, padId)->getFloat());
+    v.stretchPitch = v.rate * halfK * std::pow(2.0, (double)STPITCH(bank, padId)->getFloat() / 12.0);
+    stretchOwner_[(size_t)slot] = &v;
+
+    const auto mode = std::lround(STMODE(bank, padId)->getFloat()) == 1 ? StretchMode::Vocoder
+                                                                         : StretchMode::Granular;
+    const SampleRegion r{v.start, v.end, v.loopStart, v.loopEnd, v.loop};
+    auto& st = stretch_[(size_t)slot];
+    st.setSpeed(stretchSpeed(v), v.stretchPitch);
+    st.start(v.sample.get(), r, v.pos, v.fRev, mode);
+}
+
+// Кадров источника на кадр выхода. beats > 0 — регион ложится ровно на beats долей при текущем темпе.
+double SamplerNode::stretchSpeed(const Voice& v) const noexcept {
+    if (v.stretchBeats > 0.0 && tempoBpm_ > 0.0) {
+        const double outFrames = v.stretchBeats * 60.0 / tempoBpm_ * (double)cfg_.sr;
+        return (double)(v.end - v.start) / std::max(1.0, outFrames);
+    }
+    const double halfK = v.fHalf ? 0.5 : 1.0;
+    return v.rate * halfK / v.stretchRatio;
 }
 
 void SamplerNode::noteOffChromatic(int midiNote){ voices_.noteOffChromatic(midiNote); }
 
+// --- Чтение семпла: формат хранения спрятан за Reader'ом ---
+namespace {
+
+// Float32: прямой доступ к плоскостям
+struct F32Reader {
+    const float* L;
+    const float* R; // nullptr → mono
+    inline void frame(int p0, int p1, float& l0, float& l1, float& r0, float& r1) noexcept {
+        l0 = L[p0]; l1 = L[p1];
+        if (R) { r0 = R[p0]; r1 = R[p1]; } else { r0 = l0; r1 = l1; }
+    }
+};
+
+// Int16: читаем из окна голоса; промах → векторный декод следующего окна
+struct I16Reader {
+    const SampleBuffer& s;
+    DecodeWindow& w;
+    bool reverse;
+    inline void frame(int p0, int p1, float& l0, float& l1, float& r0, float& r1) noexcept {
+        if (w.src != &s || !w.contains(p0, p1)) w.fill(s, p0, p1, reverse);
+        const int a = p0 - w.first, b = p1 - w.first;
+        l0 = w.L[a]; l1 = w.L[b];
+        r0 = w.R[a]; r1 = w.R[b];
+    }
+};
+
+} // namespace
+
+void DecodeWindow::fill(const SampleBuffer& s, int p0, int p1, bool reverse) noexcept {
+    // окно «по ходу движения»: вперёд — от p0, назад — заканчивается на p1
+    int f = reverse ? p1 - kFrames + 1 : p0;
+    f = std::clamp(f, 0, std::max(0, s.frames - kFrames));
+    src   = &s;
+    first = f;
+    count = std::min(kFrames, s.frames - f);
+
+    constexpr float k = 1.f / 32768.f;
+    simd::convertI16ToF32(s.pcmL.get() + f, L, count, k);
+    if (s.stereo()) simd::convertI16ToF32(s.pcmR.get() + f, R, count, k);
+    else            std::copy(L, L + count, R); // mono→stereo
+}
+
+template<class Reader>
+bool SamplerNode::renderVoice(Voice& v, Reader& rd, int n) {
+    bool hasAudio = false;
+
+    const double halfK = v.fHalf ? 0.5 : 1.0;
+    const double dragK = v.fDrag ? 0.1 : 1.0;   // fallback, если не хватило стретчера из пула
+    const double dirK  = v.fRev  ? -1.0 : 1.0;
+
+    // огибающая целым блоком; live — сколько кадров до её затухания
+    const int live = v.env.render(envBuf_.data(), n);
+
+    for (int i = 0; i < live; ++i) {
+        // --- границы/луп ---
+        if (v.pos < v.start || v.pos >= v.end - 1) {
+            if (!applyLoopOrStop(v)) {
+                break;
+            }
+        }
+
+        // --- линейная интерполяция ---
+        const int   p0 = (int)std::floor(v.pos);
+        const int   p1 = std::min(p0 + 1, v.end - 1);
+        const float t  = (float)(v.pos - p0);
+
+        float l0, l1, r0, r1;
+        rd.frame(p0, p1, l0, l1, r0, r1);
+        const float l = interpolate(l0, l1, t);
+        const float r = interpolate(r0, r1, t);
+
+        // --- гейн*огибающая + панорама ---
+        const float gain = v.gainLin * envBuf_[i];
+        float l2, r2;
+        panEqualPower(l * gain, r * gain, v.pan, l2, r2);
+
+        // --- сумма в скретч ---
+        scratchL_[i] += l2;
+        scratchR_[i] += r2;
+        hasAudio = true;
+
+        // --- шаг позиции ---
+        const double step = v.rate * halfK * dragK * dirK;
+        v.pos += step;
+
+        if (v.pos < v.start || v.pos >= v.end) {
+            if (!applyLoopOrStop(v)) break;
+        }
+    }
+    return hasAudio;
+}
+
+bool SamplerNode::renderStretched(Voice& v, int n) {
+    auto& st = stretch_[(size_t)v.stretchSlot];
+    if (v.stretchBeats > 0.0) st.setSpeed(stretchSpeed(v), v.stretchPitch); // темп мог смениться
+
+    const int got  = st.render(stL_.data(), stR_.data(), n);
+    const int live = v.env.render(envBuf_.data(), n);
+    bool hasAudio = false;
+    for (int i = 0; i < std::min(got, live); ++i) {
+        const float gain = v.gainLin * envBuf_[i];
+        float l2, r2;
+        panEqualPower(stL_[i] * gain, stR_[i] * gain, v.pan, l2, r2);
+        scratchL_[i] += l2;
+        scratchR_[i] += r2;
+        hasAudio = true;
+    }
+    // Источник кончился (LoopMode::None) — хвост грейнов уже выдан, голос свободен
+    if (got < n) v.env.kill();
+    return hasAudio;
+}
+
 // --- Аудио-процессинг ---
 void SamplerNode::process(AlchemyAudioBuffer& /*out*/, MidiBuffer& /*midi*/, const ProcessContext& ctx) {
     const int n    = ctx.blockSize;
     const int bank = currentBank_.load(std::memory_order_relaxed);
+    auto& all = voices_.all();
+    if (ctx.tempoBpm > 0.0) tempoBpm_ = ctx.tempoBpm;
+
+    padGain_.process(n);
+    padPan_.process(n);
+    if (vals_) bankSnap_.update(*vals_, vals_->tracksRange(trackOf(bank, 0), kPadsPerBank));
 
     // идём по пэдам, чтобы сделать ровно ОДИН addDry на пэд за блок
     for (int pad = 0; pad < kPadsPerBank; ++pad) {
@@ -296,8 +649,9 @@ void SamplerNode::process(AlchemyAudioBuffer& /*out*/, MidiBuffer& /*midi*/, con
         std::fill(scratchR_.begin(), scratchR_.begin() + n, 0.f);
 
         // пробегаем все активные голоса ЭТОГО пэда и суммируем в скретч
-        for (auto& v : voices_.all()) {
-            if (!v.active || !v.sample || v.envPhase == Voice::EnvPhase::Off) continue;
+        for (size_t vi = 0; vi < all.size(); ++vi) {
+            Voice& v = all[vi];
+            if (!v.active || !v.sample || !v.env.active()) continue;
             if (v.padId != pad || v.bankId != bank) continue;
 
             auto& pd = pads_[bank][pad];
@@ -314,61 +668,14 @@ void SamplerNode::process(AlchemyAudioBuffer& /*out*/, MidiBuffer& /*midi*/, con
             }
 
             const auto* smp = v.sample.get();
-            const float* sL = smp->dataL.get();
-            const float* sR = (smp->channels > 1 && smp->dataR) ? smp->dataR.get() : nullptr;
-
-            const double halfK = v.fHalf ? 0.5 : 1.0;
-            const double dragK = v.fDrag ? 0.1 : 1.0;   // MVP
-            const double dirK  = v.fRev  ? -1.0 : 1.0;
-
-            for (int i = 0; i < n; ++i) {
-                // --- огибающая A/R ---
-                switch (v.envPhase) {
-                    case Voice::EnvPhase::Attack:
-                        v.env += v.envA;
-                        if (v.env >= 1.f) { v.env = 1.f; v.envPhase = Voice::EnvPhase::Sustain; }
-                        break;
-                    case Voice::EnvPhase::Sustain: break;
-                    case Voice::EnvPhase::Release:
-                        v.env -= v.envR;
-                        if (v.env <= 0.f) { v.env = 0.f; v.envPhase = Voice::EnvPhase::Off; }
-                        break;
-                    case Voice::EnvPhase::Off: break;
-                }
-                if (v.envPhase == Voice::EnvPhase::Off) break;
-
-                // --- границы/луп ---
-                if (v.pos < v.start || v.pos >= v.end - 1) {
-                    if (!applyLoopOrStop(v)) {
-                        break;
-                    }
-                }
-
-                // --- линейная интерполяция ---
-                const int   p0 = (int)std::floor(v.pos);
-                const int   p1 = std::min(p0 + 1, v.end - 1);
-                const float t  = (float)(v.pos - p0);
-
-                const float l = interpolate(sL[p0], sL[p1], t);
-                const float r = sR ? interpolate(sR[p0], sR[p1], t) : l; // mono→stereo
-
-                // --- гейн*огибающая + панорама ---
-                const float gain = v.gainLin * v.env;
-                float l2, r2;
-                panEqualPower(l * gain, r * gain, v.pan, l2, r2);
-
-                // --- сумма в скретч ---
-                scratchL_[i] += l2;
-                scratchR_[i] += r2;
-                padHasAudio = true;
-
-                // --- шаг позиции ---
-                const double step = v.rate * halfK * dragK * dirK;
-                v.pos += step;
-
-                if (v.pos < v.start || v.pos >= v.end) {
-                    if (!applyLoopOrStop(v)) break;
-                }
+            if (v.stretchSlot >= 0) {
+                padHasAudio |= renderStretched(v, n);
+            } else if (smp->format == SampleFormat::Int16) {
+                I16Reader rd{*smp, windows_[vi], v.fRev};
+                padHasAudio |= renderVoice(v, rd, n);
+            } else {
+                F32Reader rd{smp->dataL.get(), smp->stereo() ? smp->dataR.get() : nullptr};
+                padHasAudio |= renderVoice(v, rd, n);
             }
         }
 
@@ -377,11 +684,32 @@ void SamplerNode::process(AlchemyAudioBuffer& /*out*/, MidiBuffer& /*midi*/, con
 
             const int trackId = trackOf(bank, pad);
 
+            applyPadGainPan(bank, pad, n);
             ctx.tracks->addDry(trackId, scratchL_.data(), scratchR_.data(), n);
         }
     }
 }
 
+// Баланс трека: equal-power × √2 — центр даёт 1 (голос уже отпанорамлен в центр, −3 дБ)
+static void padBalance(float gain, float pan, float& gL, float& gR) noexcept {
+    const float theta = (std::clamp(pan, -1.f, 1.f) * 0.5f + 0.5f) * (float)M_PI_2;
+    gL = gain * (float)M_SQRT2 * std::cos(theta);
+    gR = gain * (float)M_SQRT2 * std::sin(theta);
+}
+
+// RT: gain/pan трека на сумму пэда — линейная рампа от начала к концу блока; стоящие — константа
+void SamplerNode::applyPadGainPan(int bank, int pad, int n) noexcept {
+    if (refs_.idx(bank, pad) >= padGain_.size()) return; // bindParams ещё не было
+    const ParamSmoother& g = padGain_[refs_.idx(bank, pad)];
+    const ParamSmoother& p = padPan_[refs_.idx(bank, pad)];
+    float l0, r0, l1, r1;
+    padBalance(g.end(), p.end(), l1, r1);
+    if (g.moving() || p.moving()) padBalance(g.start(), p.start(), l0, r0);
+    else { l0 = l1; r0 = r1; }
+    applyRamp(scratchL_.data(), n, l0, l1);
+    applyRamp(scratchR_.data(), n, r0, r1);
+}
+
 // Проверка валидности индексов
 bool SamplerNode::inRangeBankPad(int bankId, int padId) const {
     return bankId >= 0 && bankId < (int)pads_.size()
@@ -391,8 +719,7 @@ bool SamplerNode::inRangeBankPad(int bankId, int padId) const {
 // Луп/стоп логика
 bool SamplerNode::applyLoopOrStop(Voice& v) {
     if (v.loop == LoopMode::None) {
-        if (v.envPhase != Voice::EnvPhase::Release)
-            v.envPhase = Voice::EnvPhase::Release;
+        v.env.noteOff();
         v.pos = std::clamp(v.pos, (double)v.start, (double)(v.end - 1));
         return false;
     }
@@ -1,24 +1,67 @@
 #pragma once
 #include "devices/ISampler.h"
+#include "devices/Envelope.h"
 #include <array>
+#include <cmath>
+#include <condition_variable>
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <params/Param.h>
+#include "params/Smoothing.h"
 
 static constexpr int kPads = 16;
 static constexpr int kBanks = 4;
 
+class SampleCache;
+class ZoneMap;
+struct SampleZone;
+class TimeStretcher;
+using ZoneMapPtr = std::shared_ptr<const ZoneMap>;
 
-// Лёгкая обёртка над аудио-буфером семпла (non-interleaved float32)
+
+// Формат хранения семпла в RAM
+//  Float32 — dataL/dataR (4 байта на сэмпл)
+//  Int16   — pcmL/pcmR (2 байта на сэмпл), декодируется на лету окнами в голосе
+enum class SampleFormat : uint8_t { Float32, Int16 };
+
+// Лёгкая обёртка над аудио-буфером семпла (non-interleaved, planar)
 struct SampleBuffer {
     int sr = 48000;
     int channels = 1;     // 1 или 2
     int frames = 0;
+    SampleFormat format = SampleFormat::Float32;
     // Память владеем через shared_ptr, чтобы безопасно свапать между потоками
     std::shared_ptr<float[]> dataL; // канал 0
     std::shared_ptr<float[]> dataR; // канал 1 (может быть nullptr, если mono)
+    // Компактное хранение (format == Int16): значение = pcm / 32768
+    std::shared_ptr<int16_t[]> pcmL;
+    std::shared_ptr<int16_t[]> pcmR;
+
+    bool   hasData() const { return format == SampleFormat::Int16 ? (bool)pcmL : (bool)dataL; }
+    bool   stereo()  const { return channels > 1 && (format == SampleFormat::Int16 ? (bool)pcmR : (bool)dataR); }
+    size_t bytes()   const {
+        const size_t per = format == SampleFormat::Int16 ? sizeof(int16_t) : sizeof(float);
+        return (size_t)frames * per * (stereo() ? 2u : 1u);
+    }
 };
 using SampleBufferPtr = std::shared_ptr<SampleBuffer>;
 
+// Окно декодированных кадров для Int16-семплов (по одному на голос, живёт в SamplerNode).
+// Голос читает float'ы из окна; при выходе позиции за окно — перезаливка (векторный декод).
+struct DecodeWindow {
+    static constexpr int kFrames = 256;
+    const SampleBuffer* src = nullptr;
+    int first = 0;   // первый кадр источника в окне
+    int count = 0;   // сколько кадров валидно
+    alignas(64) float L[kFrames]{};
+    alignas(64) float R[kFrames]{};
+
+    bool contains(int p0, int p1) const { return p0 >= first && p1 < first + count; }
+    // Заполнить окно так, чтобы [p0, p1] попали внутрь; reverse — окно «назад» от p1
+    void fill(const SampleBuffer& s, int p0, int p1, bool reverse) noexcept;
+};
+
 
 // Регион/слайс внутри семпла
 enum class LoopMode : uint8_t { None, Forward, PingPong };
@@ -33,7 +76,9 @@ struct SampleRegion {
 
 // Параметры пэда
 struct PadDesc {
-    SampleBufferPtr sample;
+    SampleBufferPtr sample;  // то, что играет аудио-тред (уже в частоте движка)
+    SampleBufferPtr source;  // оригинал как загрузили (для переконверсии при смене sr; НЕ RT)
+    ZoneMapPtr      zones;   // мультисэмпл (velocity-слои/round-robin/key-зоны); если есть — главнее sample
     SampleRegion region{0,0,0,0,LoopMode::None};
     int  rootNote = 60;     // для хроматического режима
     float gainLin = 1.f;    // линейный гейн (до панорамирования)
@@ -49,6 +94,8 @@ struct PadDesc {
     // 2) Копирующий конструктор: копируем атомики через load()
     PadDesc(const PadDesc& o)
             : sample(o.sample),
+              source(o.source),
+              zones(o.zones),
               region(o.region),
               rootNote(o.rootNote),
               gainLin(o.gainLin),
@@ -63,6 +110,8 @@ struct PadDesc {
     PadDesc& operator=(const PadDesc& o) {
         if (this == &o) return *this;
         sample   = o.sample;
+        source   = o.source;
+        zones    = o.zones;
         region   = o.region;
         rootNote = o.rootNote;
         gainLin  = o.gainLin;
@@ -76,6 +125,8 @@ struct PadDesc {
     // 4) Перемещающий конструктор: атомики "переносятся" как копия через load()
     PadDesc(PadDesc&& o) noexcept
             : sample(std::move(o.sample)),
+              source(std::move(o.source)),
+              zones(std::move(o.zones)),
               region(o.region),
               rootNote(o.rootNote),
               gainLin(o.gainLin),
@@ -90,6 +141,8 @@ struct PadDesc {
     PadDesc& operator=(PadDesc&& o) noexcept {
         if (this == &o) return *this;
         sample   = std::move(o.sample);
+        source   = std::move(o.source);
+        zones    = std::move(o.zones);
         region   = o.region;
         rootNote = o.rootNote;
         gainLin  = o.gainLin;
@@ -109,6 +162,14 @@ inline void atomicStoreSample(PadDesc& pad, SampleBufferPtr p) {
     std::atomic_store_explicit(&pad.sample, std::move(p), std::memory_order_release);
 }
 
+inline ZoneMapPtr atomicLoadZones(const PadDesc& pad) {
+    return std::atomic_load_explicit(&pad.zones, std::memory_order_acquire);
+}
+
+inline void atomicStoreZones(PadDesc& pad, ZoneMapPtr p) {
+    std::atomic_store_explicit(&pad.zones, std::move(p), std::memory_order_release);
+}
+
 
 // Голос — это «живущая нота/звучание» конкретного пэда.
 // Зачем нужен Voice?
@@ -129,12 +190,8 @@ struct Voice {
     double pos = 0.0;
     double rate = 1.0;
 
-    // Огибающая (очень простая A/R)
-    enum class EnvPhase { Attack, Sustain, Release, Off };
-    EnvPhase envPhase = EnvPhase::Off;
-    float env = 0.f;      // текущее значение 0..1
-    float envA = 0.005f;  // прирост за сэмпл в Attack (≈5 мс при sr=48k)
-    float envR = 0.002f;  // убыль за сэмпл в Release (≈24 мс при sr=48k)
+    // Огибающая ADSR (блочная, экспоненциальная); Idle — голос отзвучал
+    Adsr env;
 
     // Гейн/пан на момент старта (копируем из пэда под сглаживанием)
     float gainLin = 1.f;
@@ -147,6 +204,12 @@ struct Voice {
     // Флаги режима, зафиксированные при старте (чтобы не прыгали в полёте)
     bool fHalf = false, fRev = false, fDrag = false;
 
+    // DRAG через time-stretch (см. TimeStretcher): слот в пуле сэмплера, -1 — обычное чтение
+    int    stretchSlot  = -1;
+    double stretchRatio = 10.0; // во сколько раз медленнее (если beats == 0)
+    double stretchBeats = 0.0;  // > 0 — растянуть регион ровно на столько долей (tempo-sync)
+    double stretchPitch = 1.0;  // множитель высоты, независимый от скорости
+
     // Служебное
     bool pingpongForward = true; // для PingPong
 };
@@ -177,10 +240,12 @@ public:
         int sr = 48000;
         int maxVoices = 64;
         int banks = kBanks;
+        SampleFormat storage = SampleFormat::Float32; // Int16 — вдвое меньше RAM, декод на лету
     };
 
 
     explicit SamplerNode(const char* id);
+    ~SamplerNode() override;
 
     // 1) Регистрация своих параметров в сторадже (НЕ RT)
     void registerParams(IParameterStore& ps) override;
@@ -201,7 +266,22 @@ public:
     int currentBank() const;
     static int trackOf(int bank, int pad);
 
+    // НЕ RT: если buf->sr != sr движка — буфер конвертируется (через кеш) до публикации в пэд,
+    // чтобы голоса всегда играли с rate == 1.0 без пер-голосовой коррекции.
     void loadSample(int bankId, int padId, const SampleBufferPtr& buf, const SampleRegion& rgn);
+    // Общий кеш конверсий (можно разделить между несколькими сэмплерами). НЕ RT.
+    void setSampleCache(std::shared_ptr<SampleCache> cache);
+    // Формат хранения для последующих loadSample/prepare (уже загруженные не трогаем). НЕ RT.
+    void setStorageFormat(SampleFormat fmt);
+
+    // Мультисэмпл на пэд: таблица строится в фоне (ZoneMap::buildAsync), затем атомарно
+    // подменяется в пэде. nullptr — вернуться к одиночному sample. НЕ RT.
+    // Снятая таблица не освобождается здесь же: аудио могло взять на неё ссылку в noteOn —
+    // она ждёт в zonesRetired_, пока ссылка не останется только там (освобождает следующий вызов).
+    void setPadZones(int bankId, int padId, ZoneMapPtr zones);
+    // Построить таблицу в фоне (с конверсией в sr/формат движка) и опубликовать в пэд.
+    // future → true, если таблица опубликована. prepare() и деструктор ждут незавершённые загрузки.
+    std::future<bool> loadZonesAsync(int bankId, int padId, std::vector<SampleZone> zones);
 
 
 // Pad mode
@@ -224,15 +304,32 @@ public:
 private:
     std::vector<float> scratchL_;
     std::vector<float> scratchR_;
+    std::vector<float> envBuf_;   // огибающая текущего голоса на блок
     static constexpr int kPadsPerBank = kPads;
     const char* id_ = "sampler";
     bool inRangeBankPad(int bankId, int padId) const;
     static bool applyLoopOrStop(Voice& v); // returns true if still playing (looped), false → enter release/off
+    // Рендер одного голоса в scratch; Reader прячет формат хранения (float / int16-окно)
+    template<class Reader> bool renderVoice(Voice& v, Reader& rd, int n);
+    AdsrParams envParams(int bank, int padId) noexcept;
+    // DRAG: занять стретчер из пула и запустить его (RT, без аллокаций); нет слота — обычное чтение
+    void startStretch(Voice& v, int bank, int padId);
+    double stretchSpeed(const Voice& v) const noexcept;
+    bool renderStretched(Voice& v, int n);
 
     Config cfg_;
+    std::shared_ptr<SampleCache> cache_;
+
+    // мультисэмпл: снятые таблицы и счётчик фоновых загрузок (НЕ RT, под zonesMx_)
+    std::mutex              zonesMx_;
+    std::condition_variable zonesCv_;
+    int                     zoneLoads_ = 0;
+    std::vector<ZoneMapPtr> zonesRetired_;
+    void waitZoneLoads();
     std::atomic<int> currentBank_{0};
     std::atomic<int> chromaticPad_{0};
     std::atomic<bool> chromaticOn_{false};
+    double tempoBpm_ = 120.0; // последний темп из ProcessContext (для stretch.beats)
 
 
 // banks × 16 pads
@@ -240,19 +337,26 @@ private:
 
     struct ParamRefs {
         int banks=0, pads=16;
-        std::vector<IParam*> atk, rel, gain, pan, half, rev, drag;
+        std::vector<IParam*> atk, dec, sus, rel, gain, pan, half, rev, drag;
         std::vector<IParam*> rStart, rEnd, rLStart, rLEnd, rMode;
+        std::vector<IParam*> stMode, stRatio, stBeats, stPitch;
+        // region.* читается в process() на каждый голос — по хэндлам из блочного снимка банка
+        std::vector<ParamHandle> hStart, hEnd, hLStart, hLEnd, hMode;
         void resize(int b, int p) {
             banks=b; pads=p; const int N=b*p;
             auto init = [&](std::vector<IParam*>& v){ v.assign(N,nullptr); };
-            init(atk); init(rel); init(gain); init(pan);
+            init(atk); init(dec); init(sus); init(rel); init(gain); init(pan);
             init(half); init(rev); init(drag);
             init(rStart); init(rEnd); init(rLStart); init(rLEnd); init(rMode);
+            init(stMode); init(stRatio); init(stBeats); init(stPitch);
+            for (auto* h : {&hStart, &hEnd, &hLStart, &hLEnd, &hMode}) h->assign(N, ParamHandle{});
         }
         int idx(int b,int p) const { return b*pads + p; }
     } refs_;
 
     inline IParam*& ATK(int b,int p){ return refs_.atk[refs_.idx(b,p)]; }
+    inline IParam*& DEC(int b,int p){ return refs_.dec[refs_.idx(b,p)]; }
+    inline IParam*& SUS(int b,int p){ return refs_.sus[refs_.idx(b,p)]; }
     inline IParam*& REL(int b,int p){ return refs_.rel[refs_.idx(b,p)]; }
     inline IParam*& GAIN(int b,int p){ return refs_.gain[refs_.idx(b,p)]; }
     inline IParam*& PAN (int b,int p){ return refs_.pan [refs_.idx(b,p)]; }
@@ -264,8 +368,33 @@ private:
     inline IParam*& RLSTART   (int b,int p){ return refs_.rLStart[refs_.idx(b,p)]; }
     inline IParam*& RLEND   (int b,int p){ return refs_.rLEnd  [refs_.idx(b,p)]; }
     inline IParam*& RMODE (int b,int p){ return refs_.rMode [refs_.idx(b,p)]; }
+    inline IParam*& STMODE (int b,int p){ return refs_.stMode [refs_.idx(b,p)]; }
+    inline IParam*& STRATIO(int b,int p){ return refs_.stRatio[refs_.idx(b,p)]; }
+    inline IParam*& STBEATS(int b,int p){ return refs_.stBeats[refs_.idx(b,p)]; }
+    inline IParam*& STPITCH(int b,int p){ return refs_.stPitch[refs_.idx(b,p)]; }
+
+    // gain/pan трека пэда — не «запекаются» в голос на note-on, а сглаживаются и
+    // применяются к сумме пэда перед addDry (индекс = refs_.idx(b,p))
+    SmootherBank padGain_, padPan_;
+
+    // параметры треков текущего банка (16 треков подряд в массиве стора) — снимок раз в блок
+    ParamValues*  vals_ = nullptr;
+    ParamSnapshot bankSnap_;
+    float snapValue(ParamHandle h, IParam* fallback) const noexcept {
+        return bankSnap_.contains(h) ? bankSnap_[h] : fallback->getFloat();
+    }
+    void applyPadGainPan(int bank, int pad, int n) noexcept;
 
     PolyAllocator voices_;
+    std::vector<DecodeWindow> windows_; // [voice] — окна декода для Int16-семплов
+    Voice* allocVoice() noexcept;       // allocSteal + сброс окна декода голоса (новый/украденный голос)
+
+    // Пул стретчеров DRAG: память выделена в prepare(), голос лишь «арендует» слот.
+    // Слот свободен, если владелец ушёл/переродился (owner->stretchSlot != i) — без явного free.
+    static constexpr int kMaxStretchVoices = 16;
+    std::vector<TimeStretcher> stretch_;
+    std::array<Voice*, kMaxStretchVoices> stretchOwner_{};
+    std::vector<float> stL_, stR_;
 };
 
 
@@ -0,0 +1,318 @@
+#include "devices/SynthNode.h"
+#include "utils/FastMath.h"
+#include "utils/Simd.h"
+#include "utils/TrackPath.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+constexpr float kVoiceLevel     = 0.1f;  // запас на полифонию (16 голосов не должны клиповать мастер)
+constexpr float kMaxDetuneSemis = 0.5f;  // detune = 1 → крайние лейны ±50 центов
+constexpr float kDefaultSpread  = 0.7f;  // если unison.spread не зарегистрирован
+
+void addFloat(IParameterStore& ps, std::string id, float mn, float mx, float def, float step = 0.f) {
+    ParamMeta m{std::move(id), /*name*/"", ParamType::kFloat, mn, mx, def, step};
+    ps.add(std::make_unique<ParamFloat>(m));
+}
+
+// PolyBLEP-поправка на разрыве в t = 0 (t — фаза 0..1, dt — инкремент, inv = 1/dt)
+inline simd::f32x4 polyBlep(simd::f32x4 t, simd::f32x4 dt, simd::f32x4 inv) noexcept {
+    const simd::f32x4 one = simd::splat4(1.f), zero = simd::splat4(0.f);
+    const simd::f32x4 a = t * inv;                 // t < dt:      2x − x² − 1
+    const simd::f32x4 ra = a + a - a * a - one;
+    const simd::f32x4 b = (t - one) * inv;         // t > 1 − dt:  x² + 2x + 1
+    const simd::f32x4 rb = b * b + b + b + one;
+    return simd::select(t < dt, ra, simd::select(t > one - dt, rb, zero));
+}
+
+inline simd::f32x4 wrap01(simd::f32x4 p) noexcept {
+    const simd::f32x4 one = simd::splat4(1.f);
+    return simd::select(p >= one, p - one, p);
+}
+
+} // namespace
+
+SynthNode::SynthNode(const std::string& id) : id_(id) {
+    std::fill(std::begin(note_), std::end(note_), -1);
+    for (int l = 0; l < kMaxLanes; ++l) noise_[l] = 0x9E3779B9u * (std::uint32_t)(l + 1);
+}
+
+void SynthNode::registerParams(IParameterStore& ps) {
+    addFloat(ps, TrackPath::trackParam(track_, "gain"), 0.f, 2.f, 1.f);
+    addFloat(ps, TrackPath::trackParam(track_, "unison.spread"), 0.f, 1.f, 0.7f); // стерео-ширина унисона
+    addFloat(ps, TrackPath::trackParam(track_, "env.attackMs"),  0.f, 2000.f, 5.f,   0.1f);
+    addFloat(ps, TrackPath::trackParam(track_, "env.decayMs"),   0.f, 5000.f, 150.f, 0.1f);
+    addFloat(ps, TrackPath::trackParam(track_, "env.sustain"),   0.f, 1.f,    0.8f);
+    addFloat(ps, TrackPath::trackParam(track_, "env.releaseMs"), 0.f, 5000.f, 200.f, 0.1f);
+}
+
+void SynthNode::bindParams(IParameterStore& ps) {
+    gainH_   = ps.handle(TrackPath::trackParam(track_, "gain"));
+    spreadH_ = ps.handle(TrackPath::trackParam(track_, "unison.spread"));
+    atkH_    = ps.handle(TrackPath::trackParam(track_, "env.attackMs"));
+    decH_    = ps.handle(TrackPath::trackParam(track_, "env.decayMs"));
+    susH_    = ps.handle(TrackPath::trackParam(track_, "env.sustain"));
+    relH_    = ps.handle(TrackPath::trackParam(track_, "env.releaseMs"));
+    vals_    = ps.values();
+    snap_.reserve(vals_ ? vals_->trackRange(track_).count : 0);
+}
+
+void SynthNode::prepare(const ProcessContext& ctx) {
+    sr_ = ctx.sampleRate > 0 ? ctx.sampleRate : 48000.0;
+    maxBlock_ = std::max(1, ctx.blockSize);
+    envBuf_.assign((size_t)kMaxVoices * (size_t)maxBlock_, 0.f);
+    zeroRow_.assign((size_t)maxBlock_, 0.f);
+    accL_.assign((size_t)maxBlock_ * 4, 0.f);
+    accR_.assign((size_t)maxBlock_ * 4, 0.f);
+    outL_.assign((size_t)maxBlock_, 0.f);
+    outR_.assign((size_t)maxBlock_, 0.f);
+
+    // нота → инкремент; выше ~0.45 (почти Найквист) PolyBLEP уже не спасает — ограничим
+    for (int k = 0; k < 128; ++k) {
+        const double f = 440.0 * std::pow(2.0, (k - 69) / 12.0);
+        noteInc_[(size_t)k] = (float)std::min(0.45, f / sr_);
+    }
+    for (auto& e : env_) e.setSampleRate((float)sr_);
+    gain_.setRamp(ParamSmoother::kDefaultRampMs, (int)sr_);
+}
+
+// ---- события нот (любой поток → очередь) ----
+void SynthNode::noteOn(int note, float vel) {
+    (void)events_.push(NoteEvent{note, vel, true}); // очередь полна — нота теряется (не блокируемся)
+}
+
+void SynthNode::noteOff(int note) {
+    if (events_.push(NoteEvent{note, 0.f, false}) || note < 0 || note > 127) return;
+    // очередь полна — отпускание не теряем (иначе нота зависнет), а помечаем битом
+    lostOff_[(size_t)(note >> 6)].fetch_or(std::uint64_t{1} << (note & 63), std::memory_order_relaxed);
+}
+
+void SynthNode::setUnison(int voices, float detune) {
+    unison_.store(std::clamp(voices, 1, kMaxUnison), std::memory_order_relaxed);
+    detune_.store(std::clamp(detune, 0.f, 1.f), std::memory_order_relaxed);
+}
+
+AdsrParams SynthNode::envParams() const noexcept {
+    return AdsrParams{param(atkH_, 5.f), param(decH_, 150.f), param(susH_, 0.8f), param(relH_, 200.f)};
+}
+
+// RT: та же нота — ретриггер этого голоса; иначе свободный; иначе кража
+// (сначала самый тихий из отпущенных, затем самый старый).
+void SynthNode::startVoice(int note, float vel) noexcept {
+    note = std::clamp(note, 0, 127);
+    int v = -1;
+    for (int i = 0; i < kMaxVoices && v < 0; ++i) if (note_[i] == note && env_[i].active()) v = i;
+    for (int i = 0; i < kMaxVoices && v < 0; ++i) if (!env_[i].active()) v = i;
+    if (v < 0) {
+        float quiet = 2.f;
+        for (int i = 0; i < kMaxVoices; ++i) {
+            if (env_[i].released() && env_[i].value() < quiet) { quiet = env_[i].value(); v = i; }
+        }
+    }
+    if (v < 0) {
+        v = 0;
+        for (int i = 1; i < kMaxVoices; ++i) if (age_[i] < age_[v]) v = i;
+    }
+
+    const bool retrigger = note_[v] == note && env_[v].active();
+    const int   U      = unison_.load(std::memory_order_relaxed);
+    const float detune = detune_.load(std::memory_order_relaxed);
+    const float spread = U > 1 ? std::clamp(param(spreadH_, kDefaultSpread), 0.f, 1.f) : 0.f;
+    const float amp    = kVoiceLevel * std::clamp(vel, 0.f, 1.f) / std::sqrt((float)U); // унисон не громче ноты
+    const float base   = noteInc_[(size_t)note];
+
+    // Лейны голоса: детюн и пан симметрично от центра (x ∈ [-1, 1]); pow/cos/sin — только здесь
+    const int l0 = v * kMaxUnison;
+    for (int k = 0; k < kMaxUnison; ++k) {
+        const int l = l0 + k;
+        if (k >= U) { inc_[l] = 0.f; gainL_[l] = gainR_[l] = 0.f; continue; }
+        const float x = U > 1 ? 2.f * (float)k / (float)(U - 1) - 1.f : 0.f;
+        inc_[l] = std::min(0.45f, base * std::exp2(x * detune * kMaxDetuneSemis / 12.f));
+        const float theta = (x * spread * 0.5f + 0.5f) * fastmath::kHalfPi; // equal-power, как panEqualPower
+        gainL_[l] = amp * std::cos(theta) * (float)M_SQRT2;
+        gainR_[l] = amp * std::sin(theta) * (float)M_SQRT2;
+        if (!retrigger || k >= lanes_[v]) {
+            // суперсо: случайные стартовые фазы лейнов, иначе атака «фейзит»; одиночный лейн — с нуля
+            std::uint32_t r = noise_[l];
+            r ^= r << 13; r ^= r >> 17; r ^= r << 5;
+            noise_[l] = r;
+            phase_[l] = U > 1 ? (float)(r >> 8) * (1.f / 16777216.f) : 0.f;
+        }
+    }
+
+    note_[v]  = note;
+    lanes_[v] = U;
+    age_[v]   = ++clock_;
+    env_[v].setParams(envParams());
+    env_[v].noteOn();
+}
+
+void SynthNode::releaseVoice(int note) noexcept {
+    for (int i = 0; i < kMaxVoices; ++i) {
+        if (note_[i] == note) env_[i].noteOff();
+    }
+}
+
+void SynthNode::setWavetable(WavetableBankPtr bank, int table) {
+    std::atomic_store_explicit(&bank_, std::move(bank), std::memory_order_release);
+    table_.store(std::max(0, table), std::memory_order_relaxed);
+}
+
+// ---- рендер ----
+
+// Огибающие звучащих голосов + упаковка их лейнов подряд (голос за голосом).
+// Хвост добивается «тихими» лейнами до кратности 4.
+int SynthNode::packLanes(int n, const WavetableBank* bank, int table) noexcept {
+    int c = 0;
+    for (int v = 0; v < kMaxVoices; ++v) {
+        if (!env_[v].active()) continue;
+        float* row = envBuf_.data() + (size_t)v * (size_t)maxBlock_;
+        env_[v].render(row, n);
+        for (int k = 0; k < lanes_[v]; ++k, ++c) {
+            const int l = v * kMaxUnison + k;
+            pSrc_[c] = l;
+            pPh_[c]  = phase_[l];
+            pInc_[c] = inc_[l];
+            pInv_[c] = 1.f / inc_[l];
+            pGL_[c]  = gainL_[l];
+            pGR_[c]  = gainR_[l];
+            pRng_[c] = noise_[l];
+            pEnv_[c] = row;
+            pTab_[c] = bank ? bank->level(table, WavetableBank::mipFor(inc_[l])) : nullptr; // мип — раз в блок
+        }
+    }
+    const int live = c;
+    for (; c % 4 != 0; ++c) {
+        pSrc_[c] = -1;
+        pPh_[c] = pInc_[c] = pInv_[c] = pGL_[c] = pGR_[c] = 0.f;
+        pRng_[c] = 1u;
+        pEnv_[c] = zeroRow_.data();
+        pTab_[c] = bank ? bank->level(table, 0) : nullptr;
+    }
+    return live == 0 ? 0 : c;
+}
+
+void SynthNode::unpackLanes(int count) noexcept {
+    for (int c = 0; c < count; ++c) {
+        const int l = pSrc_[c];
+        if (l < 0) continue;
+        phase_[l] = pPh_[c];
+        noise_[l] = pRng_[c];
+    }
+}
+
+template<Wave W>
+void SynthNode::renderLanes(int count, int n) noexcept {
+    const simd::f32x4 one = simd::splat4(1.f), half = simd::splat4(0.5f);
+    const simd::f32x4 size = simd::splat4((float)WavetableBank::kSize);
+
+    for (int j = 0; j < count; j += 4) {
+        simd::f32x4 ph = simd::load4(pPh_ + j);
+        const simd::f32x4 inc = simd::load4(pInc_ + j);
+        const simd::f32x4 inv = simd::load4(pInv_ + j);
+        const simd::f32x4 gl  = simd::load4(pGL_ + j);
+        const simd::f32x4 gr  = simd::load4(pGR_ + j);
+        simd::u32x4 rng; std::memcpy(&rng, pRng_ + j, sizeof rng);
+        const float* const* e  = pEnv_ + j;
+        const float* const* tb = pTab_ + j;
+
+        for (int i = 0; i < n; ++i) {
+            simd::f32x4 s;
+            if constexpr (W == Wave::Saw) {
+                s = ph + ph - one - polyBlep(ph, inc, inv);
+            } else if constexpr (W == Wave::Square) {
+                const simd::f32x4 ph2 = wrap01(ph + half);
+                s = simd::select(ph < half, one, -one) + polyBlep(ph, inc, inv) - polyBlep(ph2, inc, inv);
+            } else if constexpr (W == Wave::Noise) {
+                rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+                s = __builtin_convertvector((simd::i32x4)rng, simd::f32x4) * simd::splat4(1.f / 2147483648.f);
+            } else {
+                // таблица: линейная интерполяция; guard-хвост уровня избавляет от маски на i0 + 1
+                const simd::f32x4 x  = ph * size;
+                const simd::i32x4 i0 = __builtin_convertvector(x, simd::i32x4);
+                const simd::f32x4 t  = x - __builtin_convertvector(i0, simd::f32x4);
+                const simd::f32x4 a{tb[0][i0[0]],     tb[1][i0[1]],     tb[2][i0[2]],     tb[3][i0[3]]};
+                const simd::f32x4 b{tb[0][i0[0] + 1], tb[1][i0[1] + 1], tb[2][i0[2] + 1], tb[3][i0[3] + 1]};
+                s = a + (b - a) * t;
+            }
+            const simd::f32x4 env{e[0][i], e[1][i], e[2][i], e[3][i]};
+            const simd::f32x4 y = s * env;
+            float* al = accL_.data() + (size_t)i * 4;
+            float* ar = accR_.data() + (size_t)i * 4;
+            simd::store4(al, simd::load4(al) + y * gl); // горизонтальная сумма — одна на сэмпл, в конце
+            simd::store4(ar, simd::load4(ar) + y * gr);
+            ph = wrap01(ph + inc);
+        }
+
+        simd::store4(pPh_ + j, ph);
+        std::memcpy(pRng_ + j, &rng, sizeof rng);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        outL_[(size_t)i] = simd::hsum(simd::load4(accL_.data() + (size_t)i * 4));
+        outR_[(size_t)i] = simd::hsum(simd::load4(accR_.data() + (size_t)i * 4));
+    }
+}
+
+void SynthNode::process(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx) {
+    const int n = std::min(ctx.blockSize, maxBlock_);
+    if (n <= 0) return; // prepare() ещё не было
+
+    if (vals_) snap_.update(*vals_, vals_->trackRange(track_)); // ручки трека — раз в блок
+
+    // 1) события: очередь от UI/шины + MIDI блока (без сэмпл-точности — на старте блока)
+    NoteEvent ev;
+    while (events_.pop(ev)) {
+        if (ev.on) startVoice(ev.note, ev.vel); else releaseVoice(ev.note);
+    }
+    for (size_t w = 0; w < lostOff_.size(); ++w) { // noteOff мимо полной очереди — после неё
+        for (std::uint64_t m = lostOff_[w].exchange(0, std::memory_order_relaxed); m; m &= m - 1)
+            releaseVoice((int)w * 64 + std::countr_zero(m));
+    }
+    for (const auto& m : midi) {
+        const int st = m.status & 0xF0;
+        if (st == 0x90 && m.data2 > 0)            startVoice(m.data1, (float)m.data2 / 127.f);
+        else if (st == 0x80 || st == 0x90)        releaseVoice(m.data1);
+    }
+
+    // 2) волна и банк — раз на блок (банк держим локально: UI может подменить его на ходу)
+    Wave w = wave_.load(std::memory_order_relaxed);
+    const WavetableBankPtr bank = w == Wave::Table
+            ? std::atomic_load_explicit(&bank_, std::memory_order_acquire) : nullptr;
+    const int table = bank ? std::min(table_.load(std::memory_order_relaxed), bank->count() - 1) : -1;
+    if (w == Wave::Table && table < 0) w = Wave::Saw;
+
+    // 3) лейны звучащих голосов → SIMD по 4
+    const int count = packLanes(n, w == Wave::Table ? bank.get() : nullptr, table);
+    for (int v = 0; v < kMaxVoices; ++v) if (!env_[v].active()) note_[v] = -1;
+    gain_.advance(param(gainH_, 1.f), n, vals_ && vals_->automated(gainH_)); // и в тишине — чтобы следующая нота не стартовала с рампы
+    if (count == 0) return;
+
+    std::fill(accL_.begin(), accL_.begin() + (size_t)n * 4, 0.f);
+    std::fill(accR_.begin(), accR_.begin() + (size_t)n * 4, 0.f);
+    switch (w) {
+        case Wave::Saw:    renderLanes<Wave::Saw>(count, n);    break;
+        case Wave::Square: renderLanes<Wave::Square>(count, n); break;
+        case Wave::Noise:  renderLanes<Wave::Noise>(count, n);  break;
+        case Wave::Table:  renderLanes<Wave::Table>(count, n);  break;
+    }
+    unpackLanes(count);
+
+    // 4) гейн трека (сглаженный)
+    gain_.apply(outL_.data(), n);
+    gain_.apply(outR_.data(), n);
+
+    if (ctx.tracks) {
+        ctx.tracks->addDry(track_, outL_.data(), outR_.data(), n);
+    } else {
+        // без трекового слоя (оффлайн/тесты) — прямо в io, как раньше
+        for (int ch = 0; ch < io.numChannels && ch < 2; ++ch) {
+            const float* src = ch == 0 ? outL_.data() : outR_.data();
+            for (int i = 0; i < n && i < io.numFrames; ++i) io.channels[ch][i] += src[i];
+        }
+    }
+}
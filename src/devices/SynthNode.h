@@ -1,59 +1,115 @@
 #pragma once
 #include "devices/ISynth.h"
-#include <set>
-#include <iostream>
-#include <map>
-#include <cmath>
-#include <iostream>
+#include "devices/Envelope.h"
+#include "devices/Wavetable.h"
+#include "params/Smoothing.h"
+#include "utils/MpscRing.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
 
+// Полифонический синт: фиксированный пул голосов (SoA), PolyBLEP saw/square, шум, волновые таблицы.
+//  - Голос (нота) владеет kMaxUnison подряд идущими осцилляторами-лейнами (унисон: детюн + стерео-спред).
+//  - На блок активные лейны всех голосов пакуются подряд и считаются SIMD по 4 лейна на вектор:
+//    без унисона это 4 голоса в векторе, у 7-голосного суперсо — 7 лейнов одной ноты в двух векторах,
+//    а огибающая и менеджмент голоса — одни на ноту.
+//  - Инкременты лейнов считаются в noteOn (таблица нот + детюн) — в цикле нет pow/sin.
+//  - noteOn/noteOff/setUnison можно звать из любого потока и из нескольких сразу: ноты идут в
+//    MPSC-очередь и применяются в начале process() (аудио-поток владеет пулом голосов).
+//    Очередь полна: noteOn теряется, noteOff — нет (бит ноты в lostOff_, отпускание в том же блоке).
+//  - Выход — DRY в свой трек через ITrackSink (дальше трековые FX и сумма в мастер).
 class SynthNode : public ISynth {
 public:
-    explicit SynthNode(const std::string& id) : id_(id) {}
+    static constexpr int kMaxVoices    = 16;
+    static constexpr int kMaxUnison    = 8;                        // лейнов на голос
+    static constexpr int kMaxLanes     = kMaxVoices * kMaxUnison;  // кратно 4 (SIMD)
+    static constexpr int kDefaultTrack = 16 * 4;  // первый трек после сэмплера (4 банка × 16 пэдов)
+
+    explicit SynthNode(const std::string& id);
+
     const char* id() const override { return id_.c_str(); }
     int numInputs()  const override { return 0; }
     int numOutputs() const override { return 2; }
-    void registerParams(IParameterStore& ps) override {};
-    void bindParams(IParameterStore& ps) override {};
-
-    void prepare(const ProcessContext& /*ctx*/) override {}
-    void process(AlchemyAudioBuffer& io, MidiBuffer& /*midi*/, const ProcessContext& ctx) override {
-        if (io.numChannels == 0 || io.numFrames == 0) return;
-        const double sr = ctx.sampleRate > 0 ? ctx.sampleRate : 48000.0;
-
-        for (int f=0; f<io.numFrames; ++f) {
-            double sample = 0.0;
-
-            for (auto note :  active_) {
-                auto &ph = phases_[note];
-                double freq = 440.0 * std::pow(2.0, (note - 69) / 12.0);
-                ph += 2.0 * M_PI * freq / sr;
-                if (ph > 2.0*M_PI) ph -= 2.0*M_PI;
-                sample += std::sin(ph) * 0.1; // quiet
-            }
-
-            float s = static_cast<float>(sample);
-
-            for (int ch=0; ch<io.numChannels; ++ch) {
-                io.channels[ch][f] += s;
-            }
-        }
-    }
+
+    // Параметры трека синта: gain, unison.spread и env.* (те же id, что у сэмплера → работают макросы UiFacade)
+    void registerParams(IParameterStore& ps) override;
+    void bindParams(IParameterStore& ps) override;
+
+    void prepare(const ProcessContext& ctx) override;
+    void process(AlchemyAudioBuffer& io, MidiBuffer& midi, const ProcessContext& ctx) override;
     void release() override {}
-    void noteOn(int note, float vel) override {
-        active_.insert(note);
-        std::cout << "[SynthNode] noteOn " << note << " vel=" << vel << "\n";
-    }
-    void noteOff(int note) override {
-        active_.erase(note);
-        std::cout << "[SynthNode] noteOff " << note << "\n";
-    }
-    void setWave(Wave w) override { wave_ = w; }
-    void setUnison(int voices, float detune) override { unison_=voices; detune_=detune; }
+
+    void noteOn(int note, float vel) override;
+    void noteOff(int note) override;
+    void setWave(Wave w) override { wave_.store(w, std::memory_order_relaxed); }
+    // voices 1..kMaxUnison, detune 0..1 (разнос крайних лейнов ±kMaxDetuneSemis); для новых нот
+    void setUnison(int voices, float detune) override;
+
+    // Банк таблиц и индекс таблицы для Wave::Table. Можно звать на ходу (атомарная подмена);
+    // банк должен быть уже построен. Без банка Wave::Table играет как Saw.
+    void setWavetable(WavetableBankPtr bank, int table);
+
+    // Трек, в который синт отдаёт DRY. НЕ RT: до prepare()/registerParams().
+    void setTrack(int trackId) { track_ = trackId; }
+    int  track() const { return track_; }
+
 private:
+    struct NoteEvent { int note = 0; float vel = 0.f; bool on = false; };
+
+    void startVoice(int note, float vel) noexcept;
+    void releaseVoice(int note) noexcept;
+    AdsrParams envParams() const noexcept;
+    float param(ParamHandle h, float def) const noexcept { return snap_.contains(h) ? snap_[h] : def; }
+    int  packLanes(int n, const WavetableBank* bank, int table) noexcept; // → число лейнов (кратно 4)
+    void unpackLanes(int count) noexcept;
+    template<Wave W> void renderLanes(int count, int n) noexcept;
+
     std::string id_;
-    Wave  wave_{Wave::Saw};
-    int   unison_{1};
-    float detune_{0.f};
-    std::set<int> active_;
-    std::map<int,double> phases_;
-};
\ No newline at end of file
+    std::atomic<Wave> wave_{Wave::Saw};
+    WavetableBankPtr  bank_;              // через atomic_load/atomic_store (как SampleBufferPtr в пэде)
+    std::atomic<int>  table_{0};
+    std::atomic<int>   unison_{1};
+    std::atomic<float> detune_{0.f};
+    int   track_ = kDefaultTrack;
+    double sr_ = 48000.0;
+    int   maxBlock_ = 0;
+
+    // ---- голоса ----
+    int           note_[kMaxVoices];           // -1 — свободен
+    int           lanes_[kMaxVoices]{};        // сколько лейнов унисона у голоса
+    std::uint32_t age_ [kMaxVoices]{};         // для кражи самого старого
+    std::uint32_t clock_ = 0;
+    std::array<Adsr, kMaxVoices> env_{};
+
+    // ---- лейны осцилляторов (SoA; голос v — [v·kMaxUnison, v·kMaxUnison + lanes_[v])) ----
+    alignas(16) float phase_ [kMaxLanes]{};    // 0..1
+    alignas(16) float inc_   [kMaxLanes]{};    // фаза за сэмпл (с детюном)
+    alignas(16) float gainL_ [kMaxLanes]{};    // уровень × velocity × пан лейна
+    alignas(16) float gainR_ [kMaxLanes]{};
+    alignas(16) std::uint32_t noise_[kMaxLanes]{}; // xorshift32
+
+    // ---- упакованные на блок лейны (подряд, хвост добит тихими до кратности 4) ----
+    alignas(16) float pPh_[kMaxLanes]{}, pInc_[kMaxLanes]{}, pInv_[kMaxLanes]{};
+    alignas(16) float pGL_[kMaxLanes]{}, pGR_[kMaxLanes]{};
+    alignas(16) std::uint32_t pRng_[kMaxLanes]{};
+    const float* pEnv_[kMaxLanes]{};           // строка огибающей голоса-владельца
+    const float* pTab_[kMaxLanes]{};           // мип-уровень таблицы (Wave::Table)
+    int          pSrc_[kMaxLanes]{};           // индекс лейна-источника (для записи фазы обратно)
+
+    std::array<float, 128> noteInc_{};         // нота → инкремент фазы при sr_
+
+    std::vector<float> envBuf_;                // [kMaxVoices × maxBlock_]
+    std::vector<float> zeroRow_;               // [maxBlock_] — огибающая лейнов-заглушек
+    std::vector<float> accL_, accR_;           // [maxBlock_ × 4] — суммы по лейнам вектора
+    std::vector<float> outL_, outR_;           // [maxBlock_]
+    MpscRing<NoteEvent, 256> events_;           // UI, MIDI-вход, секвенсор → аудио
+    std::array<std::atomic<std::uint64_t>, 2> lostOff_{}; // noteOff, не влезшие в events_: бит на ноту 0..127
+
+    // параметры трека: хэндлы + снимок диапазона трека раз в блок (один проход по массиву стора)
+    ParamValues*  vals_ = nullptr;
+    ParamSnapshot snap_;
+    ParamHandle gainH_, spreadH_, atkH_, decH_, susH_, relH_;
+    ParamSmoother gain_;                       // гейн трека: рампа по блоку, без «молнии» на ручке
+};
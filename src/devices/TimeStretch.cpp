@@ -0,0 +1,313 @@
+#include "devices/TimeStretch.h"
+#include "utils/FastMath.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr int   kTolerance = 256;   // WSOLA: ± окно поиска сдвига (кадры источника, ≈5 мс)
+constexpr int   kCorrLen   = 256;   // WSOLA: длина сравниваемого участка
+constexpr int   kCandMax   = 2 * kTolerance * 8 + kCorrLen; // при pitch ≥ 1/8
+constexpr float kVocoderOlaGain = 2.f / 3.f; // Hann·Hann при перекрытии 75% даёт 1.5
+
+// acc[i] += w[i] * g[i]
+inline void olaAdd(float* acc, const float* w, const float* g, int n) noexcept {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        simd::store4(acc + i, simd::load4(acc + i) + simd::load4(w + i) * simd::load4(g + i));
+    }
+    for (; i < n; ++i) acc[i] += w[i] * g[i];
+}
+
+inline float dot(const float* a, const float* b, int n) noexcept {
+    simd::f32x4 s = simd::splat4(0.f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) s += simd::load4(a + i) * simd::load4(b + i);
+    float r = simd::hsum(s);
+    for (; i < n; ++i) r += a[i] * b[i];
+    return r;
+}
+
+void hann(std::vector<float>& w, int n) {
+    w.resize((size_t)n);
+    for (int i = 0; i < n; ++i) w[(size_t)i] = 0.5f - 0.5f * std::cos(2.0 * M_PI * (double)i / (double)n); // периодическое
+}
+
+} // namespace
+
+void TimeStretcher::prepare() {
+    outL_.assign(kMaxN, 0.f); outR_.assign(kMaxN, 0.f);
+    accL_.assign(kMaxN, 0.f); accR_.assign(kMaxN, 0.f);
+    gL_.assign(kMaxN, 0.f);   gR_.assign(kMaxN, 0.f);
+    tmpl_.assign(kCorrLen, 0.f);
+    cand_.assign(kCandMax, 0.f);
+    hann(winG_, kGrain);
+    hann(winV_, kFft);
+
+    fft_.init(kFft);
+    const size_t bins = (size_t)fft_.bins();
+    reL_.assign(bins, 0.f); imL_.assign(bins, 0.f);
+    reR_.assign(bins, 0.f); imR_.assign(bins, 0.f);
+    lastPhL_.assign(bins, 0.f); lastPhR_.assign(bins, 0.f);
+    sumPhL_.assign(bins, 0.f);  sumPhR_.assign(bins, 0.f);
+    mag_.assign(bins, 0.f); ph_.assign(bins, 0.f); tmpPh_.assign(bins, 0.f);
+    peaks_.assign(bins, 0);
+}
+
+void TimeStretcher::start(const SampleBuffer* s, const SampleRegion& r, double pos, bool reverse,
+                          StretchMode m) noexcept {
+    src_   = s;
+    rgn_   = r;
+    mode_  = m;
+    dir_   = reverse ? -1.0 : 1.0;
+    first_ = true;
+    done_  = (s == nullptr || !s->hasData());
+    ready_ = 0; readIdx_ = 0;
+
+    frameN_ = (m == StretchMode::Vocoder) ? kFft : kGrain;
+    hop_    = (m == StretchMode::Vocoder) ? kFft / 4 : kGrain / 2;
+    std::fill(accL_.begin(), accL_.end(), 0.f);
+    std::fill(accR_.begin(), accR_.end(), 0.f);
+
+    // Пре-ролл: первый грейн центрируем на pos и выбрасываем его левую половину,
+    // иначе окно «съест» атаку (а для ударных это главное).
+    anaPos_    = pos - dir_ * (double)(frameN_ / 2) * pitch_;
+    prevGrain_ = anaPos_;
+    discard_   = frameN_ / 2;
+}
+
+void TimeStretcher::setSpeed(double speed, double pitch) noexcept {
+    speed_ = std::clamp(speed, 1e-3, 8.0);
+    pitch_ = std::clamp(pitch, 0.125, 8.0);
+}
+
+int TimeStretcher::render(float* L, float* R, int n) noexcept {
+    int done = 0;
+    while (done < n) {
+        if (ready_ == 0) {
+            if (done_) break;
+            if (mode_ == StretchMode::Vocoder) hopVocoder(); else hopGranular();
+        }
+        if (discard_ > 0) {
+            const int drop = std::min(discard_, ready_);
+            readIdx_ += drop; ready_ -= drop; discard_ -= drop;
+            continue;
+        }
+        const int take = std::min(n - done, ready_);
+        std::memcpy(L + done, outL_.data() + readIdx_, sizeof(float) * (size_t)take);
+        std::memcpy(R + done, outR_.data() + readIdx_, sizeof(float) * (size_t)take);
+        readIdx_ += take; ready_ -= take; done += take;
+    }
+    return done;
+}
+
+// ---------- чтение источника ----------
+
+bool TimeStretcher::mapPos(double p, double& out) const noexcept {
+    if (p < rgn_.start || p >= rgn_.end - 1) {
+        if (rgn_.loop == LoopMode::None || p < rgn_.start) return false;
+    }
+    const double ls = rgn_.loopStart, le = rgn_.loopEnd, len = le - ls;
+    if (rgn_.loop == LoopMode::Forward && p >= le && len > 1.0) {
+        p = ls + std::fmod(p - ls, len);
+    } else if (rgn_.loop == LoopMode::PingPong && p >= le && len > 1.0) {
+        double t = std::fmod(p - ls, 2.0 * len);
+        if (t >= len) t = 2.0 * len - t - 1.0;
+        p = ls + t;
+    }
+    if (p < rgn_.start || p >= rgn_.end - 1) return false;
+    out = p;
+    return true;
+}
+
+void TimeStretcher::frameAt(double p, float& l, float& r) const noexcept {
+    const int   i0 = (int)p;
+    const float t  = (float)(p - (double)i0);
+    const SampleBuffer& s = *src_;
+    if (s.format == SampleFormat::Int16) {
+        constexpr float k = 1.f / 32768.f;
+        const int16_t* a = s.pcmL.get();
+        l = ((float)a[i0] + ((float)a[i0 + 1] - (float)a[i0]) * t) * k;
+        if (s.stereo()) {
+            const int16_t* b = s.pcmR.get();
+            r = ((float)b[i0] + ((float)b[i0 + 1] - (float)b[i0]) * t) * k;
+        } else {
+            r = l;
+        }
+    } else {
+        const float* a = s.dataL.get();
+        l = a[i0] + (a[i0 + 1] - a[i0]) * t;
+        if (s.stereo()) {
+            const float* b = s.dataR.get();
+            r = b[i0] + (b[i0 + 1] - b[i0]) * t;
+        } else {
+            r = l;
+        }
+    }
+}
+
+void TimeStretcher::readGrain(double p0, int count, float* L, float* R) const noexcept {
+    const double step = dir_ * pitch_;
+    for (int k = 0; k < count; ++k) {
+        double p;
+        if (mapPos(p0 + step * (double)k, p)) frameAt(p, L[k], R[k]);
+        else { L[k] = 0.f; R[k] = 0.f; }
+    }
+}
+
+void TimeStretcher::readMono(double p0, int count, float* M) const noexcept {
+    const double step = dir_ * pitch_;
+    for (int k = 0; k < count; ++k) {
+        double p; float l, r;
+        if (mapPos(p0 + step * (double)k, p)) { frameAt(p, l, r); M[k] = 0.5f * (l + r); }
+        else M[k] = 0.f;
+    }
+}
+
+double TimeStretcher::advance(double p, double delta) noexcept {
+    p += delta;
+    const double ls = rgn_.loopStart, le = rgn_.loopEnd, len = le - ls;
+    switch (rgn_.loop) {
+        case LoopMode::None:
+            // пре-ролл стартует до региона — конец только по направлению движения
+            if (dir_ > 0.0 ? p >= rgn_.end - 1 : p < rgn_.start) done_ = true;
+            break;
+        case LoopMode::Forward:
+            if (len > 1.0) {
+                while (p >= le) p -= len;
+                if (dir_ < 0.0) while (p < ls) p += len;
+            }
+            break;
+        case LoopMode::PingPong:
+            if (len > 1.0) {
+                if (p >= le) { p = 2.0 * le - p; dir_ = -1.0; }
+                if (p <  ls) { p = 2.0 * ls - p; dir_ =  1.0; }
+            }
+            break;
+    }
+    return p;
+}
+
+// ---------- OLA ----------
+
+void TimeStretcher::pushHop(int hs) noexcept {
+    std::memcpy(outL_.data(), accL_.data(), sizeof(float) * (size_t)hs);
+    std::memcpy(outR_.data(), accR_.data(), sizeof(float) * (size_t)hs);
+    std::memmove(accL_.data(), accL_.data() + hs, sizeof(float) * (size_t)(frameN_ - hs));
+    std::memmove(accR_.data(), accR_.data() + hs, sizeof(float) * (size_t)(frameN_ - hs));
+    std::fill(accL_.begin() + (frameN_ - hs), accL_.begin() + frameN_, 0.f);
+    std::fill(accR_.begin() + (frameN_ - hs), accR_.begin() + frameN_, 0.f);
+    ready_ = hs; readIdx_ = 0;
+}
+
+// ---------- WSOLA ----------
+
+void TimeStretcher::hopGranular() noexcept {
+    const int N  = frameN_;    // kGrain
+    const int Hs = hop_;       // N / 2
+
+    double grainStart = anaPos_;
+    if (!first_) {
+        // Естественное продолжение предыдущего грейна — шаблон; ищем ближайший к anaPos
+        // сдвиг источника, максимально на него похожий (нет фазовых провалов на стыке).
+        const double natural = prevGrain_ + dir_ * (double)Hs * pitch_;
+        readMono(natural, kCorrLen, tmpl_.data());
+
+        const int span  = std::min(kCandMax - kCorrLen, (int)(2.0 * kTolerance / pitch_));
+        const double c0 = anaPos_ - dir_ * (double)kTolerance;
+        readMono(c0, span + kCorrLen, cand_.data());
+
+        const int stride = std::max(1, span / 128); // не больше ~128 кандидатов
+        int   best  = span / 2;
+        float bestC = -1e30f;
+        for (int m = 0; m <= span; m += stride) {
+            const float c = dot(cand_.data() + m, tmpl_.data(), kCorrLen);
+            if (c > bestC) { bestC = c; best = m; }
+        }
+        grainStart = c0 + dir_ * (double)best * pitch_;
+    }
+
+    readGrain(grainStart, N, gL_.data(), gR_.data());
+    olaAdd(accL_.data(), winG_.data(), gL_.data(), N);
+    olaAdd(accR_.data(), winG_.data(), gR_.data(), N);
+
+    prevGrain_ = grainStart;
+    first_ = false;
+    anaPos_ = advance(anaPos_, dir_ * (double)Hs * speed_);
+    pushHop(Hs);
+}
+
+// ---------- фазовый вокодер ----------
+
+void TimeStretcher::hopVocoder() noexcept {
+    const int N  = frameN_;    // kFft
+    const int Hs = hop_;       // N / 4
+    const int bins = fft_.bins();
+
+    readGrain(anaPos_, N, gL_.data(), gR_.data());
+    for (int i = 0; i < N; ++i) { gL_[(size_t)i] *= winV_[(size_t)i]; gR_[(size_t)i] *= winV_[(size_t)i]; }
+    fft_.forward(gL_.data(), reL_.data(), imL_.data());
+    fft_.forward(gR_.data(), reR_.data(), imR_.data());
+
+    // Анализ-хоп в «грейновом» времени: источник читается с шагом pitch
+    const float haG   = (float)std::max(1e-3, (double)Hs * speed_ / pitch_);
+    const float omega = fastmath::kTwoPi / (float)N;
+
+    // Identity phase locking (Laroche–Dolson): фаза продвигается только у пиков спектра,
+    // соседние бины держат относительную фазу своего пика — иначе бины «расходятся»
+    // (phasiness), и на сильном растяжении синус теряет уровень.
+    auto bin = [&](float* re, float* im, float* lastPh, float* sumPh) {
+        float* mag = mag_.data();
+        float* ph  = ph_.data();
+        for (int k = 0; k < bins; ++k) {
+            mag[k] = std::sqrt(re[k] * re[k] + im[k] * im[k]);
+            ph[k]  = fastmath::atan2(im[k], re[k]);
+        }
+        int np = 0;
+        for (int k = 1; k + 1 < bins; ++k) {
+            if (mag[k] > mag[k - 1] && mag[k] >= mag[k + 1]) peaks_[(size_t)np++] = k;
+        }
+        for (int i = 0; i < np; ++i) {
+            const int k = peaks_[(size_t)i];
+            if (first_) {
+                sumPh[k] = ph[k];
+            } else {
+                const float expect = omega * (float)k * haG;
+                const float dev    = fastmath::wrapPi(ph[k] - lastPh[k] - expect);
+                const float freq   = omega * (float)k + dev / haG;
+                sumPh[k] = fastmath::wrapPi(sumPh[k] + freq * (float)Hs);
+            }
+        }
+        // остальные бины — вращение вместе с ближайшим пиком (граница — середина между пиками)
+        int pi = 0;
+        for (int k = 0; k < bins; ++k) {
+            float out = ph[k];
+            if (np > 0) {
+                while (pi + 1 < np && k > (peaks_[(size_t)pi] + peaks_[(size_t)pi + 1]) / 2) ++pi;
+                const int p = peaks_[(size_t)pi];
+                out = (k == p) ? sumPh[p] : fastmath::wrapPi(sumPh[p] + ph[k] - ph[p]);
+            }
+            lastPh[k] = ph[k];
+            tmpPh_[(size_t)k] = out;
+        }
+        for (int k = 0; k < bins; ++k) {
+            sumPh[k] = tmpPh_[(size_t)k];
+            re[k] = mag[k] * fastmath::cos(sumPh[k]);
+            im[k] = mag[k] * fastmath::sin(sumPh[k]);
+        }
+    };
+    bin(reL_.data(), imL_.data(), lastPhL_.data(), sumPhL_.data());
+    bin(reR_.data(), imR_.data(), lastPhR_.data(), sumPhR_.data());
+
+    fft_.inverse(reL_.data(), imL_.data(), gL_.data());
+    fft_.inverse(reR_.data(), imR_.data(), gR_.data());
+    for (int i = 0; i < N; ++i) { gL_[(size_t)i] *= kVocoderOlaGain; gR_[(size_t)i] *= kVocoderOlaGain; }
+    olaAdd(accL_.data(), winV_.data(), gL_.data(), N);
+    olaAdd(accR_.data(), winV_.data(), gR_.data(), N);
+
+    first_ = false;
+    anaPos_ = advance(anaPos_, dir_ * (double)Hs * speed_);
+    pushHop(Hs);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "devices/SamplerNode.h"
+#include "utils/Fft.h"
+
+// Режим растяжения для DRAG:
+//  Granular — WSOLA (окна 1024, поиск лучшего сдвига по корреляции) — сохраняет атаки, для ударных
+//  Vocoder  — фазовый вокодер (FFT 2048, перекрытие 75%) — гладкие пэды/тональный материал
+enum class StretchMode : uint8_t { Granular, Vocoder };
+
+// Пер-голосовой движок time-stretch/pitch-shift.
+// Вся память — в prepare() (НЕ RT); start()/setSpeed()/render() — RT (без аллокаций/локов).
+//
+// speed — кадров источника на кадр выхода (1/растяжение), pitch — множитель высоты
+// (кадров источника на кадр внутри грейна). Время и высота независимы.
+class TimeStretcher {
+public:
+    static constexpr int kGrain = 1024;          // WSOLA: длина грейна
+    static constexpr int kFft   = 2048;          // Vocoder: размер окна
+    static constexpr int kMaxN  = kFft;
+
+    void prepare();                              // от SR не зависит: окна и поиск — в кадрах источника
+
+    // Начать с позиции pos (кадры) по региону r; reverse — анализ идёт назад.
+    // setSpeed() — до start(): от pitch зависит пре-ролл первого грейна.
+    void start(const SampleBuffer* s, const SampleRegion& r, double pos, bool reverse, StretchMode m) noexcept;
+    void setSpeed(double speed, double pitch) noexcept;
+
+    // Дописать до n кадров в L/R (перезапись). Вернёт сколько кадров выдано; < n — источник кончился.
+    int  render(float* L, float* R, int n) noexcept;
+
+    bool   finished() const noexcept { return done_ && ready_ == 0; }
+    double position() const noexcept { return anaPos_; }
+
+private:
+    void hopGranular() noexcept;
+    void hopVocoder()  noexcept;
+    void pushHop(int hs) noexcept;                 // выдать hs кадров из OLA-аккумулятора
+    bool mapPos(double p, double& out) const noexcept; // луп/границы региона → позиция в семпле
+    void frameAt(double p, float& l, float& r) const noexcept;
+    void readGrain(double p0, int count, float* L, float* R) const noexcept;
+    void readMono (double p0, int count, float* M) const noexcept;
+    double advance(double p, double delta) noexcept;
+
+    const SampleBuffer* src_ = nullptr;
+    SampleRegion rgn_{};
+    StretchMode mode_ = StretchMode::Granular;
+    double anaPos_ = 0.0;      // текущая позиция анализа (кадры семпла)
+    double prevGrain_ = 0.0;   // WSOLA: где стартовал предыдущий грейн
+    bool   first_ = true;
+    double speed_ = 1.0, pitch_ = 1.0;
+    double dir_ = 1.0;         // направление анализа; ping-pong лупа разворачивает его в advance()
+    bool   done_ = false;
+
+    int hop_ = kGrain / 2;     // синтез-хоп текущего режима
+    int frameN_ = kGrain;      // длина кадра текущего режима
+
+    // выходная очередь (готовые кадры одного хопа)
+    std::vector<float> outL_, outR_;
+    int ready_ = 0, readIdx_ = 0;
+    int discard_ = 0;          // сколько кадров пре-ролла ещё выбросить
+
+    // OLA-аккумулятор [kMaxN]
+    std::vector<float> accL_, accR_;
+    // окна
+    std::vector<float> winG_, winV_;
+    // скретч
+    std::vector<float> gL_, gR_, tmpl_, cand_;
+
+    // фазовый вокодер
+    RealFft fft_;
+    std::vector<float> reL_, imL_, reR_, imR_;
+    std::vector<float> lastPhL_, lastPhR_, sumPhL_, sumPhR_;
+    std::vector<float> mag_, ph_, tmpPh_; // скретч одного канала [bins]
+    std::vector<int>   peaks_;
+};
@@ -0,0 +1,229 @@
+#include "devices/Wavetable.h"
+#include "utils/Fft.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char          kMagic[4]   = {'A', 'L', 'W', 'T'};
+constexpr std::uint32_t kVersion    = 1;
+constexpr size_t        kDataOffset = 64; // данные выровнены по кэш-линии от начала файла
+
+struct CacheHeader {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t size, levels, guard, count;
+    std::uint64_t hash;
+};
+static_assert(sizeof(CacheHeader) <= kDataOffset, "header must fit before data");
+
+// FNV-1a
+struct Fnv {
+    std::uint64_t h = 1469598103934665603ull;
+    void add(const void* p, size_t n) {
+        const auto* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ull; }
+    }
+};
+
+// Периодическая линейная передискретизация цикла на kSize кадров
+void resampleCycle(const std::vector<float>& in, float* out, int n) {
+    const int L = (int)in.size();
+    if (L == n) { std::copy(in.begin(), in.end(), out); return; }
+    for (int i = 0; i < n; ++i) {
+        const double x = (double)i * (double)L / (double)n;
+        const int   i0 = (int)x;
+        const float t  = (float)(x - (double)i0);
+        const float a  = in[(size_t)i0 % (size_t)L], b = in[(size_t)(i0 + 1) % (size_t)L];
+        out[i] = a + (b - a) * t;
+    }
+}
+
+} // namespace
+
+WavetableBank::~WavetableBank() { unmap(); }
+
+int WavetableBank::find(const std::string& name) const {
+    for (size_t i = 0; i < names_.size(); ++i) if (names_[i] == name) return (int)i;
+    return -1;
+}
+
+int WavetableBank::mipFor(float inc) noexcept {
+    // гармоник в уровне m: (kSize/2) >> m; нужно ((kSize/2) >> m) · inc ≤ 0.5  ⇔  m ≥ log2(kSize · inc)
+    const float x = (float)kSize * inc;
+    if (x <= 1.f) return 0;
+    const int m = (int)std::ceil(std::log2(x));
+    return std::clamp(m, 0, kLevels - 1);
+}
+
+std::uint64_t WavetableBank::hashSources(const std::vector<Source>& s) {
+    Fnv f;
+    const std::uint32_t cfg[4] = {kVersion, (std::uint32_t)kSize, (std::uint32_t)kLevels, (std::uint32_t)kGuard};
+    f.add(cfg, sizeof cfg);
+    for (const auto& src : s) {
+        f.add(src.name.data(), src.name.size());
+        const std::uint64_t n = src.cycle.size();
+        f.add(&n, sizeof n);
+        f.add(src.cycle.data(), src.cycle.size() * sizeof(float));
+    }
+    return f.h;
+}
+
+bool WavetableBank::build(std::vector<Source> sources, const std::string& cachePath) {
+    sources.erase(std::remove_if(sources.begin(), sources.end(),
+                                 [](const Source& s){ return s.cycle.size() < 2; }),
+                  sources.end());
+    if (sources.empty()) return false;
+
+    unmap();
+    owned_.clear();
+    names_.clear();
+    for (const auto& s : sources) names_.push_back(s.name);
+
+    const std::uint64_t hash = hashSources(sources);
+    if (!cachePath.empty() && mapCache(cachePath, hash, (int)sources.size())) return true;
+
+    generate(sources);
+    if (!cachePath.empty()) writeCache(cachePath, hash);
+    return true;
+}
+
+void WavetableBank::generate(const std::vector<Source>& sources) {
+    const int count = (int)sources.size();
+    owned_.assign((size_t)count * kLevels * kStride, 0.f);
+
+    RealFft fft(kSize);
+    const int bins = fft.bins();
+    std::vector<float> cyc((size_t)kSize), re((size_t)bins), im((size_t)bins),
+                       r2((size_t)bins), i2((size_t)bins);
+
+    for (int t = 0; t < count; ++t) {
+        resampleCycle(sources[(size_t)t].cycle, cyc.data(), kSize);
+        fft.forward(cyc.data(), re.data(), im.data());
+        re[0] = im[0] = 0.f;                       // без DC
+        re[(size_t)bins - 1] = im[(size_t)bins - 1] = 0.f; // и без Найквиста
+
+        float norm = 0.f;
+        for (int m = 0; m < kLevels; ++m) {
+            const int maxH = (kSize / 2) >> m;
+            for (int k = 0; k < bins; ++k) {
+                const bool keep = k <= maxH && k < bins - 1;
+                r2[(size_t)k] = keep ? re[(size_t)k] : 0.f;
+                i2[(size_t)k] = keep ? im[(size_t)k] : 0.f;
+            }
+            float* dst = owned_.data() + ((size_t)t * kLevels + (size_t)m) * kStride;
+            fft.inverse(r2.data(), i2.data(), dst);
+
+            // нормировка по пику полного уровня — громкость не «прыгает» между мипами
+            if (m == 0) {
+                for (int i = 0; i < kSize; ++i) norm = std::max(norm, std::fabs(dst[i]));
+                norm = norm > 1e-9f ? 1.f / norm : 0.f;
+            }
+            for (int i = 0; i < kSize; ++i) dst[i] *= norm;
+            for (int g = 0; g < kGuard; ++g) dst[kSize + g] = dst[g];
+        }
+    }
+    data_ = owned_.data();
+}
+
+bool WavetableBank::mapCache(const std::string& path, std::uint64_t hash, int count) {
+    const size_t dataBytes = (size_t)count * kLevels * kStride * sizeof(float);
+    const size_t total = kDataOffset + dataBytes;
+
+    CacheHeader h{};
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f || !f.read(reinterpret_cast<char*>(&h), sizeof h)) return false;
+    }
+    if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion || h.hash != hash ||
+        h.size != (std::uint32_t)kSize || h.levels != (std::uint32_t)kLevels ||
+        h.guard != (std::uint32_t)kGuard || h.count != (std::uint32_t)count) {
+        return false;
+    }
+
+#if !defined(_WIN32)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || (size_t)st.st_size < total) { ::close(fd); return false; }
+    void* p = ::mmap(nullptr, total, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // отображение живёт и без дескриптора
+    if (p == MAP_FAILED) return false;
+    mapped_ = p;
+    mappedBytes_ = total;
+    data_ = reinterpret_cast<const float*>(static_cast<const char*>(p) + kDataOffset);
+    return true;
+#else
+    // Без mmap: читаем целиком (всё равно быстрее генерации)
+    std::ifstream f(path, std::ios::binary);
+    owned_.resize(dataBytes / sizeof(float));
+    f.seekg((std::streamoff)kDataOffset);
+    if (!f.read(reinterpret_cast<char*>(owned_.data()), (std::streamsize)dataBytes)) { owned_.clear(); return false; }
+    data_ = owned_.data();
+    return true;
+#endif
+}
+
+void WavetableBank::writeCache(const std::string& path, std::uint64_t hash) const {
+    CacheHeader h{};
+    std::memcpy(h.magic, kMagic, 4);
+    h.version = kVersion;
+    h.size = (std::uint32_t)kSize;
+    h.levels = (std::uint32_t)kLevels;
+    h.guard = (std::uint32_t)kGuard;
+    h.count = (std::uint32_t)count();
+    h.hash = hash;
+
+    // Пишем во временный файл и переименовываем — параллельный старт не увидит недописанный кеш
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) return;
+        char pad[kDataOffset] = {};
+        std::memcpy(pad, &h, sizeof h);
+        f.write(pad, sizeof pad);
+        f.write(reinterpret_cast<const char*>(owned_.data()), (std::streamsize)(owned_.size() * sizeof(float)));
+        if (!f) { f.close(); std::remove(tmp.c_str()); return; }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) std::remove(tmp.c_str());
+}
+
+void WavetableBank::unmap() {
+#if !defined(_WIN32)
+    if (mapped_) ::munmap(mapped_, mappedBytes_);
+#endif
+    mapped_ = nullptr;
+    mappedBytes_ = 0;
+    data_ = owned_.empty() ? nullptr : owned_.data();
+}
+
+std::vector<WavetableBank::Source> WavetableBank::builtinSources() {
+    // «Наивные» циклы: ограничение полосы делает generate()
+    constexpr int n = kSize;
+    auto make = [](const char* name, auto fn) {
+        Source s{name, std::vector<float>((size_t)n)};
+        for (int i = 0; i < n; ++i) s.cycle[(size_t)i] = fn((double)i / (double)n);
+        return s;
+    };
+    std::vector<Source> v;
+    v.push_back(make("sine",     [](double t){ return (float)std::sin(2.0 * M_PI * t); }));
+    v.push_back(make("triangle", [](double t){ return (float)(t < 0.5 ? 4.0 * t - 1.0 : 3.0 - 4.0 * t); }));
+    v.push_back(make("saw",      [](double t){ return (float)(2.0 * t - 1.0); }));
+    v.push_back(make("square",   [](double t){ return t < 0.5 ? 1.f : -1.f; }));
+    v.push_back(make("pulse25",  [](double t){ return t < 0.25 ? 1.f : -1.f; }));
+    v.push_back(make("organ",    [](double t){ // «драуберы» 16' 8' 4' 2 2/3'
+        const double w = 2.0 * M_PI * t;
+        return (float)(std::sin(w) + 0.8 * std::sin(2 * w) + 0.6 * std::sin(4 * w) + 0.4 * std::sin(6 * w));
+    }));
+    return v;
+}
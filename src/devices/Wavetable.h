@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Банк волновых таблиц с band-limited мип-уровнями (по октаве на уровень).
+//  - Уровень m содержит гармоники 1..(kSize/2 >> m); уровень выбирается по инкременту фазы
+//    так, чтобы верхняя гармоника не перешла Найквист (mipFor — раз в блок на голос).
+//  - Уровни строятся FFT: спектр цикла → обрезка бинов → обратное FFT.
+//  - Сгенерированное пишется в бинарный кеш; при следующем старте файл mmap'ится
+//    (без копирования и без пересчёта), если хеш исходников совпал.
+// build()/load — НЕ RT. После build() банк неизменяем: читать можно из любого потока.
+class WavetableBank {
+public:
+    static constexpr int kSize   = 2048;  // кадров на цикл
+    static constexpr int kLevels = 11;    // 1024 → 1 гармоника
+    static constexpr int kGuard  = 4;     // хвост-копия начала цикла (интерполяция без маски)
+    static constexpr int kStride = kSize + kGuard;
+
+    struct Source {
+        std::string name;
+        std::vector<float> cycle; // один период, любая длина ≥ 2
+    };
+
+    WavetableBank() = default;
+    ~WavetableBank();
+    WavetableBank(const WavetableBank&) = delete;
+    WavetableBank& operator=(const WavetableBank&) = delete;
+
+    // Взять таблицы из кеша (mmap) или сгенерировать и записать кеш.
+    // cachePath пустой — без кеша. false — нет валидных источников.
+    bool build(std::vector<Source> sources, const std::string& cachePath);
+    bool fromCache() const { return mapped_ != nullptr; }
+
+    int count() const { return (int)names_.size(); }
+    int find(const std::string& name) const;            // -1 — нет такой
+    const std::string& name(int table) const { return names_[(size_t)table]; }
+
+    // Уровень m таблицы t: kSize кадров + kGuard (RT)
+    const float* level(int table, int mip) const noexcept {
+        return data_ + ((size_t)table * kLevels + (size_t)mip) * kStride;
+    }
+
+    // Мип-уровень для инкремента фазы inc (циклов на сэмпл): гармоник ≤ 0.5 / inc (RT)
+    static int mipFor(float inc) noexcept;
+
+    // Встроенный набор: sine, triangle, saw, square, pulse25, organ
+    static std::vector<Source> builtinSources();
+
+private:
+    static std::uint64_t hashSources(const std::vector<Source>& s);
+    void generate(const std::vector<Source>& sources);
+    bool mapCache(const std::string& path, std::uint64_t hash, int count);
+    void writeCache(const std::string& path, std::uint64_t hash) const;
+    void unmap();
+
+    std::vector<std::string> names_;
+    std::vector<float> owned_;          // сгенерировано в этом запуске
+    void*  mapped_ = nullptr;           // или отображённый кеш
+    size_t mappedBytes_ = 0;
+    const float* data_ = nullptr;       // [table][level][kStride]
+};
+
+using WavetableBankPtr = std::shared_ptr<const WavetableBank>;
@@ -0,0 +1,107 @@
+#include "devices/ZoneMap.h"
+#include "utils/SampleCache.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace {
+
+// Привести семпл зоны к частоте/формату движка, регион — в новые кадры
+void conformZone(SampleZone& z, SampleCache& cache, int targetSr, SampleFormat fmt) {
+    if (!z.sample) return;
+    auto out = cache.convert(z.sample, targetSr, fmt);
+    if (!out) { z.sample.reset(); return; }
+    if (out->frames != z.sample->frames && z.sample->frames > 0) {
+        const double k = (double)out->frames / (double)z.sample->frames;
+        auto scale = [k](int f){ return (int)std::lround((double)f * k); };
+        z.region.start     = scale(z.region.start);
+        z.region.end       = scale(z.region.end);
+        z.region.loopStart = scale(z.region.loopStart);
+        z.region.loopEnd   = scale(z.region.loopEnd);
+    }
+    z.sample = std::move(out);
+}
+
+} // namespace
+
+std::shared_ptr<const ZoneMap> ZoneMap::build(std::vector<SampleZone> zones, SampleCache* cache,
+                                              int targetSr, SampleFormat fmt)
+{
+    auto m = std::make_shared<ZoneMap>();
+    m->sources_  = zones;
+    m->targetSr_ = cache ? targetSr : 0;
+    m->fmt_      = fmt;
+
+    // 1) отбросить пустые, нормализовать диапазоны и регионы
+    for (auto& z : zones) {
+        if (cache && targetSr > 0) conformZone(z, *cache, targetSr, fmt);
+        if (!z.sample || z.sample->frames <= 0) continue;
+
+        z.loKey = std::clamp(z.loKey, 0, kKeys-1);
+        z.hiKey = std::clamp(z.hiKey, z.loKey, kKeys-1);
+        z.loVel = std::clamp(z.loVel, 0, kVels-1);
+        z.hiVel = std::clamp(z.hiVel, z.loVel, kVels-1);
+
+        const int total = z.sample->frames;
+        auto& r = z.region;
+        if (r.end <= 0 || r.end > total) r.end = total;
+        r.start     = std::clamp(r.start, 0, r.end-1);
+        r.loopStart = std::clamp(r.loopStart, r.start, r.end-1);
+        r.loopEnd   = std::clamp(r.loopEnd > 0 ? r.loopEnd : r.end, r.loopStart+1, r.end);
+
+        m->zones_.push_back(std::move(z));
+        if (m->zones_.size() >= kNone) break; // индексы uint16
+    }
+
+    // 2) для каждой ячейки — список покрывающих зон; одинаковые списки → один слот
+    std::map<std::vector<uint16_t>, uint16_t> dedup;
+    std::vector<uint16_t> cand;
+    for (int k = 0; k < kKeys; ++k) {
+        for (int v = 0; v < kVels; ++v) {
+            cand.clear();
+            for (size_t i = 0; i < m->zones_.size(); ++i) {
+                const auto& z = m->zones_[i];
+                if (k >= z.loKey && k <= z.hiKey && v >= z.loVel && v <= z.hiVel) cand.push_back((uint16_t)i);
+            }
+            uint16_t slot = kNone;
+            if (!cand.empty()) {
+                auto it = dedup.find(cand);
+                if (it == dedup.end()) {
+                    slot = (uint16_t)m->slots_.size();
+                    m->slots_.push_back(Slot{(uint32_t)m->indices_.size(), (uint32_t)cand.size()});
+                    m->indices_.insert(m->indices_.end(), cand.begin(), cand.end());
+                    dedup.emplace(cand, slot);
+                } else {
+                    slot = it->second;
+                }
+            }
+            m->cells_[(size_t)(k * kVels + v)] = slot;
+        }
+    }
+
+    m->rr_ = std::make_unique<std::atomic<uint32_t>[]>(std::max<size_t>(1, m->slots_.size()));
+    for (size_t i = 0; i < m->slots_.size(); ++i) m->rr_[i].store(0, std::memory_order_relaxed);
+    return m;
+}
+
+std::future<std::shared_ptr<const ZoneMap>> ZoneMap::buildAsync(std::vector<SampleZone> zones,
+                                                                std::shared_ptr<SampleCache> cache,
+                                                                int targetSr, SampleFormat fmt)
+{
+    return std::async(std::launch::async,
+                      [zones = std::move(zones), cache = std::move(cache), targetSr, fmt]() mutable {
+                          return build(std::move(zones), cache.get(), targetSr, fmt);
+                      });
+}
+
+const SampleZone* ZoneMap::pick(int note, float velocity01) const noexcept {
+    if (note < 0 || note >= kKeys) return nullptr;
+    const int vel = std::clamp((int)std::lround(velocity01 * 127.f), 1, kVels-1);
+    const uint16_t s = cells_[(size_t)(note * kVels + vel)];
+    if (s == kNone) return nullptr;
+
+    const Slot& sl = slots_[s];
+    uint32_t k = 0;
+    if (sl.count > 1) k = rr_[s].fetch_add(1, std::memory_order_relaxed) % sl.count;
+    return &zones_[indices_[sl.first + k]];
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+#include "devices/SamplerNode.h"
+
+// Зона мультисэмпла: семпл + регион + диапазоны нот/velocity.
+// Зоны с пересекающимися диапазонами в одной ячейке (нота × velocity) играются по кругу (round-robin).
+struct SampleZone {
+    SampleBufferPtr sample;
+    SampleRegion region{0,0,0,0,LoopMode::None}; // end == 0 → весь семпл
+    int   rootNote = 60;                     // для питча в хроматическом режиме
+    int   loKey = 0,  hiKey = 127;           // включительно
+    int   loVel = 1,  hiVel = 127;           // MIDI velocity, включительно
+    float gainLin = 1.f;
+};
+
+// ZoneMap — неизменяемая таблица (нота × velocity → набор зон), строится вне аудио-треда.
+//  - cells_[note*128 + vel] → индекс слота (kNone — пусто)
+//  - слот = непрерывный кусок indices_ (кандидаты round-robin)
+// Одинаковые наборы кандидатов дедуплицируются, так что таблица 32 КБ + крохи на слоты.
+// RT: pick() — два чтения из массивов и один relaxed fetch_add (счётчик round-robin).
+class ZoneMap {
+public:
+    static constexpr int kKeys = 128;
+    static constexpr int kVels = 128;
+    static constexpr uint16_t kNone = 0xFFFF;
+
+    // НЕ RT. Если targetSr > 0 — семплы зон приводятся к частоте/формату движка через cache
+    // (регионы пересчитываются в кадры сконвертированного буфера).
+    static std::shared_ptr<const ZoneMap> build(std::vector<SampleZone> zones,
+                                                SampleCache* cache = nullptr,
+                                                int targetSr = 0,
+                                                SampleFormat fmt = SampleFormat::Float32);
+
+    // То же в фоне (std::async). Результат публикуется в пэд через SamplerNode::setPadZones().
+    static std::future<std::shared_ptr<const ZoneMap>> buildAsync(std::vector<SampleZone> zones,
+                                                                  std::shared_ptr<SampleCache> cache = nullptr,
+                                                                  int targetSr = 0,
+                                                                  SampleFormat fmt = SampleFormat::Float32);
+
+    // RT: выбрать зону для ноты/скорости (0..1). nullptr — ни одна зона не покрывает ячейку.
+    const SampleZone* pick(int note, float velocity01) const noexcept;
+
+    size_t zoneCount() const { return zones_.size(); }
+    size_t slotCount() const { return slots_.size(); }
+
+    // Зоны как их передали в build() (исходные семплы/регионы) и целевые частота/формат —
+    // чтобы пересобрать таблицу под новую частоту движка без двойного ресемплинга
+    const std::vector<SampleZone>& sources() const { return sources_; }
+    int          targetSr() const { return targetSr_; }
+    SampleFormat format()   const { return fmt_; }
+
+private:
+    struct Slot { uint32_t first = 0; uint32_t count = 0; };
+
+    std::vector<SampleZone>           zones_;
+    std::vector<uint16_t>             indices_;   // индексы зон, сгруппированные по слотам
+    std::vector<Slot>                 slots_;
+    std::array<uint16_t, kKeys*kVels> cells_{};
+    std::unique_ptr<std::atomic<uint32_t>[]> rr_; // [slot] — курсор round-robin (единственное mutable)
+    std::vector<SampleZone>           sources_;
+    int                               targetSr_ = 0;
+    SampleFormat                      fmt_ = SampleFormat::Float32;
+};
@@ -0,0 +1,409 @@
+#include "fx/ConvReverb.h"
+#include "utils/Resampler.h"
+#include "utils/Simd.h"
+#include "utils/WavLoader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+// ---------------------------------------------------------------- UniformConvolver
+
+void UniformConvolver::init(const float* ir, int irLen, int blockSize) {
+    B_ = blockSize;
+    P_ = std::max(1, (irLen + B_ - 1) / B_);
+    fft_.init(2 * B_);
+    bins_ = fft_.bins();
+    irRe_.assign((size_t)P_ * bins_, 0.f);
+    irIm_.assign((size_t)P_ * bins_, 0.f);
+    fdlRe_.assign((size_t)P_ * bins_, 0.f);
+    fdlIm_.assign((size_t)P_ * bins_, 0.f);
+    accRe_.assign((size_t)bins_, 0.f);
+    accIm_.assign((size_t)bins_, 0.f);
+    time_.assign((size_t)2 * B_, 0.f);
+    prev_.assign((size_t)B_, 0.f);
+    fdlPos_ = 0;
+
+    // куски IR, дополненные нулями до 2B
+    for (int p = 0; p < P_; ++p) {
+        std::fill(time_.begin(), time_.end(), 0.f);
+        const int n = std::min(B_, irLen - p * B_);
+        if (n > 0) std::copy(ir + (size_t)p * B_, ir + (size_t)p * B_ + n, time_.begin());
+        fft_.forward(time_.data(), irRe_.data() + (size_t)p * bins_, irIm_.data() + (size_t)p * bins_);
+    }
+}
+
+void UniformConvolver::reset() noexcept {
+    std::fill(fdlRe_.begin(), fdlRe_.end(), 0.f);
+    std::fill(fdlIm_.begin(), fdlIm_.end(), 0.f);
+    std::fill(prev_.begin(), prev_.end(), 0.f);
+    fdlPos_ = 0;
+}
+
+void UniformConvolver::process(const float* in, float* out) noexcept {
+    // overlap-save: [прошлый блок | текущий] → спектр в голову FDL
+    std::copy(prev_.begin(), prev_.end(), time_.begin());
+    std::copy(in, in + B_, time_.begin() + B_);
+    std::copy(in, in + B_, prev_.begin());
+    float* xRe = fdlRe_.data() + (size_t)fdlPos_ * bins_;
+    float* xIm = fdlIm_.data() + (size_t)fdlPos_ * bins_;
+    fft_.forward(time_.data(), xRe, xIm);
+
+    // acc = Σ_p X[i−p]·H[p] — комплексное умножение-накопление по 4 бина
+    std::fill(accRe_.begin(), accRe_.end(), 0.f);
+    std::fill(accIm_.begin(), accIm_.end(), 0.f);
+    float* aRe = accRe_.data();
+    float* aIm = accIm_.data();
+    const int vec = bins_ & ~3;
+    for (int p = 0; p < P_; ++p) {
+        const int slot = (fdlPos_ - p + P_) % P_;
+        const float* x_r = fdlRe_.data() + (size_t)slot * bins_;
+        const float* x_i = fdlIm_.data() + (size_t)slot * bins_;
+        const float* h_r = irRe_.data() + (size_t)p * bins_;
+        const float* h_i = irIm_.data() + (size_t)p * bins_;
+        int k = 0;
+        for (; k < vec; k += 4) {
+            const simd::f32x4 xr = simd::load4(x_r + k), xi = simd::load4(x_i + k);
+            const simd::f32x4 hr = simd::load4(h_r + k), hi = simd::load4(h_i + k);
+            simd::store4(aRe + k, simd::load4(aRe + k) + xr * hr - xi * hi);
+            simd::store4(aIm + k, simd::load4(aIm + k) + xr * hi + xi * hr);
+        }
+        for (; k < bins_; ++k) {
+            aRe[k] += x_r[k] * h_r[k] - x_i[k] * h_i[k];
+            aIm[k] += x_r[k] * h_i[k] + x_i[k] * h_r[k];
+        }
+    }
+    fdlPos_ = (fdlPos_ + 1) % P_;
+
+    fft_.inverse(aRe, aIm, time_.data());
+    std::copy(time_.begin() + B_, time_.end(), out);
+}
+
+// ---------------------------------------------------------------- ConvReverb
+
+namespace {
+
+const FxParamDesc kParams[] = {
+    {"mix",  "Mix",  FxParamType::Float, 0.f, 1.f, 0.35f, 0.f},
+    {"gain", "Gain", FxParamType::Float, 0.f, 4.f, 1.f,   0.f},
+};
+static_assert(std::size(kParams) == ConvReverb::kCount);
+
+// Хвостовые уровни: блок B, смещение в IR = 2·B (у следующего уровня — 2·B следующего)
+constexpr int kTailBlocks[] = {1024, 8192};
+constexpr int kLevels = (int)std::size(kTailBlocks);
+
+constexpr float kTrimDb = -96.f;                 // хвост IR тише — отрезаем
+
+enum JobState : int { kIdle, kPending, kRunning, kDone };
+
+// Канал IR во float (Int16-источник разворачиваем)
+std::vector<float> channelOf(const SampleBuffer& s, int ch) {
+    std::vector<float> v((size_t)s.frames);
+    if (s.format == SampleFormat::Int16) {
+        const int16_t* p = (ch == 1 && s.pcmR) ? s.pcmR.get() : s.pcmL.get();
+        simd::convertI16ToF32(p, v.data(), s.frames, 1.f / 32768.f);
+    } else {
+        const float* p = (ch == 1 && s.dataR) ? s.dataR.get() : s.dataL.get();
+        std::copy(p, p + s.frames, v.begin());
+    }
+    return v;
+}
+
+} // namespace
+
+struct ConvReverb::Level {
+    int B = 0;
+    UniformConvolver conv[2];
+    std::vector<float> acc[2];       // [B] вход текущего периода
+    std::vector<float> jobIn[2];     // [B] вход отданного задания
+    std::vector<float> out[2][2];    // [слот][канал] результат задания
+    int  fill = 0;
+    int  runSlot = 0;                // куда пишет отданное задание
+    int  readSlot = -1, readPos = 0; // что сейчас подмешиваем в выход
+    bool inFlight = false;           // аудио-сторона: задание отдано, результат ещё не забран
+    bool late = false;               // задание не успело к дедлайну — его результат не играем
+    bool dirty = false;              // reset() пришёлся на счёт фона — свёртки дочистить на дедлайне
+    std::atomic<int> state{kIdle};
+
+    void run() noexcept {
+        conv[0].process(jobIn[0].data(), out[runSlot][0].data());
+        conv[1].process(jobIn[1].data(), out[runSlot][1].data());
+    }
+
+    // RT: дедлайн задания — забрать готовое, досчитать невзятое. false — фон ещё считает:
+    // ждать его в аудиопотоке нельзя, задание остаётся в полёте до следующей границы
+    bool finish() noexcept {
+        int s = kPending;
+        if (state.compare_exchange_strong(s, kRunning, std::memory_order_acq_rel)) {
+            run();
+            s = kDone;
+        }
+        if (s != kDone) return false;
+        state.store(kIdle, std::memory_order_relaxed);
+        readSlot = runSlot;
+        readPos = 0;
+        inFlight = false;
+        return true;
+    }
+
+    // RT: чистое состояние. Задание, которое сейчас считает фон, не трогаем: его результат
+    // выбросится на дедлайне, там же дочистятся свёртки
+    void clear() noexcept {
+        int s = kPending;
+        state.compare_exchange_strong(s, kIdle, std::memory_order_acq_rel); // невзятое — отменяем
+        if (s == kRunning) {
+            late = dirty = true;
+        } else {
+            state.store(kIdle, std::memory_order_relaxed);
+            inFlight = late = false;
+            clearConv();
+        }
+        std::fill(acc[0].begin(), acc[0].end(), 0.f);
+        std::fill(acc[1].begin(), acc[1].end(), 0.f);
+        fill = 0;
+        readSlot = -1;
+        readPos = 0;
+    }
+
+    void clearConv() noexcept {
+        conv[0].reset();
+        conv[1].reset();
+        dirty = false;
+    }
+
+    // RT: отдать вход периода фону
+    void submit() noexcept {
+        jobIn[0].swap(acc[0]);       // swap буферов одинакового размера — без аллокаций
+        jobIn[1].swap(acc[1]);
+        runSlot = readSlot < 0 ? 0 : readSlot ^ 1;
+        inFlight = true;
+        state.store(kPending, std::memory_order_release);
+    }
+};
+
+struct ConvReverb::Kernel {
+    UniformConvolver head[2];
+    std::vector<std::unique_ptr<Level>> levels;
+};
+
+// Фоновый поток хвостов — один на процесс, пока жив хоть один ревер с уровнями.
+// Спит на ticket; аудио после отдачи заданий делает wake() (notify — системный вызов только
+// если поток действительно спит). Список экземпляров — под mu (регистрация НЕ RT, проход фона).
+struct ConvReverb::Pool {
+    std::mutex mu;
+    std::vector<ConvReverb*> users;
+    std::atomic<uint32_t> ticket{0};
+    std::atomic<bool> stop{false};
+    std::thread worker;
+
+    Pool() { worker = std::thread([this]{ loop(); }); }
+    ~Pool() {
+        stop.store(true, std::memory_order_release);
+        wake();
+        worker.join();
+    }
+
+    void wake() noexcept {
+        ticket.fetch_add(1, std::memory_order_release);
+        ticket.notify_one();
+    }
+
+    static std::shared_ptr<Pool> acquire() {
+        static std::mutex m;
+        static std::weak_ptr<Pool> shared;
+        std::lock_guard<std::mutex> lk(m);
+        auto p = shared.lock();
+        if (!p) { p = std::make_shared<Pool>(); shared = p; }
+        return p;
+    }
+
+    void loop() {
+        for (;;) {
+            // счётчик — ДО прохода: задание, отданное после проверки, сменит его, и wait() не уснёт
+            const uint32_t seen = ticket.load(std::memory_order_acquire);
+            if (stop.load(std::memory_order_acquire)) return;
+
+            std::shared_ptr<Kernel> k;       // держит ядро, пока считаем (setIr мог его подменить)
+            Level* job = nullptr;
+            {
+                std::lock_guard<std::mutex> lk(mu);
+                // мелкие уровни первыми: у них самый короткий дедлайн
+                for (int l = 0; !job && l < kLevels; ++l) {
+                    for (ConvReverb* u : users) {
+                        auto uk = std::atomic_load_explicit(&u->kernel_, std::memory_order_acquire);
+                        if (!uk || (size_t)l >= uk->levels.size()) continue;
+                        Level* lv = uk->levels[(size_t)l].get();
+                        int s = kPending;
+                        if (lv->state.compare_exchange_strong(s, kRunning, std::memory_order_acq_rel)) {
+                            k = std::move(uk);
+                            job = lv;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (!job) { ticket.wait(seen, std::memory_order_acquire); continue; }
+            job->run();
+            job->state.store(kDone, std::memory_order_release);
+        }
+    }
+};
+
+ConvReverb::ConvReverb() : FxBase(kParams) {}
+
+ConvReverb::~ConvReverb() {
+    if (!pool_) return;
+    std::lock_guard<std::mutex> lk(pool_->mu);
+    auto& u = pool_->users;
+    u.erase(std::remove(u.begin(), u.end(), this), u.end());
+}
+
+void ConvReverb::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    if (irSr_ != sr_) { convertIr(); rebuild(); } // ядро от размера блока хоста не зависит — только SR
+    reset();
+}
+
+void ConvReverb::reset() {
+    std::fill(std::begin(inL_), std::end(inL_), 0.f);
+    std::fill(std::begin(inR_), std::end(inR_), 0.f);
+    std::fill(std::begin(outL_), std::end(outL_), 0.f);
+    std::fill(std::begin(outR_), std::end(outR_), 0.f);
+    fifoPos_ = 0;
+    const auto k = std::atomic_load_explicit(&kernel_, std::memory_order_acquire);
+    if (!k) return;
+    k->head[0].reset();
+    k->head[1].reset();
+    for (auto& lv : k->levels) lv->clear();
+}
+
+bool ConvReverb::loadIr(const std::string& path) {
+    auto sb = LoadWavToSampleBuffer(path, false);
+    return sb && setIr(std::move(sb));
+}
+
+bool ConvReverb::setIr(SampleBufferPtr ir) {
+    if (!ir || !ir->hasData() || ir->frames <= 0) return false;
+    ir_ = std::move(ir);
+    convertIr();
+    rebuild();
+    return true;
+}
+
+void ConvReverb::convertIr() {
+    irSr_ = sr_;
+    irCh_[0].clear();
+    irCh_[1].clear();
+    if (!ir_) return;
+    SampleBufferPtr src = ResampleSampleBuffer(ir_, sr_);
+    if (!src) return;
+
+    auto& ch = irCh_;
+    ch[0] = channelOf(*src, 0);
+    ch[1] = channelOf(*src, src->stereo() ? 1 : 0);
+
+    // обрезаем тишину в конце и нормируем по энергии: белый шум на входе → тот же RMS на выходе
+    const float thr = std::pow(10.f, kTrimDb / 20.f);
+    int len = 0;
+    double energy = 0.0;
+    for (int c = 0; c < 2; ++c) {
+        for (int i = (int)ch[c].size() - 1; i >= len; --i) if (std::fabs(ch[c][(size_t)i]) > thr) { len = i + 1; break; }
+        for (float v : ch[c]) energy += (double)v * v;
+    }
+    const float norm = energy > 0.0 ? (float)(1.0 / std::sqrt(energy / 2.0)) : 1.f;
+    for (auto& v : ch) { v.resize((size_t)len); for (float& x : v) x *= norm; }
+}
+
+void ConvReverb::rebuild() {
+    auto& ch = irCh_;
+    const int len = (int)ch[0].size();
+    if (len == 0) return;
+
+    auto k = std::make_shared<Kernel>();
+    const int headLen = std::min(len, 2 * kTailBlocks[0]);
+    for (int c = 0; c < 2; ++c) k->head[c].init(ch[c].data(), headLen, kHeadBlock);
+
+    for (int l = 0; l < kLevels; ++l) {
+        const int B = kTailBlocks[l];
+        const int from = 2 * B;
+        const int to = l + 1 < kLevels ? std::min(len, 2 * kTailBlocks[l + 1]) : len;
+        if (from >= to) break;
+        auto lv = std::make_unique<Level>();
+        lv->B = B;
+        for (int c = 0; c < 2; ++c) {
+            lv->conv[c].init(ch[c].data() + from, to - from, B);
+            lv->acc[c].assign((size_t)B, 0.f);
+            lv->jobIn[c].assign((size_t)B, 0.f);
+            lv->out[0][c].assign((size_t)B, 0.f);
+            lv->out[1][c].assign((size_t)B, 0.f);
+        }
+        k->levels.push_back(std::move(lv));
+    }
+
+    if (!k->levels.empty() && !pool_) { // пул — до публикации ядра: аудио будит его, увидев уровни
+        pool_ = Pool::acquire();
+        std::lock_guard<std::mutex> lk(pool_->mu);
+        pool_->users.push_back(this);
+    }
+    // прошлое ядро живёт до следующей подмены: аудиопоток мог взять на него ссылку
+    prevKernel_ = std::atomic_load_explicit(&kernel_, std::memory_order_acquire);
+    std::atomic_store_explicit(&kernel_, k, std::memory_order_release);
+    hasIr_.store(true, std::memory_order_relaxed);
+}
+
+bool ConvReverb::processBlock(Kernel& k) noexcept {
+    k.head[0].process(inL_, outL_);
+    k.head[1].process(inR_, outR_);
+    bool submitted = false;
+
+    for (auto& lvp : k.levels) {
+        Level& lv = *lvp;
+        if (lv.readSlot >= 0) {
+            const float* tl = lv.out[lv.readSlot][0].data() + lv.readPos;
+            const float* tr = lv.out[lv.readSlot][1].data() + lv.readPos;
+            for (int i = 0; i < kHeadBlock; ++i) { outL_[i] += tl[i]; outR_[i] += tr[i]; }
+            lv.readPos += kHeadBlock;
+        }
+        std::copy(inL_, inL_ + kHeadBlock, lv.acc[0].begin() + lv.fill);
+        std::copy(inR_, inR_ + kHeadBlock, lv.acc[1].begin() + lv.fill);
+        lv.fill += kHeadBlock;
+        if (lv.fill == lv.B) { // граница периода: дедлайн прошлого задания, затем новое
+            lv.fill = 0;
+            lv.readSlot = -1;
+            lv.readPos = 0;
+            if (lv.inFlight && !lv.finish()) { lv.late = true; continue; } // фон опоздал — период уровня теряется
+            if (lv.late) { lv.readSlot = -1; lv.late = false; }          // опоздавший результат не играем
+            if (lv.dirty) lv.clearConv();
+            lv.submit();
+            submitted = true;
+        }
+    }
+    return submitted;
+}
+
+void ConvReverb::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0) return;
+    const auto k = std::atomic_load_explicit(&kernel_, std::memory_order_acquire);
+    if (!k) return; // IR нет — насквозь
+
+    const ParamSmoother& mix = smoothed(kMix, nframes);
+    const ParamSmoother& gain = smoothed(kGain, nframes);
+    for (int i = 0; i < nframes; ++i) {
+        // сухой тоже задержан на блок — эффект целиком имеет латентность kHeadBlock
+        const float dl = inL_[fifoPos_], dr = inR_[fifoPos_];
+        const float g = gain.at(i), m = mix.at(i);
+        const float wl = outL_[fifoPos_] * g, wr = outR_[fifoPos_] * g;
+        inL_[fifoPos_] = L[i];
+        inR_[fifoPos_] = R[i];
+        L[i] = dl + m * (wl - dl);
+        R[i] = dr + m * (wr - dr);
+        if (++fifoPos_ == kHeadBlock) {
+            fifoPos_ = 0;
+            if (processBlock(*k) && pool_) pool_->wake();
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "devices/SamplerNode.h"
+#include "fx/FxBase.h"
+#include "utils/Fft.h"
+
+// Равномерно-разбитая свёртка (uniformly partitioned overlap-save, UPOLS) одного канала.
+// IR режется на P кусков по B; вход — блоками по B: FFT(2B) → в частотную линию задержки (FDL),
+// выход = IFFT(Σ X[i−p]·H[p]), последние B отсчётов. init() — НЕ RT; process() — RT.
+class UniformConvolver {
+public:
+    void init(const float* ir, int irLen, int blockSize);
+    void reset() noexcept;
+    void process(const float* in, float* out) noexcept;   // B входных → B выходных (перезапись)
+    int  blockSize() const { return B_; }
+
+private:
+    int B_ = 0, P_ = 0, bins_ = 0, fdlPos_ = 0;
+    RealFft fft_;
+    std::vector<float> irRe_, irIm_;    // [P × bins] спектры кусков IR
+    std::vector<float> fdlRe_, fdlIm_;  // [P × bins] спектры последних P входных блоков (кольцо)
+    std::vector<float> accRe_, accIm_;  // [bins]
+    std::vector<float> time_;           // [2B] вход (прошлый|текущий), затем выход IFFT
+    std::vector<float> prev_;           // [B]
+};
+
+// Свёрточный ревер на IR в несколько секунд (стерео: L⊛IR.L, R⊛IR.R; моно IR — на оба канала).
+// Неравномерное разбиение: голова B = kHeadBlock (латентность 64) считается в аудиопотоке,
+// хвост — уровни с блоками 1024 и 8192 (смещения 2·B) на фоновом потоке, ОДНОМ на все экземпляры
+// (спит на счётчике заданий, аудио будит его после отдачи задания).
+// Уровень с блоком B получает вход на границе периода и должен вернуть результат через B отсчётов:
+//   граница j: дедлайн задания j−1 (готово? — забираем; ещё в очереди — считаем сами; фон ещё
+//              считает — не ждём: уровень молчит этот период, опоздавший результат выбрасывается),
+//              затем отдаём задание j (вход уровня за период) фону.
+// reset() — RT (чистит состояние ядра на месте); новое ядро строят только setIr/prepare со сменой SR.
+// IR грузится через сэмпл-пайплайн (WavLoader + Resampler под SR движка); ядро свёртки строится
+// вне аудиопотока и подменяется атомарно.
+class ConvReverb final : public FxBase {
+public:
+    static constexpr int kHeadBlock = 64;
+    static constexpr const char* kDefaultIr = "assets/ir/default.wav"; // IR для CmdAddFx{"convolution"}
+    enum Param { kMix, kGain, kCount };
+
+    ConvReverb();
+    ~ConvReverb() override;
+
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+    int  latencySamples() const override { return hasIr_.load(std::memory_order_relaxed) ? kHeadBlock : 0; }
+
+    // НЕ RT. IR из WAV (путь) или готовый буфер; пересобирает ядро под текущий SR.
+    bool loadIr(const std::string& path);
+    bool setIr(SampleBufferPtr ir);
+
+private:
+    struct Kernel;
+    struct Level;
+    struct Pool;
+
+    void convertIr();                     // НЕ RT: ir_ → irCh_ (SR движка, обрезка тишины, нормировка)
+    void rebuild();                       // НЕ RT: новое ядро (чистое состояние) из irCh_
+    bool processBlock(Kernel& k) noexcept; // один блок kHeadBlock из inL_/inR_ → outL_/outR_; true — отданы задания
+
+    SampleBufferPtr ir_;                  // исходный IR (как загружен)
+    std::vector<float> irCh_[2];          // IR под sr_, готовый к разбиению
+    int irSr_ = 0;
+    std::shared_ptr<Kernel> kernel_;      // через atomic_load/atomic_store
+    std::shared_ptr<Kernel> prevKernel_;  // держим прошлое ядро до следующей подмены — не освобождать в RT
+    std::atomic<bool> hasIr_{false};      // ядро есть — эффект задерживает на kHeadBlock
+
+    // FIFO на kHeadBlock: вход копится, выход отдаётся с задержкой блока
+    float inL_[kHeadBlock]{}, inR_[kHeadBlock]{};
+    float outL_[kHeadBlock]{}, outR_[kHeadBlock]{};
+    int   fifoPos_ = 0;
+
+    std::shared_ptr<Pool> pool_;          // общий фоновый поток хвостов (с первого ядра с уровнями)
+};
@@ -0,0 +1,329 @@
+#include "fx/Dynamics.h"
+#include "utils/FastMath.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+const FxParamDesc kLimiterParams[] = {
+    {"input",   "Input",   FxParamType::Float, 0.f,   24.f,   0.f,   0.f},  // дБ до детектора
+    {"ceiling", "Ceiling", FxParamType::Float, -12.f, 0.f,    -1.f,  0.f},  // дБTP
+    {"release", "Release", FxParamType::Float, 10.f,  1000.f, 100.f, 0.f},  // мс
+};
+static_assert(std::size(kLimiterParams) == Limiter::kCount);
+
+const FxParamDesc kCompParams[] = {
+    {"threshold", "Threshold", FxParamType::Float, -40.f, 0.f,    -10.f, 0.f},  // дБ
+    {"ratio",     "Ratio",     FxParamType::Float, 1.f,   20.f,   2.f,   0.f},
+    {"attack",    "Attack",    FxParamType::Float, 0.1f,  100.f,  10.f,  0.f},  // мс
+    {"release",   "Release",   FxParamType::Float, 10.f,  2000.f, 150.f, 0.f},  // мс
+    {"knee",      "Knee",      FxParamType::Float, 0.f,   24.f,   6.f,   0.f},  // дБ
+    {"makeup",    "Makeup",    FxParamType::Float, 0.f,   24.f,   0.f,   0.f},  // дБ
+    {"mix",       "Mix",       FxParamType::Float, 0.f,   1.f,    1.f,   0.f},
+};
+static_assert(std::size(kCompParams) == BusCompressor::kCount);
+
+constexpr float kDbPerLog2 = 6.02059991f; // 20·log10(2)
+constexpr float kFloor     = 1e-9f;
+
+int pow2AtLeast(int n) noexcept {
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+inline float dbToGain(float db) noexcept { return std::pow(10.f, db / 20.f); }
+inline float timeA(float ms, int sr) noexcept { return 1.f - std::exp(-1000.f / (std::max(ms, 0.01f) * (float)sr)); }
+
+// Интерполятор true peak: фаза p — значение в точке (i − kTpDelay + p/4) по x[i−k], k = 0..7.
+// Ядро — sinc с окном Ханна; фаза 0 — чистая задержка. Лейны: [L: ф0..ф3 | R: ф0..ф3].
+struct TpKernel {
+    simd::f32x8 col[Limiter::kTpTaps];
+    TpKernel() {
+        for (int k = 0; k < Limiter::kTpTaps; ++k) {
+            for (int p = 0; p < 4; ++p) {
+                const double u = (double)(k - Limiter::kTpDelay) + 0.25 * p;
+                const double s = u == 0.0 ? 1.0 : std::sin(M_PI * u) / (M_PI * u);
+                const double w = 0.5 * (1.0 + std::cos(M_PI * u / (Limiter::kTpDelay + 0.5)));
+                col[k][p] = col[k][4 + p] = (float)(s * w);
+            }
+        }
+    }
+};
+const TpKernel kTp;
+
+} // namespace
+
+// ---------------- SlidingMax ----------------
+
+void SlidingMax::init(int window) {
+    window_ = std::max(window, 1);
+    const int cap = pow2AtLeast(window_ + 1);
+    val_.assign((size_t)cap, 0.f);
+    at_.assign((size_t)cap, 0u);
+    mask_ = cap - 1;
+    reset();
+}
+
+void SlidingMax::reset() noexcept {
+    head_ = tail_ = 0;
+    now_ = 0;
+}
+
+void SlidingMax::process(const float* x, float* out, int n) noexcept {
+    const uint32_t w = (uint32_t)window_;
+    for (int i = 0; i < n; ++i, ++now_) {
+        const float v = x[i];
+        // с хвоста выбрасываем всё, что не больше нового: они уже никогда не станут максимумом
+        while (tail_ != head_ && val_[(size_t)((tail_ - 1) & mask_)] <= v) tail_ = (tail_ - 1) & mask_;
+        val_[(size_t)tail_] = v;
+        at_[(size_t)tail_] = now_;
+        tail_ = (tail_ + 1) & mask_;
+        // голова вышла из окна
+        if (now_ - at_[(size_t)head_] >= w) head_ = (head_ + 1) & mask_;
+        out[i] = val_[(size_t)head_];
+    }
+}
+
+// ---------------- LookaheadDelay ----------------
+
+void LookaheadDelay::init(int delay, int maxBlock) {
+    delay_ = std::max(delay, 0);
+    for (auto& b : buf_) b.assign((size_t)(delay_ + maxBlock + 8), 0.f);
+}
+
+void LookaheadDelay::reset() noexcept {
+    for (auto& b : buf_) std::fill(b.begin(), b.end(), 0.f);
+}
+
+float* LookaheadDelay::write(int ch, const float* in, int n) noexcept {
+    float* b = buf_[ch].data();
+    std::copy(in, in + n, b + delay_);
+    return b;
+}
+
+void LookaheadDelay::commit(int n) noexcept {
+    for (auto& b : buf_) std::copy(b.begin() + n, b.begin() + n + delay_, b.begin());
+}
+
+// ---------------- Limiter ----------------
+
+Limiter::Limiter() : FxBase(kLimiterParams) {}
+
+void Limiter::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    lookahead_ = std::max(1, (int)std::lround(kLookaheadMs * 0.001f * (float)sr_));
+    peak_.init(lookahead_ + 1);
+    delay_.init(lookahead_ + kTpDelay, bs_);
+    det_.assign((size_t)(bs_ + 8), 0.f);
+    hL_.assign((size_t)(kTpTaps - 1 + bs_), 0.f);
+    hR_.assign((size_t)(kTpTaps - 1 + bs_), 0.f);
+    box_.assign((size_t)lookahead_, 1.f);
+    reset();
+}
+
+void Limiter::reset() {
+    peak_.reset();
+    delay_.reset();
+    std::fill(hL_.begin(), hL_.end(), 0.f);
+    std::fill(hR_.begin(), hR_.end(), 0.f);
+    std::fill(box_.begin(), box_.end(), 1.f);
+    boxSum_ = (double)box_.size();
+    boxPos_ = 0;
+    gain_ = 1.f;
+    quiet_ = 0;
+    idle_ = false;
+    grDb_.store(0.f, std::memory_order_relaxed);
+}
+
+void Limiter::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0 || det_.empty()) return;
+    for (int off = 0; off < nframes; off += bs_) processChunk(L + off, R + off, std::min(bs_, nframes - off));
+}
+
+void Limiter::processChunk(float* L, float* R, int n) noexcept {
+    // вход молчит, а через задержку и историю интерполятора уже прошло не меньше их длины
+    // тишины (quiet_ — сэмплы, реально обработанные) — на выходе и так нули
+    float inPeak = 0.f;
+    for (int i = 0; i < n; ++i) inPeak = std::max(inPeak, std::max(std::fabs(L[i]), std::fabs(R[i])));
+    if (inPeak == 0.f && quiet_ >= latencySamples() + kTpTaps) {
+        if (!idle_) { // вход в простой: состояние — как после reset(), release «досрочно» (скачка не слышно)
+            peak_.reset();
+            delay_.reset();
+            std::fill(hL_.begin(), hL_.end(), 0.f);
+            std::fill(hR_.begin(), hR_.end(), 0.f);
+            std::fill(box_.begin(), box_.end(), 1.f);
+            boxSum_ = (double)box_.size();
+            boxPos_ = 0;
+            gain_ = 1.f;
+            idle_ = true;
+        }
+        grDb_.store(0.f, std::memory_order_relaxed);
+        return;
+    }
+    quiet_ = inPeak == 0.f ? quiet_ + n : 0;
+    idle_ = false;
+
+    const float inG = dbToGain(value(kInput));
+    const float ceiling = dbToGain(value(kCeiling));
+    const float relA = timeA(value(kRelease), sr_);
+
+    // 1) вход (с input gain) в историю интерполятора; true peak стерео-связкой
+    constexpr int h = kTpTaps - 1;
+    for (int i = 0; i < n; ++i) { hL_[(size_t)(h + i)] = L[i] * inG; hR_[(size_t)(h + i)] = R[i] * inG; }
+    float* det = det_.data();
+    for (int i = 0; i < n; ++i) {
+        simd::f32x8 acc{};
+        for (int k = 0; k < kTpTaps; ++k) {
+            const float l = hL_[(size_t)(h + i - k)], r = hR_[(size_t)(h + i - k)];
+            acc += kTp.col[k] * simd::f32x8{l, l, l, l, r, r, r, r};
+        }
+        simd::abs(acc, acc);
+        det[i] = simd::hmax(acc);
+    }
+
+    // 2) пик по окну look-ahead → требуемое усиление (векторно)
+    peak_.process(det, det, n);
+    const simd::f32x4 one = simd::splat4(1.f), c = simd::splat4(ceiling), fl = simd::splat4(kFloor);
+    for (int i = 0; i < n; i += 4)
+        simd::store4(det + i, simd::min(one, c / simd::max(simd::load4(det + i), fl)));
+
+    // 3) усреднение окном (атака ровно за look-ahead) + release
+    const int len = (int)box_.size();
+    const double inv = 1.0 / (double)len;
+    float g = gain_, gMin = 1.f;
+    for (int i = 0; i < n; ++i) {
+        boxSum_ += (double)det[i] - (double)box_[(size_t)boxPos_];
+        box_[(size_t)boxPos_] = det[i];
+        if (++boxPos_ == len) boxPos_ = 0;
+        const float gb = (float)(boxSum_ * inv);
+        g = gb < g ? gb : g + (gb - g) * relA;
+        det[i] = g;
+        gMin = std::min(gMin, g);
+    }
+    gain_ = g;
+    grDb_.store(20.f * std::log10(std::max(gMin, kFloor)), std::memory_order_relaxed);
+
+    // 4) задержанный сигнал × усиление
+    const float* dL = delay_.write(0, hL_.data() + h, n);
+    const float* dR = delay_.write(1, hR_.data() + h, n);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const simd::f32x4 gv = simd::load4(det + i);
+        simd::store4(L + i, simd::load4(dL + i) * gv);
+        simd::store4(R + i, simd::load4(dR + i) * gv);
+    }
+    for (; i < n; ++i) { L[i] = dL[i] * det[i]; R[i] = dR[i] * det[i]; }
+    delay_.commit(n);
+    std::copy(hL_.begin() + n, hL_.begin() + n + h, hL_.begin());
+    std::copy(hR_.begin() + n, hR_.begin() + n + h, hR_.begin());
+}
+
+// ---------------- BusCompressor ----------------
+
+BusCompressor::BusCompressor() : FxBase(kCompParams) {}
+
+void BusCompressor::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    const int la = std::max(1, (int)std::lround(kLookaheadMs * 0.001f * (float)sr_));
+    peak_.init(la + 1);
+    delay_.init(la, bs_);
+    det_.assign((size_t)(bs_ + 8), 0.f);
+    reset();
+}
+
+void BusCompressor::reset() {
+    peak_.reset();
+    delay_.reset();
+    grState_ = 0.f;
+    quiet_ = 0;
+    idle_ = false;
+    grDb_.store(0.f, std::memory_order_relaxed);
+}
+
+void BusCompressor::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0 || det_.empty()) return;
+    for (int off = 0; off < nframes; off += bs_) processChunk(L + off, R + off, std::min(bs_, nframes - off));
+}
+
+void BusCompressor::processChunk(float* L, float* R, int n) noexcept {
+    const ParamSmoother& makeup = smoothed(kMakeup, n); // рампы идут и в простое — без скачка на возобновлении
+    const ParamSmoother& mix = smoothed(kMix, n);
+
+    // 1) пиковая огибающая (стерео-связка)
+    float* det = det_.data();
+    float inPeak = 0.f;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const simd::f32x4 p = simd::max(simd::abs(simd::load4(L + i)), simd::abs(simd::load4(R + i)));
+        simd::store4(det + i, p);
+        inPeak = std::max(inPeak, simd::hmax(p));
+    }
+    for (; i < n; ++i) { det[i] = std::max(std::fabs(L[i]), std::fabs(R[i])); inPeak = std::max(inPeak, det[i]); }
+    if (inPeak == 0.f && quiet_ >= latencySamples()) { // через задержку прошла тишина: на выходе нули
+        if (!idle_) { peak_.reset(); delay_.reset(); idle_ = true; }
+        grState_ = 0.f;                                     // GR восстанавливаем сразу
+        grDb_.store(0.f, std::memory_order_relaxed);
+        return;
+    }
+    quiet_ = inPeak == 0.f ? quiet_ + n : 0;
+    idle_ = false;
+
+    const float thr = value(kThreshold);
+    const float slope = 1.f / value(kRatio) - 1.f;
+    const float knee = std::max(value(kKnee), 1e-3f);
+    const float aA = timeA(value(kAttack), sr_), aR = timeA(value(kRelease), sr_);
+
+    // 2) окно look-ahead → кривая с мягким коленом (дБ, векторно)
+    peak_.process(det, det, n);
+    {
+        const simd::f32x4 t = simd::splat4(thr), s = simd::splat4(slope);
+        const simd::f32x4 w = simd::splat4(knee), hw = simd::splat4(0.5f * knee), k2 = simd::splat4(0.5f / knee);
+        const simd::f32x4 zero{}, dbk = simd::splat4(kDbPerLog2), fl = simd::splat4(kFloor);
+        for (int j = 0; j < n; j += 4) {
+            const simd::f32x4 lvl = dbk * fastmath::log2(simd::max(simd::load4(det + j), fl));
+            const simd::f32x4 over = lvl - t;
+            const simd::f32x4 o2 = over + over;
+            const simd::f32x4 inKnee = s * (over + hw) * (over + hw) * k2;
+            simd::store4(det + j, simd::select(o2 <= -w, zero, simd::select(o2 >= w, s * over, inKnee)));
+        }
+    }
+
+    // 3) атака/восстановление по сэмплу (дБ)
+    float st = grState_, grMin = 0.f;
+    for (int j = 0; j < n; ++j) {
+        const float gr = det[j];
+        st += (gr < st ? aA : aR) * (gr - st);
+        det[j] = st;
+        grMin = std::min(grMin, st);
+    }
+    grState_ = st > -1e-6f ? 0.f : st;
+    grDb_.store(grMin, std::memory_order_relaxed);
+
+    // 4) усиление (makeup в дБ-области, exp2 векторно), параллельный mix по задержанному сигналу
+    const float* dL = delay_.write(0, L, n);
+    const float* dR = delay_.write(1, R, n);
+    {
+        // makeup/mix — рампы блока: at(j) = start + step·(j + 1), по 4 сэмпла за шаг
+        const simd::f32x4 inv = simd::splat4(1.f / kDbPerLog2), one = simd::splat4(1.f);
+        const simd::f32x4 lane{1.f, 2.f, 3.f, 4.f};
+        simd::f32x4 mk = simd::splat4(makeup.start()) + simd::splat4(makeup.step()) * lane;
+        simd::f32x4 wet = simd::splat4(mix.start()) + simd::splat4(mix.step()) * lane;
+        const simd::f32x4 dMk = simd::splat4(4.f * makeup.step()), dWet = simd::splat4(4.f * mix.step());
+        for (int j = 0; j < n; j += 4, mk += dMk, wet += dWet) {
+            const simd::f32x4 g = (one - wet) + wet * fastmath::exp2((simd::load4(det + j) + mk) * inv);
+            simd::store4(det + j, g);
+        }
+    }
+    for (i = 0; i + 4 <= n; i += 4) {
+        const simd::f32x4 g = simd::load4(det + i);
+        simd::store4(L + i, simd::load4(dL + i) * g);
+        simd::store4(R + i, simd::load4(dR + i) * g);
+    }
+    for (; i < n; ++i) { L[i] = dL[i] * det[i]; R[i] = dR[i] * det[i]; }
+    delay_.commit(n);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "fx/FxBase.h"
+
+// Максимум по скользящему окну (монотонная дека на кольце 2^k): out[i] = max(x[i−window+1..i]).
+// Амортизированно O(1) на сэмпл независимо от окна. init() — НЕ RT; process() — RT, in-place допустим.
+class SlidingMax {
+public:
+    void init(int window);
+    void reset() noexcept;
+    void process(const float* x, float* out, int n) noexcept;
+
+private:
+    std::vector<float>    val_;
+    std::vector<uint32_t> at_;   // «время» сэмпла (по модулю 2^32)
+    uint32_t now_ = 0;
+    int mask_ = 0, head_ = 0, tail_ = 0, window_ = 1;
+};
+
+// Задержка «история + блок» для look-ahead: write() даёт буфер [история | n новых], первые n — задержанные.
+class LookaheadDelay {
+public:
+    void init(int delay, int maxBlock);  // НЕ RT
+    void reset() noexcept;
+    float* write(int ch, const float* in, int n) noexcept; // RT: возвращает задержанные n сэмплов канала
+    void   commit(int n) noexcept;                          // RT: сдвиг истории обоих каналов на n
+    int    delay() const { return delay_; }
+
+private:
+    std::vector<float> buf_[2];
+    int delay_ = 0;
+};
+
+// Look-ahead лимитер по true peak (ITU-R BS.1770: 4× полифазная интерполяция межсэмпловых пиков).
+//  - детектор: стерео-связка, 4 фазы × 2 канала = один f32x8 на сэмпл; окно — SlidingMax;
+//  - требуемое усиление min(1, ceiling/peak) усредняется окном той же длины (плавная атака,
+//    гарантированно ≤ требуемого на пике), затем — экспоненциальный release;
+//  - латентность = look-ahead + 4 сэмпла интерполятора (latencySamples());
+//  - 4× недооценивает пики у самого Найквиста (до ~0.7 дБ, как и BS.1770) — ceiling с запасом.
+// RT: process() без аллокаций; тишина → ранний выход. blockSize в prepare() — максимальный блок:
+// короче — как есть, длиннее — по кускам; переготавливать (prepare в аудиопотоке) не нужно.
+class Limiter final : public FxBase {
+public:
+    static constexpr float kLookaheadMs = 1.5f;
+    static constexpr int   kTpTaps = 8;            // отводов на фазу интерполятора
+    static constexpr int   kTpDelay = kTpTaps / 2; // задержка детектора, сэмплы
+    enum Param { kInput, kCeiling, kRelease, kCount };
+
+    Limiter();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+    int  latencySamples() const override { return delay_.delay(); }
+
+    float reductionDb() const { return grDb_.load(std::memory_order_relaxed); } // для метра, любой поток
+
+private:
+    void processChunk(float* L, float* R, int n) noexcept;
+
+    int lookahead_ = 0;
+    SlidingMax peak_;
+    LookaheadDelay delay_;
+    std::vector<float> det_, hL_, hR_;  // детектор; входы интерполятора [история kTpTaps−1 | блок]
+    std::vector<float> box_;            // кольцо усреднения усиления (lookahead_)
+    double boxSum_ = 0.0;
+    int    boxPos_ = 0;
+    float  gain_ = 1.f;                 // после release
+    int    quiet_ = 0;                  // подряд обработанных тихих сэмплов входа
+    bool   idle_ = false;               // простой: состояние сброшено, processChunk сразу выходит
+    std::atomic<float> grDb_{0.f};
+};
+
+// Шинный компрессор: пиковый детектор со скользящим окном (= look-ahead), мягкое колено,
+// атака/восстановление в дБ-области, makeup, параллельный mix.
+// Кривая и перевод дБ ↔ усиление — векторно (fastmath log2/exp2 по 4 сэмпла), сглаживание — по сэмплу.
+// RT и размер блока — как у Limiter.
+class BusCompressor final : public FxBase {
+public:
+    static constexpr float kLookaheadMs = 2.f;
+    enum Param { kThreshold, kRatio, kAttack, kRelease, kKnee, kMakeup, kMix, kCount };
+
+    BusCompressor();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+    int  latencySamples() const override { return delay_.delay(); }
+
+    float reductionDb() const { return grDb_.load(std::memory_order_relaxed); }
+
+private:
+    void processChunk(float* L, float* R, int n) noexcept;
+
+    SlidingMax peak_;
+    LookaheadDelay delay_;
+    std::vector<float> det_;           // огибающая → требуемое GR (дБ) → усиление
+    float  grState_ = 0.f;             // сглаженное GR, дБ (≤ 0)
+    int    quiet_ = 0;                 // подряд обработанных тихих сэмплов входа
+    bool   idle_ = false;              // простой: задержка и детектор сброшены
+    std::atomic<float> grDb_{0.f};
+};
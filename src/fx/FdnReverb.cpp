@@ -0,0 +1,190 @@
+#include "fx/FdnReverb.h"
+#include "utils/FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+const FxParamDesc kParams[] = {
+    {"size",      "Size",      FxParamType::Float, 0.f,    1.f,     0.6f,   0.f},
+    {"decay",     "Decay",     FxParamType::Float, 0.2f,   20.f,    2.5f,   0.f},  // RT60, с
+    {"damp",      "Damp",      FxParamType::Float, 1000.f, 20000.f, 7000.f, 0.f},  // срез в петле, Гц
+    {"predelay",  "Pre-delay", FxParamType::Float, 0.f,    250.f,   10.f,   0.f},  // мс
+    {"mod.depth", "Mod depth", FxParamType::Float, 0.f,    1.f,     0.3f,   0.f},
+    {"mod.rate",  "Mod rate",  FxParamType::Float, 0.05f,  5.f,     0.6f,   0.f},  // Гц
+    {"width",     "Width",     FxParamType::Float, 0.f,    1.f,     1.f,    0.f},
+    {"mix",       "Mix",       FxParamType::Float, 0.f,    1.f,     1.f,    0.f},  // 1 — return-бас (только wet)
+};
+static_assert(std::size(kParams) == FdnReverb::kCount);
+
+// Длины линий при 48 кГц и size = 1 (взаимно простые, ~40–77 мс)
+constexpr float kBaseLen[FdnReverb::kLines] = {1931.f, 2213.f, 2437.f, 2659.f, 2927.f, 3181.f, 3413.f, 3697.f};
+constexpr float kMinScale   = 0.35f;   // size = 0
+constexpr float kMaxScale   = 1.6f;    // size = 1
+constexpr float kMaxModSmp  = 12.f;    // глубина модуляции при 48 кГц, сэмплы
+constexpr float kMaxSlew    = 0.05f;   // макс. изменение длины на сэмпл (плавный size без щелчков)
+constexpr float kMaxPreMs   = 250.f;
+constexpr float kSleepEps   = 1e-6f;
+
+// Векторы входа/выхода: ортогональные знаковые шаблоны — L и R декоррелированы
+const simd::f32x8 kInSign  = { 1.f, -1.f,  1.f, -1.f,  1.f, -1.f,  1.f, -1.f};
+const simd::f32x8 kOutL    = { 1.f,  1.f, -1.f, -1.f,  1.f,  1.f, -1.f, -1.f};
+const simd::f32x8 kOutR    = { 1.f, -1.f, -1.f,  1.f,  1.f, -1.f, -1.f,  1.f};
+constexpr float   kOutGain = 0.35f;
+
+int pow2AtLeast(int n) noexcept {
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+FdnReverb::FdnReverb() : FxBase(kParams) {}
+
+void FdnReverb::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+
+    const float k = (float)sr_ / 48000.f;
+    // отвод d = len + depth·(1 + sin) доходит до len + 2·depth, плюс соседний сэмпл интерполяции
+    const int maxLen = (int)std::ceil(kBaseLen[kLines - 1] * kMaxScale * k + 2.f * kMaxModSmp * k) + 4;
+    const int frames = pow2AtLeast(maxLen);
+    lines_.assign((size_t)frames * kLines, 0.f);
+    lineMask_ = frames - 1;
+
+    const int preFrames = pow2AtLeast((int)std::ceil(kMaxPreMs * 0.001f * (float)sr_) + 1);
+    pre_.assign((size_t)preFrames, 0.f);
+    preMask_ = preFrames - 1;
+
+    reset();
+}
+
+void FdnReverb::reset() {
+    std::fill(lines_.begin(), lines_.end(), 0.f);
+    std::fill(pre_.begin(), pre_.end(), 0.f);
+    writePos_ = preWrite_ = 0;
+    lp_ = simd::f32x8{};
+    for (int i = 0; i < kLines; ++i) { // фазы LFO разнесены по кругу
+        const float ph = fastmath::kTwoPi * (float)i / (float)kLines;
+        lfoS_[i] = std::sin(ph);
+        lfoC_[i] = std::cos(ph);
+    }
+    asleep_ = true;
+    primed_ = false;
+    quiet_ = 0;
+}
+
+void FdnReverb::updateTargets(int nframes) noexcept {
+    const float k = (float)sr_ / 48000.f;
+    const float scale = kMinScale + (kMaxScale - kMinScale) * value(kSize);
+    const float rt60 = value(kDecay);
+
+    simd::f32x8 target;
+    for (int i = 0; i < kLines; ++i) target[i] = kBaseLen[i] * scale * k;
+    if (!primed_) { len_ = target; primed_ = true; }
+
+    // длина ползёт к цели не быстрее kMaxSlew сэмпла на сэмпл — size «тянет» высоту, но не щёлкает
+    simd::f32x8 lim, d;
+    simd::splat8(lim, kMaxSlew * (float)nframes);
+    simd::max(d, target - len_, -lim);
+    simd::min(d, d, lim);
+    lenStep_ = d * (1.f / (float)nframes);
+
+    // RT60 по длине в конце блока
+    const simd::f32x8 endLen = len_ + d;
+    for (int i = 0; i < kLines; ++i) fb_[i] = std::pow(10.f, -3.f * endLen[i] / (rt60 * (float)sr_));
+
+    dampA_ = 1.f - std::exp(-fastmath::kTwoPi * std::min(value(kDamp), 0.45f * (float)sr_) / (float)sr_);
+    const float w = fastmath::kTwoPi * value(kModRate) / (float)sr_;
+    lfoCos_ = std::cos(w);
+    lfoSin_ = std::sin(w);
+    modDepth_ = value(kModDepth) * kMaxModSmp * k;
+    preDelay_ = std::clamp((int)std::lround(value(kPredelay) * 0.001f * (float)sr_), 0, preMask_);
+}
+
+void FdnReverb::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0 || lines_.empty()) return;
+
+    float inPeak = 0.f;
+    for (int i = 0; i < nframes; ++i) inPeak = std::max(inPeak, std::max(std::fabs(L[i]), std::fabs(R[i])));
+    const ParamSmoother& mix = smoothed(kMix, nframes);
+    if (asleep_ && inPeak == 0.f) { // хвост погас, входа нет: wet = 0
+        for (int i = 0; i < nframes; ++i) { L[i] *= 1.f - mix.at(i); R[i] *= 1.f - mix.at(i); }
+        return;
+    }
+    asleep_ = false;
+
+    updateTargets(nframes);
+    const float width = value(kWidth);
+    const float wA = 0.5f * (1.f + width), wB = 0.5f * (1.f - width);
+
+    const simd::f32x8 fb = fb_;
+    const float damp = dampA_, cw = lfoCos_, sw = lfoSin_, depth = modDepth_;
+    constexpr float hh = 2.f / (float)kLines;
+    const int mask = lineMask_;
+    float* buf = lines_.data();
+
+    simd::f32x8 len = len_, lp = lp_, s = lfoS_, c = lfoC_;
+    float outPeak = 0.f;
+
+    for (int i = 0; i < nframes; ++i) {
+        // предзадержка (моно)
+        pre_[(size_t)preWrite_] = 0.5f * (L[i] + R[i]);
+        const float x = pre_[(size_t)((preWrite_ - preDelay_) & preMask_)];
+        preWrite_ = (preWrite_ + 1) & preMask_;
+
+        // модулированные дробные отводы: d = len + depth·(1 + sin) ≥ 1
+        len += lenStep_;
+        const simd::f32x8 s1 = s * cw + c * sw;
+        c = c * cw - s * sw;
+        s = s1;
+        const simd::f32x8 d = len + depth * (s + 1.f);
+        const simd::i32x8 di = __builtin_convertvector(d, simd::i32x8);
+        const simd::f32x8 fr = d - __builtin_convertvector(di, simd::f32x8);
+        simd::f32x8 a, b;
+        for (int l = 0; l < kLines; ++l) {
+            const int p = writePos_ - di[l];
+            a[l] = buf[(size_t)(p & mask) * kLines + (size_t)l];
+            b[l] = buf[(size_t)((p - 1) & mask) * kLines + (size_t)l];
+        }
+        const simd::f32x8 tap = a + (b - a) * fr;
+
+        // демпфирование и затухание в петле, смешивание Хаусхолдером
+        lp += damp * (tap - lp);
+        simd::f32x8 y = lp * fb;
+        y -= hh * simd::hsum(y);
+        simd::store8(buf + (size_t)writePos_ * kLines, y + kInSign * x);
+        writePos_ = (writePos_ + 1) & mask;
+
+        const float wl = kOutGain * simd::hsum(lp * kOutL);
+        const float wr = kOutGain * simd::hsum(lp * kOutR);
+        const float ol = wA * wl + wB * wr;
+        const float orr = wA * wr + wB * wl;
+        outPeak = std::max(outPeak, std::max(std::fabs(ol), std::fabs(orr)));
+        const float m = mix.at(i);
+        L[i] += m * (ol - L[i]);
+        R[i] += m * (orr - R[i]);
+    }
+
+    // нормировка осциллятора (накопленная ошибка поворота) и денормалы
+    const simd::f32x8 g = 1.5f - 0.5f * (s * s + c * c);
+    lfoS_ = s * g;
+    lfoC_ = c * g;
+    len_ = len;
+    simd::f32x8 alp, tiny;
+    simd::abs(alp, lp);
+    simd::splat8(tiny, 1e-20f);
+    simd::select(lp_, alp < tiny, simd::f32x8{}, lp);
+
+    // хвост погас, а вход тих дольше предзадержки + самой длинной линии (иначе эхо ещё в пути) —
+    // чистим линии один раз и засыпаем
+    quiet_ = inPeak == 0.f ? quiet_ + nframes : 0;
+    if (quiet_ > preDelay_ + lineMask_ && outPeak < kSleepEps) {
+        std::fill(lines_.begin(), lines_.end(), 0.f);
+        std::fill(pre_.begin(), pre_.end(), 0.f);
+        lp_ = simd::f32x8{};
+        asleep_ = true;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include "fx/FxBase.h"
+#include "utils/Simd.h"
+
+// Алгоритмический ревер на сети задержек с обратной связью (FDN, 8 линий).
+//  - 8 линий = один f32x8: чтение (модулированные дробные отводы), затухание, демпфирование,
+//    матрица смешивания и запись — векторно; гатер отводов — 8 скалярных чтений.
+//  - Матрица — Хаусхолдер (I − 2/N·11ᵀ): ортогональна, стоит одну горизонтальную сумму.
+//  - Длины линий взаимно простые, масштабируются size; RT60 задаёт усиление каждой линии
+//    (g = 10^(−3·len / (RT60·sr))), высокие гасит one-pole в петле (damp).
+//  - Отводы модулируются синусами (квадратурный осциллятор на вектор, фазы разнесены) — без «металла».
+// Рассчитан на общий return-бас: один экземпляр на движок, сенды треков суммируются до него,
+// поэтому стоимость постоянна при любом числе сендов. Вход/выход стерео, mix — для insert-режима.
+// RT: process() без аллокаций, блок любой длины (скретча под blockSize нет); тишина на входе +
+// погасший хвост → ранний выход. prepare() — НЕ RT: линии заново и чистые.
+class FdnReverb final : public FxBase {
+public:
+    static constexpr int kLines = 8;
+    enum Param { kSize, kDecay, kDamp, kPredelay, kModDepth, kModRate, kWidth, kMix, kCount };
+
+    FdnReverb();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+
+private:
+    void updateTargets(int nframes) noexcept;
+
+    // линии: кадр-мажорный кольцевой буфер [pos·kLines + line] — запись всех линий одним store8
+    std::vector<float> lines_;
+    int lineMask_ = 0;           // (кадров в кольце) − 1
+    int writePos_ = 0;
+
+    std::vector<float> pre_;     // моно-предзадержка
+    int preMask_ = 0;
+    int preWrite_ = 0;
+
+    simd::f32x8 len_{};          // текущие длины (сэмплы, плавно тянутся к цели)
+    simd::f32x8 lenStep_{};      // шаг длины на сэмпл в текущем блоке
+    simd::f32x8 fb_{};           // усиление линий по RT60
+    simd::f32x8 lp_{};           // состояния демпфирующих one-pole
+    simd::f32x8 lfoS_{}, lfoC_{};// квадратурный LFO (sin/cos) на линию
+    float dampA_ = 1.f;
+    float lfoCos_ = 1.f, lfoSin_ = 0.f;
+    float modDepth_ = 0.f;       // амплитуда модуляции, сэмплы
+    int   preDelay_ = 0;
+    int   quiet_ = 0;            // сэмплов тишины на входе подряд
+    bool  asleep_ = true;
+    bool  primed_ = false;
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "devices/IFX.h"
+#include "params/Smoothing.h"
+
+// Общая часть встроенных IFx: таблица параметров + атомарные значения + bypass.
+// setParam/getParam — из любого потока (кламп/квант по описанию), эффект читает value(i) в process().
+// Производный класс передаёт статический массив описаний; индекс в нём = индекс значения.
+// smoothed(i, n) — тот же параметр со сглаживанием (ParamSmoother), для ручек, которые «молнят»:
+// во встроенных эффектах так читаются mix/gain/output/makeup и фидбек задержки.
+// Частоты/Q/время остаются на value() — у фильтров и линий свои рампы коэффициентов.
+class FxBase : public IFx {
+public:
+    explicit FxBase(std::span<const FxParamDesc> descs)
+        : descs_(descs), values_(descs.size()), smooth_(descs.size()) {
+        for (size_t i = 0; i < descs_.size(); ++i) values_[i].store(descs_[i].def, std::memory_order_relaxed);
+    }
+
+    std::span<const FxParamDesc> params() const override { return descs_; }
+
+    bool setParam(std::string_view id, float value) override {
+        const int i = indexOf(id);
+        if (i < 0) return false;
+        const auto& d = descs_[(size_t)i];
+        value = std::clamp(value, d.min, d.max);
+        if (d.step > 0.f) value = d.min + std::round((value - d.min) / d.step) * d.step;
+        if (d.type != FxParamType::Float) value = std::round(value);
+        values_[(size_t)i].store(value, std::memory_order_relaxed);
+        return true;
+    }
+
+    float getParam(std::string_view id) const override {
+        const int i = indexOf(id);
+        return i < 0 ? 0.f : values_[(size_t)i].load(std::memory_order_relaxed);
+    }
+
+    void setBypass(bool on) override { bypass_.store(on, std::memory_order_relaxed); }
+    bool bypass() const override { return bypass_.load(std::memory_order_relaxed); }
+
+protected:
+    float value(int i) const noexcept { return values_[(size_t)i].load(std::memory_order_relaxed); }
+    void  setValue(int i, float v) noexcept { // RT: без поиска по id; кламп по описанию
+        const auto& d = descs_[(size_t)i];
+        values_[(size_t)i].store(std::clamp(v, d.min, d.max), std::memory_order_relaxed);
+    }
+    // RT: продвинуть сглаживание параметра i на блок из n и вернуть его (раз в блок на параметр)
+    const ParamSmoother& smoothed(int i, int n) noexcept {
+        ParamSmoother& s = smooth_[(size_t)i];
+        if (smoothSr_ != sr_) { // SR сменился (prepare): рампы пересчитать
+            for (auto& x : smooth_) x.setRamp(ParamSmoother::kDefaultRampMs, sr_);
+            smoothSr_ = sr_;
+        }
+        s.advance(value(i), n);
+        return s;
+    }
+    int   indexOf(std::string_view id) const noexcept {
+        for (size_t i = 0; i < descs_.size(); ++i) if (descs_[i].id == id) return (int)i;
+        return -1;
+    }
+
+    int sr_ = 48000;
+    int bs_ = 512;
+
+private:
+    std::span<const FxParamDesc> descs_;
+    std::vector<std::atomic<float>> values_;
+    std::vector<ParamSmoother> smooth_;
+    int smoothSr_ = 0;
+    std::atomic<bool> bypass_{false};
+};
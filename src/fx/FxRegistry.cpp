@@ -0,0 +1,152 @@
+#include "fx/FxRegistry.h"
+#include "fx/ConvReverb.h"
+#include "fx/Dynamics.h"
+#include "fx/FdnReverb.h"
+#include "fx/Saturator.h"
+#include "fx/StereoDelay.h"
+#include "fx/SvfFilter.h"
+#include <algorithm>
+#include <utility>
+
+FxRegistry::Entry* FxRegistry::find(std::string_view type) const {
+    for (auto& e : entries_) if (e->type == type) return e.get();
+    return nullptr;
+}
+
+bool FxRegistry::registerFx(std::string_view type, FxFactoryFn make) {
+    return registerFx(type, std::move(make), kDefaultPool);
+}
+
+bool FxRegistry::registerFx(std::string_view type, FxFactoryFn make, int poolSize) {
+    if (type.empty() || !make) return false;
+    std::lock_guard<std::mutex> lk(mx_);
+    if (find(type)) return false;
+    auto e = std::make_unique<Entry>();
+    e->type = std::string(type);
+    e->make = std::move(make);
+    e->target = std::max(0, poolSize);
+    entries_.push_back(std::move(e));
+    return true;
+}
+
+bool FxRegistry::isRegistered(std::string_view type) const {
+    std::lock_guard<std::mutex> lk(mx_);
+    return find(type) != nullptr;
+}
+
+std::unique_ptr<IFx> FxRegistry::create(std::string_view type) const {
+    int sr = 0, bs = 0;
+    {
+        std::lock_guard<std::mutex> lk(mx_);
+        sr = sr_; bs = bs_;
+    }
+    return createPrepared(type, sr, bs);
+}
+
+std::unique_ptr<IFx> FxRegistry::createPrepared(std::string_view type, int sampleRate, int blockSize) const {
+    FxFactoryFn make;
+    {
+        std::lock_guard<std::mutex> lk(mx_);
+        Entry* e = find(type);
+        if (!e) return nullptr;
+        if (!e->pool.empty() && sampleRate == sr_ && blockSize == bs_) {
+            auto fx = std::move(e->pool.back());
+            e->pool.pop_back();
+            return fx;
+        }
+        make = e->make;
+    }
+    // Пул пуст (или другой SR/блок): создаём сами, вне мьютекса — конструктор может быть тяжёлым
+    auto fx = make();
+    if (fx) fx->prepare(sampleRate, blockSize);
+    return fx;
+}
+
+std::vector<std::string> FxRegistry::listTypes() const {
+    std::lock_guard<std::mutex> lk(mx_);
+    std::vector<std::string> out;
+    out.reserve(entries_.size());
+    for (const auto& e : entries_) out.push_back(e->type);
+    return out;
+}
+
+void FxRegistry::maintain() {
+    // По одному экземпляру за раз: создание и prepare — вне мьютекса, create() не ждёт
+    for (;;) {
+        FxFactoryFn make;
+        std::string type;
+        int sr = 0, bs = 0;
+        {
+            std::lock_guard<std::mutex> lk(mx_);
+            for (const auto& e : entries_) {
+                if ((int)e->pool.size() < e->target) { make = e->make; type = e->type; break; }
+            }
+            if (!make) return;
+            sr = sr_; bs = bs_;
+        }
+
+        auto fx = make();
+        if (!fx) return;
+        fx->prepare(sr, bs);
+
+        std::lock_guard<std::mutex> lk(mx_);
+        Entry* e = find(type);
+        // пока готовили, могли сменить SR/блок или урезать пул — тогда экземпляр лишний
+        if (!e || sr != sr_ || bs != bs_ || (int)e->pool.size() >= e->target) continue;
+        e->pool.push_back(std::move(fx));
+    }
+}
+
+bool FxRegistry::setPoolSize(std::string_view type, int count) {
+    std::vector<std::unique_ptr<IFx>> extra;
+    {
+        std::lock_guard<std::mutex> lk(mx_);
+        Entry* e = find(type);
+        if (!e) return false;
+        e->target = std::max(0, count);
+        while ((int)e->pool.size() > e->target) {
+            extra.push_back(std::move(e->pool.back()));
+            e->pool.pop_back();
+        }
+    }
+    return true; // extra удаляются здесь, вне мьютекса
+}
+
+int FxRegistry::poolSize(std::string_view type) const {
+    std::lock_guard<std::mutex> lk(mx_);
+    const Entry* e = find(type);
+    return e ? e->target : 0;
+}
+
+int FxRegistry::pooled(std::string_view type) const {
+    std::lock_guard<std::mutex> lk(mx_);
+    const Entry* e = find(type);
+    return e ? (int)e->pool.size() : 0;
+}
+
+void FxRegistry::prepare(int sampleRate, int blockSize) {
+    {
+        std::lock_guard<std::mutex> lk(mx_);
+        if (sampleRate != sr_ || blockSize != bs_) {
+            sr_ = sampleRate;
+            bs_ = blockSize;
+            for (auto& e : entries_) for (auto& fx : e->pool) fx->prepare(sr_, bs_);
+        }
+    }
+    maintain();
+}
+
+void registerBuiltinFx(FxRegistry& registry) {
+    registry.registerFx("svf",     []{ return std::make_unique<SvfFilter>(); });
+    registry.registerFx("svfbank", []{ return std::make_unique<SvfBank>(); });
+    registry.registerFx("reverb",  []{ return std::make_unique<FdnReverb>(); });
+    registry.registerFx("saturator", []{ return std::make_unique<Saturator>(); });
+    registry.registerFx("delay",   []{ return std::make_unique<StereoDelay>(); });
+    registry.registerFx("compressor", []{ return std::make_unique<BusCompressor>(); });
+    registry.registerFx("limiter", []{ return std::make_unique<Limiter>(); });
+    registry.registerFx("convolution", []{
+        auto fx = std::make_unique<ConvReverb>();
+        fx->loadIr(ConvReverb::kDefaultIr); // нет файла — эффект проходит насквозь до setIr/loadIr
+        return fx;
+    }, 0);
+}
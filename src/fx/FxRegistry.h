@@ -0,0 +1,57 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "devices/IFXFactory.h"
+
+// Реестр эффектов с пулами готовых экземпляров по типам.
+//  - Каждый тип держит pool заранее созданных и подготовленных (prepare(sr, bs)) экземпляров;
+//    create() — снятие с пула под коротким мьютексом. Пул пуст → создаём на месте (медленный путь).
+//  - maintain() доливает пулы до целевого размера; его зовёт builder-поток FxLifecycle в простое,
+//    так что повторное добавление того же FX снова берётся из пула.
+//  - Размеры пулов задаёт проект (Project::fxPools → setPoolSize) — прогреваем ровно то, что играет сет.
+//    По умолчанию kDefaultPool; тяжёлые типы (свёртка: IR, FFT-уровни, ~МБ на экземпляр) регистрируются
+//    с пулом 0 — их держим, только если проект попросил.
+//  - SR/блок пулов — prepare(); после старта движка его зовёт builder-поток FxLifecycle при смене.
+// НЕ RT: всё вызывается вне аудиопотока (create — из builder-потока FxLifecycle).
+class FxRegistry final : public IFxRegistry {
+public:
+    static constexpr int kDefaultPool = 2;
+
+    bool registerFx(std::string_view type, FxFactoryFn make) override;           // пул kDefaultPool
+    bool registerFx(std::string_view type, FxFactoryFn make, int poolSize);
+    bool isRegistered(std::string_view type) const override;
+    std::unique_ptr<IFx> create(std::string_view type) const override;        // пуловый: prepare(sr_, bs_)
+    std::unique_ptr<IFx> createPrepared(std::string_view type, int sampleRate, int blockSize) const override;
+    std::vector<std::string> listTypes() const override;
+    void maintain() override;
+
+    // Целевой размер пула типа (0 — без пула). Лишние экземпляры удаляются сразу.
+    bool setPoolSize(std::string_view type, int count);
+    int  poolSize(std::string_view type) const;    // целевой
+    int  pooled(std::string_view type) const;      // сколько готово сейчас
+
+    // SR/блок для prepare пуловых экземпляров; уже готовые переподготавливаются. Затем maintain().
+    void prepare(int sampleRate, int blockSize) override;
+
+private:
+    struct Entry {
+        std::string type;
+        FxFactoryFn make;
+        int target = kDefaultPool;
+        std::vector<std::unique_ptr<IFx>> pool;
+    };
+
+    Entry*       find(std::string_view type) const;  // под mx_
+
+    mutable std::mutex mx_;
+    mutable std::vector<std::unique_ptr<Entry>> entries_; // create() снимает с пула
+    int sr_ = 48000;
+    int bs_ = 512;
+};
+
+// Встроенные эффекты: "svf", "svfbank", "reverb", "convolution", …
+// "convolution" — без пула (тяжёлый), остальные — kDefaultPool.
+void registerBuiltinFx(FxRegistry& registry);
@@ -0,0 +1,242 @@
+#include "fx/Saturator.h"
+#include "utils/FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+const FxParamDesc kParams[] = {
+    {"drive",      "Drive",      FxParamType::Float, 0.f,   1.f,  0.3f, 0.f},  // 0..+36 дБ перед кривой
+    {"curve",      "Curve",      FxParamType::Enum,  0.f,   2.f,  0.f,  1.f},  // Tanh / Tube / HardClip
+    {"oversample", "Oversample", FxParamType::Bool,  0.f,   1.f,  0.f,  1.f},  // 2×, латентность kOsLatency
+    {"output",     "Output",     FxParamType::Float, -24.f, 12.f, 0.f,  0.f},  // дБ
+    {"mix",        "Mix",        FxParamType::Float, 0.f,   1.f,  1.f,  0.f},
+};
+static_assert(std::size(kParams) == Saturator::kCount);
+
+using Curve = Saturator::Curve;
+using simd::f32x4;
+
+constexpr float kMaxDriveDb = 36.f;
+constexpr float kTubeBias   = 0.3f;          // смещение рабочей точки «лампы»
+constexpr float kTubeOff    = 0.291312612f;  // tanh(kTubeBias): f(0) = 0
+constexpr float kAdaaEps    = 1e-3f;         // |Δx| меньше — берём f(середины), деление неустойчиво
+constexpr float kDcHz       = 10.f;
+constexpr float kSleepEps   = 1e-6f;
+
+inline int round4(int n) noexcept { return (n + 3) & ~3; }
+
+// кривая f и её первообразная F (константа у F произвольна, но одна на поток)
+template<Curve C> inline f32x4 curveF(f32x4 x) noexcept {
+    if constexpr (C == Curve::Tanh) return fastmath::tanh(x);
+    else if constexpr (C == Curve::Tube) return fastmath::tanh(x + simd::splat4(kTubeBias)) - simd::splat4(kTubeOff);
+    else return simd::min(simd::max(x, simd::splat4(-1.f)), simd::splat4(1.f));
+}
+
+template<Curve C> inline f32x4 curveAF(f32x4 x) noexcept {
+    if constexpr (C == Curve::Tanh) return fastmath::logcosh(x);
+    else if constexpr (C == Curve::Tube)
+        return fastmath::logcosh(x + simd::splat4(kTubeBias)) - simd::splat4(kTubeOff) * x;
+    else {
+        const f32x4 a = simd::abs(x);
+        return simd::select(a <= simd::splat4(1.f), simd::splat4(0.5f) * x * x, a - simd::splat4(0.5f));
+    }
+}
+
+float antideriv(Curve c, float x) noexcept {
+    const f32x4 v = simd::splat4(x);
+    switch (c) {
+    case Curve::Tanh:     return curveAF<Curve::Tanh>(v)[0];
+    case Curve::Tube:     return curveAF<Curve::Tube>(v)[0];
+    case Curve::HardClip: return curveAF<Curve::HardClip>(v)[0];
+    }
+    return 0.f;
+}
+
+// ADAA первого порядка по 4 сэмпла: sx[0] — прошлый вход, sx[1..n] — текущие; fs[0] = F(sx[0]).
+// y[i] = (F(sx[i+1]) − F(sx[i])) / (sx[i+1] − sx[i]) → out[i]
+template<Curve C>
+void adaa(const float* sx, float* fs, float* out, int n) noexcept {
+    for (int i = 0; i < n; i += 4) simd::store4(fs + 1 + i, curveAF<C>(simd::load4(sx + 1 + i)));
+    const f32x4 eps = simd::splat4(kAdaaEps), half = simd::splat4(0.5f), one = simd::splat4(1.f);
+    for (int i = 0; i < n; i += 4) {
+        const f32x4 x0 = simd::load4(sx + i), x1 = simd::load4(sx + i + 1);
+        const f32x4 dx = x1 - x0;
+        const auto  near = simd::abs(dx) < eps;
+        const f32x4 y = (simd::load4(fs + i + 1) - simd::load4(fs + i)) / simd::select(near, one, dx);
+        // f(середины) — только если хоть один лейн «стоит» (на громком сигнале это редкость)
+        if (near[0] | near[1] | near[2] | near[3]) simd::store4(out + i, simd::select(near, curveF<C>(half * (x0 + x1)), y));
+        else simd::store4(out + i, y);
+    }
+}
+
+// рампа g0 → g1: i-й сэмпл блока из n получает g0 + (g1 − g0)·(i + 1)/n
+inline void scaleRamp(float* x, int n, float g0, float g1) noexcept {
+    const float step = (g1 - g0) / (float)n;
+    f32x4 g = simd::splat4(g0) + simd::splat4(step) * f32x4{1.f, 2.f, 3.f, 4.f};
+    const f32x4 gs = simd::splat4(4.f * step);
+    for (int i = 0; i < n; i += 4, g += gs) simd::store4(x + i, simd::load4(x + i) * g);
+}
+
+} // namespace
+
+Saturator::Saturator() : FxBase(kParams) {
+    // полуполосный FIR: h[k] = ½·sinc((k − 15)/2)·Blackman(k); нечётные расстояния от центра — нули,
+    // кроме центра (½). Храним чётные отводы, нормируем Σ = ½ (единичное усиление на DC).
+    constexpr int c = kHalfbandTaps / 2;
+    float sum = 0.f;
+    for (int m = 0; m < kEvenTaps; ++m) {
+        const int k = 2 * m;
+        const double d = 0.5 * (double)(k - c);
+        const double w = 0.42 - 0.5 * std::cos(2.0 * M_PI * k / (kHalfbandTaps - 1)) +
+                         0.08 * std::cos(4.0 * M_PI * k / (kHalfbandTaps - 1));
+        he_[m] = (float)(0.5 * std::sin(M_PI * d) / (M_PI * d) * w);
+        sum += he_[m];
+    }
+    for (float& h : he_) h *= 0.5f / sum;
+}
+
+void Saturator::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    const int n4 = round4(bs_);
+    sx_.assign((size_t)(2 * n4 + 16), 0.f);
+    fs_.assign((size_t)(2 * n4 + 16), 0.f);
+    os_.assign((size_t)(2 * n4 + 16), 0.f);
+    in_.assign((size_t)(kOsLatency + n4 + 8), 0.f);
+    ev_.assign((size_t)(kEvenTaps - 1 + n4 + 8), 0.f);
+    od_.assign((size_t)(kOddDelay + n4 + 8), 0.f);
+    dcR_ = 1.f - fastmath::kTwoPi * kDcHz / (float)sr_;
+    reset();
+}
+
+void Saturator::reset() {
+    for (Channel& c : ch_) c = Channel{};
+    drive_ = -1.f;
+    curve_ = -1;
+    quiet_ = 0;
+    asleep_ = true;
+}
+
+void Saturator::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0 || sx_.empty()) return;
+    for (int off = 0; off < nframes; off += bs_) processChunk(L + off, R + off, std::min(bs_, nframes - off));
+}
+
+void Saturator::processChunk(float* L, float* R, int n) noexcept {
+    const bool os = value(kOversample) >= 0.5f;
+    const ParamSmoother& out = smoothed(kOutput, n); // рампы идут и в тишине: на возобновлении — без скачка
+    const ParamSmoother& mix = smoothed(kMix, n);
+    const int curve = std::clamp((int)value(kCurve), 0, 2);
+    if (os != lastOs_) { // другая цепочка — истории фильтров с чистого листа
+        for (Channel& c : ch_) {
+            std::fill(std::begin(c.hist), std::end(c.hist), 0.f);
+            std::fill(std::begin(c.evHist), std::end(c.evHist), 0.f);
+            std::fill(std::begin(c.odHist), std::end(c.odHist), 0.f);
+        }
+        lastOs_ = os;
+    }
+    if (curve != curve_) { // первообразная другая: F1 пересчитываем от сохранённого x1
+        for (Channel& c : ch_) c.F1 = antideriv((Curve)curve, c.x1);
+        curve_ = curve;
+    }
+
+    // тишина на входе дольше хвоста фильтров, DC-блокер погас: шейпер выдаст 0 (f(0) = 0)
+    float peak = 0.f;
+    for (int i = 0; i < n; ++i) peak = std::max(peak, std::max(std::fabs(L[i]), std::fabs(R[i])));
+    quiet_ = peak == 0.f ? quiet_ + n : 0;
+    if (quiet_ > kHalfbandTaps && std::fabs(ch_[0].dcY) < kSleepEps && std::fabs(ch_[1].dcY) < kSleepEps) {
+        for (Channel& c : ch_) {
+            c = Channel{};
+            c.F1 = antideriv((Curve)curve, 0.f);
+        }
+        asleep_ = true;
+        return;
+    }
+    asleep_ = false;
+
+    const float g1 = std::pow(10.f, kMaxDriveDb / 20.f * value(kDrive));
+    const float g0 = drive_ < 0.f ? g1 : drive_;
+    drive_ = g1;
+    processChannel(ch_[0], L, n, os, g0, g1, out, mix);
+    processChannel(ch_[1], R, n, os, g0, g1, out, mix);
+}
+
+void Saturator::shape(Channel& c, float* x, int n, float g0, float g1) noexcept {
+    float* sx = sx_.data();
+    float* fs = fs_.data();
+    sx[0] = c.x1;
+    fs[0] = c.F1;
+    std::copy(x, x + round4(n), sx + 1);
+    scaleRamp(sx + 1, n, g0, g1);
+
+    switch ((Curve)curve_) {
+    case Curve::Tanh:     adaa<Curve::Tanh>(sx, fs, x, n); break;
+    case Curve::Tube:     adaa<Curve::Tube>(sx, fs, x, n); break;
+    case Curve::HardClip: adaa<Curve::HardClip>(sx, fs, x, n); break;
+    }
+    c.x1 = sx[n];
+    c.F1 = fs[n];
+
+    // компенсация громкости ~1/√g (тоже рампой)
+    scaleRamp(x, n, 1.f / std::sqrt(g0), 1.f / std::sqrt(g1));
+}
+
+void Saturator::processChannel(Channel& c, float* io, int n, bool os, float g0, float g1,
+                               const ParamSmoother& outDb, const ParamSmoother& mix) noexcept {
+    // in = [история kOsLatency | вход]; in[j] — вход с задержкой kOsLatency (сухой при OS)
+    float* in = in_.data();
+    float* y = os_.data();
+    std::copy(std::begin(c.hist), std::end(c.hist), in);
+    std::copy(io, io + n, in + kOsLatency);
+    const float* x = in + kOsLatency;
+
+    if (!os) {
+        std::copy(io, io + n, y);
+        shape(c, y, n, g0, g1);
+    } else {
+        // интерполятор 2×: u[2j] = 2·Σ h[2m]·x[j − m];  u[2j+1] = 2·h[15]·x[j − 7] = x[j − 7]
+        for (int j = 0; j < n; j += 4) {
+            f32x4 acc{};
+            for (int m = 0; m < kEvenTaps; ++m) acc += simd::splat4(he_[m]) * simd::load4(x + j - m);
+            const f32x4 e = simd::splat4(2.f) * acc;
+            const f32x4 o = simd::load4(x + j - kOsLatency / 2);
+            simd::store4(y + 2 * j,     __builtin_shufflevector(e, o, 0, 4, 1, 5));
+            simd::store4(y + 2 * j + 4, __builtin_shufflevector(e, o, 2, 6, 3, 7));
+        }
+        shape(c, y, 2 * n, g0, g1);
+
+        // дециматор: d[j] = Σ h[2m]·u[2j − 2m] + ½·u[2j − 15]; u[2j − 15] — нечётная фаза, j − 8
+        float* ev = ev_.data();
+        float* od = od_.data();
+        std::copy(std::begin(c.evHist), std::end(c.evHist), ev);
+        std::copy(std::begin(c.odHist), std::end(c.odHist), od);
+        float* e = ev + (kEvenTaps - 1);
+        float* o = od + kOddDelay;
+        for (int j = 0; j < n; ++j) { e[j] = y[2 * j]; o[j] = y[2 * j + 1]; }
+        std::copy(ev + n, ev + n + (kEvenTaps - 1), c.evHist);
+        std::copy(od + n, od + n + kOddDelay, c.odHist);
+        for (int j = 0; j < n; j += 4) {
+            f32x4 acc = simd::splat4(0.5f) * simd::load4(od + j);
+            for (int m = 0; m < kEvenTaps; ++m) acc += simd::splat4(he_[m]) * simd::load4(e + j - m);
+            simd::store4(y + j, acc);
+        }
+    }
+    std::copy(in + n, in + n + kOsLatency, c.hist);
+
+    // DC-блокер (Tube даёт постоянку), выход, сухой/мокрый
+    const float* dry = os ? in : io;
+    // выход (дБ) — рампа линейного гейна между концами блока: pow раз в блок, не на сэмпл
+    const float out0 = std::pow(10.f, outDb.start() / 20.f);
+    const float outStep = (std::pow(10.f, outDb.end() / 20.f) - out0) / (float)n;
+    float dx = c.dcX, dy = c.dcY;
+    for (int j = 0; j < n; ++j) {
+        const float w = y[j];
+        dy = w - dx + dcR_ * dy;
+        dx = w;
+        io[j] = dry[j] + mix.at(j) * (dy * (out0 + outStep * (float)(j + 1)) - dry[j]);
+    }
+    c.dcX = dx;
+    c.dcY = std::fabs(dy) < 1e-20f ? 0.f : dy;
+}
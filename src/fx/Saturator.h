@@ -0,0 +1,64 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "fx/FxBase.h"
+
+// Вейвшейпер с антиалиасингом через первообразную (ADAA первого порядка):
+//   y[n] = (F(x[n]) − F(x[n−1])) / (x[n] − x[n−1]),  при |Δx| → 0 — f(среднего).
+// Обратной связи нет, поэтому считается по 4 сэмпла времени в векторе (f32x4);
+// tanh/ln·cosh — векторные аппроксимации fastmath, без libm в цикле.
+// Кривые: Tanh, Tube (асимметричный tanh со смещением — чётные гармоники, DC снимает HP),
+// HardClip. Опционально 2× передискретизация (полуполосный FIR) — для экстремального драйва.
+// Драйв 0..1 = 0..+36 дБ, линейная рампа по блоку; громкость компенсируется 1/√g.
+// RT: process() без аллокаций (скретч — в prepare() под blockSize); блок длиннее — режется на куски по blockSize.
+class Saturator final : public FxBase {
+public:
+    enum class Curve : int { Tanh, Tube, HardClip };
+    enum Param { kDrive, kCurve, kOversample, kOutput, kMix, kCount };
+
+    static constexpr int kHalfbandTaps = 31;                 // центр — 15 (на 2× частоте)
+    static constexpr int kOsLatency    = kHalfbandTaps / 2;  // вверх + вниз = 15 сэмплов базовой частоты
+
+    Saturator();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+    int  latencySamples() const override { return value(kOversample) >= 0.5f ? kOsLatency : 0; }
+    // Хвост вышел (задержка фильтров 2×, DC-блокер погас) — тишина на входе даст тишину, можно не звать
+    bool asleep() const noexcept { return asleep_; }
+
+    // RT: одна ручка (fx.saturation трека движка): drive = k, mix = min(1, 4k) — к нулю уходит в сухой плавно
+    void setAmount(float k01) noexcept {
+        setValue(kDrive, k01);
+        setValue(kMix, std::min(1.f, 4.f * k01));
+    }
+
+private:
+    static constexpr int kEvenTaps = kHalfbandTaps / 2 + 1; // ненулевые чётные отводы полуполосного FIR
+    static constexpr int kOddDelay = kHalfbandTaps / 4 + 1; // центральный отвод в полифазе: задержка 8
+
+    struct Channel {
+        float x1 = 0.f, F1 = 0.f;          // прошлый вход шейпера и его первообразная
+        float dcX = 0.f, dcY = 0.f;        // DC-блокер
+        float hist[kOsLatency]{};          // вход базовой частоты (интерполятор + сухой под латентность)
+        float evHist[kEvenTaps - 1]{};     // чётная фаза 2× сигнала (дециматор)
+        float odHist[kOddDelay]{};         // нечётная фаза
+    };
+
+    void processChunk(float* L, float* R, int n) noexcept;
+    void processChannel(Channel& c, float* io, int n, bool os, float g0, float g1,
+                        const ParamSmoother& outDb, const ParamSmoother& mix) noexcept;
+    void shape(Channel& c, float* x, int n, float g0, float g1) noexcept; // x — in/out, скретч с запасом
+
+    Channel ch_[2];
+    // скретч (в prepare, длины кратны 4 + запас): вход шейпера со слотом x[−1], F(x),
+    // 2× буфер, вход с историей, фазы 2× сигнала с историей
+    std::vector<float> sx_, fs_, os_, in_, ev_, od_;
+    float he_[kEvenTaps]{};                // чётные отводы h[2m]; центральный = 0.5
+    float drive_ = -1.f;                   // усиление прошлого блока (рампа); < 0 — ещё не было
+    int   curve_ = -1;                     // кривая прошлого блока (смена — пересчёт F1)
+    int   quiet_ = 0;                      // сэмплов тишины на входе подряд
+    bool  lastOs_ = false;
+    bool  asleep_ = true;                  // последний блок ушёл в ветку сна (или reset)
+    float dcR_ = 0.999f;
+};
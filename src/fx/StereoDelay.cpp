@@ -0,0 +1,194 @@
+#include "fx/StereoDelay.h"
+#include "utils/FastMath.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+// division: 1/32, 1/16T, 1/16, 1/16D, 1/8T, 1/8, 1/8D, 1/4T, 1/4, 1/4D, 1/2, 1/1 (в четвертях)
+constexpr float kDivBeats[] = {0.125f, 1.f / 6.f, 0.25f, 0.375f, 1.f / 3.f, 0.5f, 0.75f, 2.f / 3.f, 1.f, 1.5f, 2.f, 4.f};
+constexpr int   kDivCount = (int)std::size(kDivBeats);
+
+const FxParamDesc kParams[] = {
+    {"time",      "Time",      FxParamType::Float, 1.f,   StereoDelay::kMaxDelayMs, 375.f, 0.f}, // мс (sync = 0)
+    {"sync",      "Sync",      FxParamType::Bool,  0.f,   1.f,     1.f,     1.f},
+    {"division",  "Division",  FxParamType::Enum,  0.f,   (float)(kDivCount - 1), 6.f, 1.f},   // 1/8D
+    {"feedback",  "Feedback",  FxParamType::Float, 0.f,   0.95f,   0.4f,    0.f},
+    {"pingpong",  "Ping-pong", FxParamType::Bool,  0.f,   1.f,     0.f,     1.f},
+    {"lowcut",    "Low cut",   FxParamType::Float, 20.f,  2000.f,  120.f,   0.f},  // HP в петле, Гц
+    {"highcut",   "High cut",  FxParamType::Float, 500.f, 20000.f, 7000.f,  0.f},  // LP в петле, Гц
+    {"mod.depth", "Mod depth", FxParamType::Float, 0.f,   5.f,     0.3f,    0.f},  // мс
+    {"mod.rate",  "Mod rate",  FxParamType::Float, 0.05f, 5.f,     0.5f,    0.f},  // Гц
+    {"mix",       "Mix",       FxParamType::Float, 0.f,   1.f,     0.3f,    0.f},
+};
+static_assert(std::size(kParams) == StereoDelay::kCount);
+
+constexpr float kMaxModMs  = 5.f;
+constexpr float kMinDelay  = 8.f;     // сэмплов: 4 чтения блока + 2 точки Эрмита не заходят в незаписанное
+constexpr float kGlideSec  = 0.08f;   // постоянная времени скольжения задержки
+constexpr float kSleepEps  = 1e-6f;
+
+int pow2AtLeast(int n) noexcept {
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+float onePoleA(float hz, int sr) noexcept {
+    return 1.f - std::exp(-fastmath::kTwoPi * std::min(hz, 0.45f * (float)sr) / (float)sr);
+}
+
+} // namespace
+
+StereoDelay::StereoDelay() : FxBase(kParams) {}
+
+void StereoDelay::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    const int maxLen = (int)std::ceil((kMaxDelayMs + 2.f * kMaxModMs) * 0.001f * (float)sr_) + 8;
+    const int frames = pow2AtLeast(maxLen);
+    bufL_.assign((size_t)frames, 0.f);
+    bufR_.assign((size_t)frames, 0.f);
+    mask_ = frames - 1;
+    reset();
+}
+
+void StereoDelay::reset() {
+    std::fill(bufL_.begin(), bufL_.end(), 0.f);
+    std::fill(bufR_.begin(), bufR_.end(), 0.f);
+    writePos_ = 0;
+    lfoS_ = 0.f;
+    lfoC_ = 1.f;
+    lpL_ = lpR_ = hpL_ = hpR_ = 0.f;
+    quiet_ = 0;
+    asleep_ = true;
+    primed_ = false;
+}
+
+float StereoDelay::targetDelay() const noexcept {
+    float ms = value(kTime);
+    if (value(kSync) >= 0.5f && bpm_ > 0.0) {
+        const int div = std::clamp((int)value(kDivision), 0, kDivCount - 1);
+        ms = (float)(60000.0 / bpm_) * kDivBeats[div];
+    }
+    ms = std::min(ms, kMaxDelayMs);
+    return std::max(ms * 0.001f * (float)sr_, kMinDelay);
+}
+
+void StereoDelay::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0 || bufL_.empty()) return;
+
+    float inPeak = 0.f;
+    for (int i = 0; i < nframes; ++i) inPeak = std::max(inPeak, std::max(std::fabs(L[i]), std::fabs(R[i])));
+    const ParamSmoother& mix = smoothed(kMix, nframes);
+    const ParamSmoother& fb = smoothed(kFeedback, nframes);
+    if (asleep_ && inPeak == 0.f) { // повторы погасли, входа нет: wet = 0
+        for (int i = 0; i < nframes; ++i) { L[i] *= 1.f - mix.at(i); R[i] *= 1.f - mix.at(i); }
+        return;
+    }
+    asleep_ = false;
+
+    // время: цель → one-pole на частоте блоков → линейная рампа внутри блока
+    const float target = targetDelay();
+    if (!primed_) { delay_ = target; primed_ = true; }
+    const float a = 1.f - std::exp(-(float)nframes / (kGlideSec * (float)sr_));
+    float d1 = delay_ + a * (target - delay_);
+    if (std::fabs(target - d1) < 1e-3f) d1 = target;
+    const float d0 = delay_, dStep = (d1 - d0) / (float)nframes;
+    delay_ = d1;
+
+    const float depth = value(kModDepth) * 0.001f * (float)sr_;
+    const float w = fastmath::kTwoPi * value(kModRate) / (float)sr_;
+    const float cw = std::cos(w), sw = std::sin(w);
+    const bool  pingPong = value(kPingPong) >= 0.5f;
+    const float aLp = onePoleA(value(kHighCut), sr_);
+    const float aHp = onePoleA(value(kLowCut), sr_);
+
+    const simd::f32x8 lane = {0.f, 1.f, 2.f, 3.f, 0.f, 1.f, 2.f, 3.f};
+    constexpr float half = 0.5f;
+    const int mask = mask_;
+    const float* bl = bufL_.data();
+    const float* br = bufR_.data();
+    int quiet = quiet_;
+    const int sleepAfter = (int)(d1 + 2.f * depth) + 8;
+
+    for (int i = 0; i < nframes; i += 4) {
+        const int m = std::min(4, nframes - i);
+
+        // задержки 4 сэмплов: рампа + LFO (L — sin, R — cos: стерео-«хорус» повторов);
+        // LFO внутри четвёрки — линейно по производной (ω ≤ 7e-4, ошибка ~1e-6)
+        simd::f32x8 d;
+        for (int k = 0; k < 4; ++k) {
+            const float base = d0 + dStep * (float)(i + k + 1);
+            d[k]     = base + depth * (1.f + lfoS_ + (float)k * w * lfoC_);
+            d[4 + k] = base + depth * (1.f + lfoC_ - (float)k * w * lfoS_);
+        }
+        // позиция чтения относительно writePos_ + i: k − d  (всегда < −5)
+        const simd::f32x8 rel = lane - d;
+        const simd::i32x8 ri = __builtin_convertvector(rel, simd::i32x8);   // к нулю → поправка floor
+        const simd::f32x8 rf = __builtin_convertvector(ri, simd::f32x8);
+        const simd::i32x8 idx = ri + (rf > rel);                            // маска −1 там, где округлило вверх
+        const simd::f32x8 fr = rel - __builtin_convertvector(idx, simd::f32x8);
+
+        simd::f32x8 xm1, x0, x1, x2;
+        for (int k = 0; k < 8; ++k) {
+            const float* b = k < 4 ? bl : br;
+            const int p = writePos_ + i + idx[k];
+            xm1[k] = b[(p - 1) & mask];
+            x0[k]  = b[p & mask];
+            x1[k]  = b[(p + 1) & mask];
+            x2[k]  = b[(p + 2) & mask];
+        }
+        // Эрмит (Catmull-Rom) по 4 точкам
+        const simd::f32x8 c1 = half * (x1 - xm1);
+        const simd::f32x8 c2 = xm1 - 2.5f * x0 + 2.f * x1 - half * x2;
+        const simd::f32x8 c3 = half * (x2 - xm1) + 1.5f * (x0 - x1);
+        const simd::f32x8 y = ((c3 * fr + c2) * fr + c1) * fr + x0;
+
+        // фильтры петли, обратная связь и запись — по сэмплу
+        for (int k = 0; k < m; ++k) {
+            const int j = i + k;
+            lpL_ += aLp * (y[k] - lpL_);
+            lpR_ += aLp * (y[4 + k] - lpR_);
+            hpL_ += aHp * (lpL_ - hpL_);
+            hpR_ += aHp * (lpR_ - hpR_);
+            const float wl = lpL_ - hpL_, wr = lpR_ - hpR_;
+
+            const int p = (writePos_ + j) & mask;
+            const float g = fb.at(j);
+            if (pingPong) { // моно-вход в левый, повторы перекрёстно
+                bufL_[(size_t)p] = 0.5f * (L[j] + R[j]) + g * wr;
+                bufR_[(size_t)p] = g * wl;
+            } else {
+                bufL_[(size_t)p] = L[j] + g * wl;
+                bufR_[(size_t)p] = R[j] + g * wr;
+            }
+            const bool still = L[j] == 0.f && R[j] == 0.f && std::fabs(wl) < kSleepEps && std::fabs(wr) < kSleepEps;
+            quiet = still ? quiet + 1 : 0;
+            const float wet = mix.at(j);
+            L[j] += wet * (wl - L[j]);
+            R[j] += wet * (wr - R[j]);
+        }
+
+        // поворот LFO на m сэмплов
+        for (int k = 0; k < m; ++k) {
+            const float s1 = lfoS_ * cw + lfoC_ * sw;
+            lfoC_ = lfoC_ * cw - lfoS_ * sw;
+            lfoS_ = s1;
+        }
+    }
+    writePos_ = (writePos_ + nframes) & mask;
+
+    // нормировка осциллятора и денормалы фильтров
+    const float g = 1.5f - 0.5f * (lfoS_ * lfoS_ + lfoC_ * lfoC_);
+    lfoS_ *= g;
+    lfoC_ *= g;
+    for (float* s : {&lpL_, &lpR_, &hpL_, &hpR_}) if (std::fabs(*s) < 1e-20f) *s = 0.f;
+
+    // всё, что достижимо чтением (задержка + модуляция), прочитано тихим, а вход молчит —
+    // в кольце ниже kSleepEps: засыпаем без очистки
+    quiet_ = quiet;
+    if (quiet_ > sleepAfter) asleep_ = true;
+}
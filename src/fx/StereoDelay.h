@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include "fx/FxBase.h"
+
+// Стерео-дилей с темп-синком (доли такта от ProcessContext::tempoBpm через setTempo),
+// пинг-понгом, фильтрами в обратной связи (HP lowcut + LP highcut) и модуляцией времени.
+//  - Кольца — степень двойки под максимальную задержку (prepare), смена времени не аллоцирует.
+//  - Время скользит к цели one-pole'ом на частоте блоков (~80 мс) и линейной рампой внутри блока —
+//    без «молнии», с лёгким «ленточным» питчем на переходе.
+//  - Чтение — дробное, Эрмит по 4 точкам; 4 сэмпла × 2 канала = один f32x8 (интерполяция векторно,
+//    выборка отсчётов — скалярно). Минимальная задержка > 4 + 2 сэмплов, поэтому 4 чтения подряд
+//    не зависят от записей этих же 4 сэмплов.
+// RT: process() без аллокаций; тишина на входе + погасшие повторы → ранний выход.
+class StereoDelay final : public FxBase {
+public:
+    static constexpr float kMaxDelayMs = 4000.f; // 1/1 при 60 BPM
+    enum Param { kTime, kSync, kDivision, kFeedback, kPingPong, kLowCut, kHighCut, kModDepth, kModRate, kMix, kCount };
+
+    StereoDelay();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+    void setTempo(double bpm) override { if (bpm > 0.0) bpm_ = bpm; }
+
+private:
+    float targetDelay() const noexcept;   // сэмплы: из time (мс) или доли такта при sync
+
+    std::vector<float> bufL_, bufR_;      // кольца (2^k)
+    int mask_ = 0;
+    int writePos_ = 0;
+
+    double bpm_ = 120.0;
+    float delay_ = 0.f;                   // текущая задержка (сэмплы), скользит к цели
+    float lfoS_ = 0.f, lfoC_ = 1.f;       // квадратурный LFO
+    float lpL_ = 0.f, lpR_ = 0.f;         // highcut (LP) в петле
+    float hpL_ = 0.f, hpR_ = 0.f;         // lowcut: LP-состояние, HP = x − lp
+    int   quiet_ = 0;
+    bool  asleep_ = true;
+    bool  primed_ = false;
+};
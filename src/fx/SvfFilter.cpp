@@ -0,0 +1,233 @@
+#include "fx/SvfFilter.h"
+#include "utils/FastMath.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+const FxParamDesc kSvfParams[] = {
+    {"mode",   "Mode",   FxParamType::Enum,  0.f,   3.f,     0.f,     1.f}, // LP/HP/BP/Notch
+    {"cutoff", "Cutoff", FxParamType::Float, 20.f,  20000.f, 1000.f,  0.f},
+    {"q",      "Q",      FxParamType::Float, 0.5f,  20.f,    0.707f,  0.f},
+    {"mix",    "Mix",    FxParamType::Float, 0.f,   1.f,     1.f,     0.f},
+};
+
+const FxParamDesc kBankParams[] = {
+    {"bands", "Bands", FxParamType::Enum,  4.f,   8.f,     4.f,    4.f},
+    {"low",   "Low",   FxParamType::Float, 20.f,  20000.f, 100.f,  0.f},
+    {"high",  "High",  FxParamType::Float, 20.f,  20000.f, 8000.f, 0.f},
+    {"q",     "Q",     FxParamType::Float, 0.5f,  20.f,    4.f,    0.f},
+    {"mix",   "Mix",   FxParamType::Float, 0.f,   1.f,     1.f,    0.f},
+    {"gain0", "Band 1", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain1", "Band 2", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain2", "Band 3", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain3", "Band 4", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain4", "Band 5", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain5", "Band 6", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain6", "Band 7", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+    {"gain7", "Band 8", FxParamType::Float, 0.f,  2.f,     1.f,    0.f},
+};
+static_assert(std::size(kSvfParams) == SvfFilter::kCount);
+static_assert(std::size(kBankParams) == SvfBank::kCount);
+
+constexpr float kSleepEps = 1e-7f;  // ниже — состояние считаем погасшим
+constexpr float kFlushEps = 1e-20f; // денормалы в состояниях → 0
+
+// g = tan(π·fc/sr): предискажение среза (fc ограничен 0.49·sr — tan не уходит в бесконечность)
+float cutoffG(float fc, int sr) noexcept {
+    const float f = std::min(fc, 0.49f * (float)sr);
+    return std::tan(fastmath::kPi * f / (float)sr);
+}
+
+void setMode(SvfLanes<simd::f32x4>& s, SvfMode m) noexcept {
+    s.cLP = s.cBP = s.cHP = s.cN = simd::f32x4{};
+    switch (m) {
+    case SvfMode::LowPass:  s.cLP = simd::splat4(1.f); break;
+    case SvfMode::HighPass: s.cHP = simd::splat4(1.f); break;
+    case SvfMode::BandPass: s.cBP = simd::splat4(1.f); break;
+    case SvfMode::Notch:    s.cN  = simd::splat4(1.f); break;
+    }
+}
+
+// Тихо ли всё: вход нулевой и состояния погасли → фильтр выдаст (почти) ноль, обработку пропускаем
+bool silent(const float* L, const float* R, int n) noexcept {
+    float peak = 0.f;
+    for (int i = 0; i < n; ++i) peak = std::max(peak, std::max(std::fabs(L[i]), std::fabs(R[i])));
+    return peak == 0.f;
+}
+
+template<class V>
+bool asleep(const SvfLanes<V>& s) noexcept {
+    for (int i = 0; i < (int)(sizeof(V) / sizeof(float)); ++i)
+        if (std::fabs(s.ic1[i]) > kSleepEps || std::fabs(s.ic2[i]) > kSleepEps) return false;
+    return true;
+}
+
+// Денормалы в состояниях → 0 (f32x8 — по ссылке, см. Simd.h)
+void flushTiny(simd::f32x4& v) noexcept {
+    v = simd::select(simd::abs(v) < simd::splat4(kFlushEps), simd::f32x4{}, v);
+}
+void flushTiny(simd::f32x8& v) noexcept {
+    simd::f32x8 a, eps;
+    simd::abs(a, v);
+    simd::splat8(eps, kFlushEps);
+    simd::select(v, a < eps, simd::f32x8{}, v);
+}
+
+// Ядро: n сэмплов для всех лейнов s. in(i, v) пишет в v вход, out(i, y) принимает выход
+// (V — только по ссылке: f32x8 по значению меняет ABI без -mavx).
+// g и k идут линейной рампой от прошлого блока к целевым; a1..a3 — каждый сэмпл (одно деление на вектор).
+//   v3 = v0 − ic2;  v1 = a1·ic1 + a2·v3;  v2 = ic2 + a2·ic1 + a3·v3
+//   ic1 = 2·v1 − ic1;  ic2 = 2·v2 − ic2
+//   LP = v2, BP = k·v1 (единичный пик), HP = v0 − k·v1 − v2, Notch = v0 − k·v1
+template<class V, class In, class Out>
+inline void runSvf(SvfLanes<V>& s, const V& gT, const V& kT, int n, In in, Out out) noexcept {
+    if (!s.primed) { s.g = gT; s.k = kT; s.primed = true; }
+    const float inv = 1.f / (float)n;
+    const V dg = (gT - s.g) * inv, dk = (kT - s.k) * inv;
+    const V one = V{} + 1.f;
+
+    V g = s.g, k = s.k, ic1 = s.ic1, ic2 = s.ic2;
+    for (int i = 0; i < n; ++i) {
+        g += dg; k += dk;
+        const V a1 = one / (one + g * (g + k));
+        const V a2 = g * a1, a3 = g * a2;
+
+        V v0;
+        in(i, v0);
+        const V v3 = v0 - ic2;
+        const V v1 = a1 * ic1 + a2 * v3;
+        const V v2 = ic2 + a2 * ic1 + a3 * v3;
+        ic1 = v1 + v1 - ic1;
+        ic2 = v2 + v2 - ic2;
+
+        const V kv1 = k * v1;
+        out(i, s.cLP * v2 + s.cBP * kv1 + s.cHP * (v0 - kv1 - v2) + s.cN * (v0 - kv1));
+    }
+
+    flushTiny(ic1);
+    flushTiny(ic2);
+    s.ic1 = ic1;
+    s.ic2 = ic2;
+    s.g = gT; s.k = kT; // рампа закончилась ровно на цели — без дрейфа
+}
+
+} // namespace
+
+// ---------------------------------------------------------------- SvfFilter
+
+SvfFilter::SvfFilter() : FxBase(kSvfParams) {}
+
+void SvfFilter::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    reset();
+}
+
+void SvfFilter::reset() { st_.reset(); }
+
+void SvfFilter::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0) return;
+    const ParamSmoother& mix = smoothed(kMix, nframes);
+    if (asleep(st_) && silent(L, R, nframes)) { st_.primed = false; return; }
+
+    setMode(st_, (SvfMode)std::clamp((int)value(kMode), 0, 3));
+    const simd::f32x4 gT = simd::splat4(cutoffG(value(kCutoff), sr_));
+    const simd::f32x4 kT = simd::splat4(1.f / value(kQ));
+
+    runSvf(st_, gT, kT, nframes,
+           [&](int i, simd::f32x4& v) { v = simd::f32x4{L[i], R[i], 0.f, 0.f}; },
+           [&](int i, const simd::f32x4& y) {
+               const float m = mix.at(i);
+               L[i] += m * (y[0] - L[i]);
+               R[i] += m * (y[1] - R[i]);
+           });
+}
+
+// ---------------------------------------------------------------- SvfBank
+
+SvfBank::SvfBank() : FxBase(kBankParams) {
+    for (auto& s : st_) simd::splat8(s.cBP, 1.f);
+}
+
+void SvfBank::prepare(int sampleRate, int blockSize) {
+    sr_ = sampleRate > 0 ? sampleRate : 48000;
+    bs_ = blockSize > 0 ? blockSize : 512;
+    reset();
+}
+
+void SvfBank::reset() {
+    for (auto& s : st_) s.reset();
+}
+
+void SvfBank::process(float* L, float* R, int nframes) {
+    if (bypass() || nframes <= 0) return;
+
+    const int bands = value(kBands) >= 8.f ? 8 : 4;
+    if (bands != bands_) { // вторая четвёрка полос включилась/выключилась — её состояние устарело
+        st_[1].reset();
+        bands_ = bands;
+    }
+    const int sets = bands_ / 4;
+    const ParamSmoother& mix = smoothed(kMix, nframes);
+
+    bool sleeping = true;
+    for (int s = 0; s < sets; ++s) sleeping = sleeping && asleep(st_[s]);
+    if (sleeping && silent(L, R, nframes)) {
+        for (auto& s : st_) s.primed = false;
+        return;
+    }
+
+    // Полосы — лог-разнос low..high (по краям — ровно low и high)
+    const float lo = std::max(20.f, std::min(value(kLow), value(kHigh)));
+    const float hi = std::max(lo, std::max(value(kLow), value(kHigh)));
+    const float ratio = bands_ > 1 ? std::pow(hi / lo, 1.f / (float)(bands_ - 1)) : 1.f;
+    const float k = 1.f / value(kQ);
+
+    simd::f32x8 gT[2], gain[2];
+    float fc = lo;
+    for (int b = 0; b < bands_; ++b, fc *= ratio) {
+        const float g = cutoffG(fc, sr_);
+        const float w = value(kGain0 + b);
+        gT[b / 4][(b % 4) * 2] = gT[b / 4][(b % 4) * 2 + 1] = g;
+        gain[b / 4][(b % 4) * 2] = gain[b / 4][(b % 4) * 2 + 1] = w;
+    }
+    simd::f32x8 kT;
+    simd::splat8(kT, k);
+
+    // Лейны b0L b0R b1L b1R …: чётные → L, нечётные → R. Блок режем на куски по kChunk:
+    // выход набора полос копится во взвешенном acc (стек), второй набор (8 полос) добавляется к нему.
+    // Цель рампы куска — точка на общей рампе блока, так что 4 и 8 полос звучат одинаково гладко.
+    constexpr int kChunk = 64;
+    simd::f32x8 g0[2], k0[2];
+    for (int s = 0; s < sets; ++s) {
+        if (!st_[s].primed) { st_[s].g = gT[s]; st_[s].k = kT; st_[s].primed = true; }
+        g0[s] = st_[s].g;
+        k0[s] = st_[s].k;
+    }
+
+    for (int off = 0; off < nframes; ) {
+        const int n = std::min(kChunk, nframes - off);
+        const float t = (float)(off + n) / (float)nframes;
+        float* l = L + off;
+        float* r = R + off;
+        simd::f32x8 acc[kChunk];
+        for (int i = 0; i < n; ++i) acc[i] = simd::f32x8{};
+
+        for (int s = 0; s < sets; ++s) {
+            runSvf(st_[s], g0[s] + (gT[s] - g0[s]) * t, k0[s] + (kT - k0[s]) * t, n,
+                   [&](int i, simd::f32x8& v) { v = simd::f32x8{l[i], r[i], l[i], r[i], l[i], r[i], l[i], r[i]}; },
+                   [&](int i, const simd::f32x8& y) { acc[i] += y * gain[s]; });
+        }
+        for (int i = 0; i < n; ++i) {
+            const simd::f32x8 y = acc[i];
+            const float wl = (y[0] + y[2]) + (y[4] + y[6]);
+            const float wr = (y[1] + y[3]) + (y[5] + y[7]);
+            const float m = mix.at(off + i);
+            l[i] += m * (wl - l[i]);
+            r[i] += m * (wr - r[i]);
+        }
+        off += n;
+    }
+}
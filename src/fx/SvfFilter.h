@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include "fx/FxBase.h"
+#include "utils/Simd.h"
+
+// ZDF state-variable filter (топология Саймона/Cytomic): устойчив при любой модуляции среза.
+// Все режимы — один и тот же контур, выход = cLP·LP + cBP·BP + cHP·HP + cN·Notch,
+// поэтому лейны с разными режимами/частотами считаются одним вектором.
+// Коэффициенты (g, k) интерполируются линейно по блоку от прошлых значений к новым — без zipper-шума.
+// RT: process() без аллокаций; тихий вход + погасшие состояния → ранний выход (64 трека «спят» бесплатно).
+
+enum class SvfMode : uint8_t { LowPass, HighPass, BandPass, Notch };
+
+// Состояние набора лейнов (V — f32x4 или f32x8). Лейн = независимый фильтр:
+// L/R одного фильтра или «полоса × канал» банка. Алгоритм — в SvfFilter.cpp.
+template<class V>
+struct SvfLanes {
+    V ic1{}, ic2{};                 // состояния интеграторов
+    V g{}, k{};                     // текущие коэффициенты (после рампы)
+    V cLP{}, cBP{}, cHP{}, cN{};    // веса выходов по режиму
+    bool primed = false;            // первый блок — без рампы
+
+    void reset() noexcept { ic1 = ic2 = V{}; primed = false; }
+};
+
+// Одиночный фильтр: L и R в лейнах 0/1 одного вектора
+class SvfFilter final : public FxBase {
+public:
+    enum Param { kMode, kCutoff, kQ, kMix, kCount };
+
+    SvfFilter();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+
+private:
+    SvfLanes<simd::f32x4> st_;      // лейны: L, R, -, -
+};
+
+// Банк полос: 4 или 8 band-pass полос (лог-разнос low..high) параллельно, L/R каждой в своём лейне.
+// 4 полосы = один f32x8, 8 полос = два. Выход — сумма полос с пер-полосным гейном.
+class SvfBank final : public FxBase {
+public:
+    static constexpr int kMaxBands = 8;
+    enum Param { kBands, kLow, kHigh, kQ, kMix, kGain0, kCount = kGain0 + kMaxBands };
+
+    SvfBank();
+    void prepare(int sampleRate, int blockSize) override;
+    void reset() override;
+    void process(float* L, float* R, int nframes) override;
+
+private:
+    SvfLanes<simd::f32x8> st_[kMaxBands / 4]; // [полосы 0..3], [полосы 4..7]; лейны b0L b0R b1L b1R …
+    int bands_ = 4;
+};
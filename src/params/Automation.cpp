@@ -0,0 +1,122 @@
+#include "params/Automation.h"
+#include <algorithm>
+
+// ----------------- AutomationLane -----------------
+float AutomationLane::eval(double beat) const noexcept {
+    const size_t n = points.size();
+    if (n == 0) return 0.f;
+    if (n == 1 || beat <= points.front().beat) return points.front().value;
+    if (beat >= points.back().beat) return points.back().value;
+
+    // здесь front.beat < beat < back.beat → сегмент c ∈ [0, n−2]
+    size_t c = cursor_;
+    if (c + 1 >= n || beat < points[c].beat) { // назад (луп/перемотка) или курсор устарел
+        const auto it = std::upper_bound(points.begin(), points.end(), beat,
+                                         [](double b, const AutoPoint& p) { return b < p.beat; });
+        c = (size_t)(it - points.begin()) - 1;
+    }
+    while (beat >= points[c + 1].beat) ++c;    // вперёд: обычно 0–1 шаг на блок
+    cursor_ = c;
+
+    const AutoPoint& a = points[c];
+    const AutoPoint& b = points[c + 1];
+    const double t = (beat - a.beat) / (b.beat - a.beat);
+    return a.value + (b.value - a.value) * (float)t;
+}
+
+void AutomationLane::record(double from, double beat, float value) {
+    // from == beat (транспорт стоит / первая точка прохода) — заменяем точку в этом же бите
+    const auto lo = from < beat
+            ? std::upper_bound(points.begin(), points.end(), from, [](double b, const AutoPoint& p) { return b < p.beat; })
+            : std::lower_bound(points.begin(), points.end(), beat, [](const AutoPoint& p, double b) { return p.beat < b; });
+    const auto hi = std::upper_bound(lo, points.end(), beat,
+                                     [](double b, const AutoPoint& p) { return b < p.beat; });
+    const auto at = points.erase(lo, hi);
+    points.insert(at, AutoPoint{beat, value});
+}
+
+// ----------------- AutomationEngine: UI -----------------
+AutomationLane& AutomationEngine::draftLane(ParamHandle h) {
+    auto it = index_.find(h.index);
+    if (it != index_.end()) return draft_[it->second];
+    index_.emplace(h.index, draft_.size());
+    draft_.emplace_back();
+    draft_.back().handle = h;
+    return draft_.back();
+}
+
+void AutomationEngine::setLane(ParamHandle h, std::vector<AutoPoint> points) {
+    if (!h) return;
+    std::sort(points.begin(), points.end(), [](const AutoPoint& a, const AutoPoint& b) { return a.beat < b.beat; });
+    draftLane(h).points = std::move(points);
+}
+
+void AutomationEngine::clearLane(ParamHandle h) {
+    auto it = index_.find(h.index);
+    if (it == index_.end()) return;
+    const size_t i = it->second;
+    index_.erase(it);
+    if (i + 1 != draft_.size()) {
+        draft_[i] = std::move(draft_.back());
+        index_[draft_[i].handle.index] = i;
+    }
+    draft_.pop_back();
+}
+
+void AutomationEngine::clear() {
+    draft_.clear();
+    index_.clear();
+    lastRec_.clear();
+}
+
+const AutomationLane* AutomationEngine::lane(ParamHandle h) const {
+    auto it = index_.find(h.index);
+    return it == index_.end() ? nullptr : &draft_[it->second];
+}
+
+void AutomationEngine::arm(bool on) {
+    armed_.store(on, std::memory_order_relaxed);
+    if (on) return;
+    for (auto& l : draft_) l.touched = false; // запись кончилась — полосы снова играют
+    lastRec_.clear();
+    publish();
+}
+
+void AutomationEngine::record(ParamHandle h, float value) {
+    if (!h || !armed()) return;
+    const double beat = position();
+    AutomationLane& l = draftLane(h);
+    auto [it, fresh] = lastRec_.try_emplace(h.index, beat);
+    l.record(fresh ? beat : std::min(it->second, beat), beat, value);
+    it->second = beat;
+    if (!l.touched) { l.touched = true; publish(); } // первое касание — сразу отключить воспроизведение
+}
+
+void AutomationEngine::publish() {
+    std::shared_ptr<const Lanes> old;
+    while (retire_.pop(old)) old.reset();      // копии, с которых ушло аудио, — освобождаем здесь
+    std::atomic_store_explicit(&live_, std::make_shared<const Lanes>(draft_), std::memory_order_release);
+}
+
+// ----------------- AutomationEngine: аудио -----------------
+void AutomationEngine::process(IParameterStore& store, double blockEndBeats, bool playing) noexcept {
+    ParamValues* vals = store.values();
+    if (!vals) return;
+
+    // новую копию берём, только если есть куда сдать текущую (retire_ полно — UI давно не публиковал)
+    auto live = retire_.writeView(1).empty() ? current_ : std::atomic_load_explicit(&live_, std::memory_order_acquire);
+    if (live != current_ || vals != flagged_) { // новая копия / новая раскладка стора — флаги заново
+        if (current_ && vals == flagged_) for (const auto& l : *current_) vals->setAutomated(l.handle, false);
+        if (current_ && live != current_) retire_.push(std::move(current_)); // место проверено выше
+        current_ = std::move(live);
+        flagged_ = vals;
+        if (current_) for (const auto& l : *current_) vals->setAutomated(l.handle, !l.touched && !l.points.empty());
+    }
+    if (!playing || !current_) return;
+
+    for (const AutomationLane& l : *current_) {
+        if (l.touched || l.points.empty() || l.handle.index >= vals->size()) continue;
+        const float v = l.eval(blockEndBeats);
+        if (v != vals->get(l.handle)) store.set(l.handle, v);
+    }
+}
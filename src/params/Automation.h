@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "params/Param.h"
+#include "utils/SpscRing.h"
+
+struct AutoPoint {
+    double beat = 0.0;
+    float  value = 0.f;
+};
+
+// Полоса автоматизации одного параметра: ломаная по битам транспорта.
+// eval() держит курсор сегмента: при движении вперёд — O(1) амортизированно (обычно 0 шагов),
+// скачок назад (луп/перемотка) — бинарный поиск. До первой точки — первое значение, после последней — последнее.
+class AutomationLane {
+public:
+    ParamHandle handle;
+    std::vector<AutoPoint> points;   // по возрастанию beat
+    bool touched = false;            // пишется запись с UI — воспроизведение полосы молчит
+
+    float eval(double beat) const noexcept;
+    // НЕ RT: запись хода ручки — точки в (from, beat] (при from == beat — в самом beat) заменяются одной
+    void  record(double from, double beat, float value);
+
+private:
+    mutable size_t cursor_ = 0;      // только аудио-поток
+};
+
+// Автоматизация параметров стора.
+//  - Редактирование/запись — UI-поток над черновиком; publish() отдаёт неизменяемую копию аудио
+//    (atomic shared_ptr, как банки/сэмплы в нодах). Копию, с которой аудио ушло, оно не отпускает
+//    само (последняя ссылка = free), а сдаёт в retire_ — её освобождает следующий publish() на UI.
+//  - process() — аудио-поток, раз в блок: значение полосы в КОНЦЕ блока → IParameterStore::set;
+//    параметр помечен automated (ParamValues). Рампа ровно в блок (ломаная сэмпл-точно, излом
+//    внутри блока — линейно через блок) — только у читателей, смотрящих на флаг: SmootherBank
+//    и громкость SynthNode. Ручки, читаемые снимком раз в блок (ParamSnapshot: банки SamplerNode,
+//    трек SynthNode), меняются ступенькой на границе блока; параметры FX живут вне стора
+//    (FxBase) и автоматизации не доступны.
+//    Сотни полос = сотни eval + сравнений на блок.
+//  - Запись (arm): UI-ходы ручек → record(handle, value) в позиции транспорта; такие полосы
+//    на время записи не воспроизводятся (touch).
+class AutomationEngine {
+public:
+    using Lanes = std::vector<AutomationLane>;
+
+    // ---- UI-поток, НЕ RT ----
+    void setLane(ParamHandle h, std::vector<AutoPoint> points);
+    void clearLane(ParamHandle h);
+    void clear();
+    void arm(bool on);
+    bool armed() const { return armed_.load(std::memory_order_relaxed); }
+    void record(ParamHandle h, float value);
+    void publish();
+    const AutomationLane* lane(ParamHandle h) const;
+
+    // позиция транспорта (биты), которую последним видел аудио-поток — для записи
+    double position() const { return pos_.load(std::memory_order_relaxed); }
+
+    // ---- аудио-поток ----
+    void setPosition(double beats) noexcept { pos_.store(beats, std::memory_order_relaxed); }
+    void process(IParameterStore& store, double blockEndBeats, bool playing) noexcept;
+
+private:
+    AutomationLane& draftLane(ParamHandle h);
+
+    Lanes draft_;
+    std::unordered_map<uint32_t, size_t> index_;       // handle → draft_
+    std::unordered_map<uint32_t, double> lastRec_;     // handle → бит последней записанной точки
+
+    std::shared_ptr<const Lanes> live_;                // atomic_load/store
+    std::shared_ptr<const Lanes> current_;             // аудио: применяемая копия
+    SpscRing<std::shared_ptr<const Lanes>, 16> retire_; // аудио → UI: отработавшие копии
+    const ParamValues* flagged_ = nullptr;             // у какого массива расставлены automated
+
+    std::atomic<bool>   armed_{false};
+    std::atomic<double> pos_{0.0};
+};
@@ -0,0 +1,217 @@
+#include "params/Morph.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "utils/Simd.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'A', 'M', 'S', '1'};
+
+template<class T> void put(std::vector<uint8_t>& b, const T& v) {
+    const auto* p = reinterpret_cast<const uint8_t*>(&v);
+    b.insert(b.end(), p, p + sizeof v);
+}
+
+template<class T> bool get(std::span<const uint8_t> b, size_t& pos, T& v) {
+    if (b.size() - pos < sizeof v) return false;
+    std::memcpy(&v, b.data() + pos, sizeof v);
+    pos += sizeof v;
+    return true;
+}
+
+} // namespace
+
+// ----------------- MixSnapshot -----------------
+MixSnapshot MixSnapshot::capture(IParameterStore& store) {
+    MixSnapshot s;
+    const ParamValues* vals = store.values();
+    if (!vals) return s;
+    const uint32_t n = (uint32_t)vals->size();
+    s.values.resize(n);
+    s.ids.reserve(n);
+    vals->copy({0, n}, s.values.data());
+    for (uint32_t i = 0; i < n; ++i) {
+        const IParam* p = store.param(ParamHandle{i});
+        s.ids.push_back(p ? p->meta().id : std::string{});
+    }
+    return s;
+}
+
+std::vector<uint8_t> MixSnapshot::toBlob() const {
+    std::vector<uint8_t> b;
+    const uint32_t n = (uint32_t)std::min(ids.size(), values.size());
+    b.reserve(8 + n * sizeof(float) + n * 24);
+    b.insert(b.end(), kMagic, kMagic + 4);
+    put(b, n);
+    const auto* v = reinterpret_cast<const uint8_t*>(values.data());
+    b.insert(b.end(), v, v + n * sizeof(float));
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint16_t len = (uint16_t)std::min<size_t>(ids[i].size(), 0xFFFF);
+        put(b, len);
+        b.insert(b.end(), ids[i].begin(), ids[i].begin() + len);
+    }
+    return b;
+}
+
+bool MixSnapshot::fromBlob(std::span<const uint8_t> blob, MixSnapshot& out) {
+    size_t pos = 0;
+    uint32_t n = 0;
+    if (blob.size() < 8 || std::memcmp(blob.data(), kMagic, 4) != 0) return false;
+    pos = 4;
+    if (!get(blob, pos, n) || (blob.size() - pos) / sizeof(float) < n) return false;
+    MixSnapshot s;
+    s.values.resize(n);
+    std::memcpy(s.values.data(), blob.data() + pos, n * sizeof(float));
+    pos += n * sizeof(float);
+    s.ids.resize(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        uint16_t len = 0;
+        if (!get(blob, pos, len) || blob.size() - pos < len) return false;
+        s.ids[i].assign(reinterpret_cast<const char*>(blob.data() + pos), len);
+        pos += len;
+    }
+    out = std::move(s);
+    return true;
+}
+
+// ----------------- MorphEngine -----------------
+void MorphEngine::prepare(IParameterStore& store) {
+    const ParamValues* vals = store.values();
+    n_ = vals ? (int)vals->size() : 0;
+    slots_.assign((size_t)kMaxSlots * (size_t)n_, 0.f);
+    out_.assign((size_t)n_, 0.f);
+    curve_.assign((size_t)n_, MorphCurve::Linear);
+    loaded_.fill(false);
+    for (int i = 0; i < n_; ++i) {
+        const IParam* p = store.param(ParamHandle{(uint32_t)i});
+        if (!p) continue;
+        const ParamMeta& m = p->meta();
+        if (m.type != ParamType::kFloat)             curve_[(size_t)i] = MorphCurve::Step;
+        else if (m.min > 0.f && m.max >= 20.f * m.min) curve_[(size_t)i] = MorphCurve::Log;
+    }
+    for (auto& w : weights_) w.store(0.f, std::memory_order_relaxed);
+    prefer_.store(-1, std::memory_order_relaxed);
+    current_.reset();                   // аудио стоит: раскладка новая, старые списки не нужны
+    publishLists();
+    seen_ = gen_.load(std::memory_order_relaxed);
+}
+
+void MorphEngine::publishLists() {
+    std::shared_ptr<const Lists> old;
+    while (retire_.pop(old)) old.reset();      // списки, с которых ушло аудио, — освобождаем здесь
+    auto l = std::make_shared<Lists>();
+    for (int i = 0; i < n_; ++i) {
+        if (curve_[(size_t)i] == MorphCurve::Log)  l->logIdx.push_back((uint32_t)i);
+        if (curve_[(size_t)i] == MorphCurve::Step) l->stepIdx.push_back((uint32_t)i);
+    }
+    std::atomic_store_explicit(&live_, std::shared_ptr<const Lists>(std::move(l)), std::memory_order_release);
+}
+
+void MorphEngine::setCurve(ParamHandle h, MorphCurve c) {
+    if (!h || (int)h.index >= n_) return;
+    curve_[h.index] = c;
+    publishLists();
+    gen_.fetch_add(1, std::memory_order_release); // пересчитать морф с новыми кривыми
+}
+
+bool MorphEngine::load(IParameterStore& store, int slot, const MixSnapshot& s) {
+    if (slot < 0 || slot >= kMaxSlots || n_ == 0) return false;
+    float* dst = slots_.data() + (size_t)slot * (size_t)n_;
+    store.values()->copy({0, (uint32_t)n_}, dst); // чего нет в снимке — остаётся текущим
+    for (size_t i = 0; i < s.ids.size() && i < s.values.size(); ++i) {
+        const ParamHandle h = store.handle(s.ids[i]);
+        if (h && (int)h.index < n_) dst[h.index] = s.values[i];
+    }
+    loaded_[(size_t)slot] = true;
+    return true;
+}
+
+void MorphEngine::setWeights(std::span<const float> w) noexcept { storeWeights(w, -1); }
+
+void MorphEngine::storeWeights(std::span<const float> w, int prefer) noexcept {
+    for (int k = 0; k < kMaxSlots; ++k) {
+        const float x = k < (int)w.size() ? std::max(0.f, w[(size_t)k]) : 0.f;
+        weights_[(size_t)k].store(x, std::memory_order_relaxed);
+    }
+    prefer_.store(prefer, std::memory_order_relaxed);
+    gen_.fetch_add(1, std::memory_order_release);
+}
+
+void MorphEngine::setMorph(int slotA, int slotB, float t) noexcept {
+    std::array<float, kMaxSlots> w{};
+    t = std::clamp(t, 0.f, 1.f);
+    if (slotA >= 0 && slotA < kMaxSlots) w[(size_t)slotA] += 1.f - t;
+    if (slotB >= 0 && slotB < kMaxSlots) w[(size_t)slotB] += t;
+    storeWeights(w, slotB);
+}
+
+void MorphEngine::process(IParameterStore& store) noexcept {
+    const uint32_t g = gen_.load(std::memory_order_acquire);
+    if (g == seen_ || n_ == 0) return; // веса не двигались — параметры свободны (ручки/автоматизация)
+
+    // новые списки кривых — только если есть куда сдать текущие (retire_ полно — UI давно не публиковал);
+    // иначе поколение не засчитываем и пробуем в следующем блоке
+    if (retire_.writeView(1).empty()) return;
+    if (auto live = std::atomic_load_explicit(&live_, std::memory_order_acquire); live != current_) {
+        if (current_) retire_.push(std::move(current_)); // место проверено выше
+        current_ = std::move(live);
+    }
+    if (!current_) return;
+    seen_ = g;
+
+    // активные слоты и нормированные веса
+    int   idx[kMaxSlots];
+    float w[kMaxSlots];
+    int   m = 0;
+    float sum = 0.f;
+    for (int k = 0; k < kMaxSlots; ++k) {
+        const float x = weights_[(size_t)k].load(std::memory_order_relaxed);
+        if (x > 0.f && loaded_[(size_t)k]) { idx[m] = k; w[m] = x; sum += x; ++m; }
+    }
+    if (m == 0) return;
+    for (int j = 0; j < m; ++j) w[j] /= sum;
+
+    // Linear: out = Σ wⱼ·slotⱼ — векторно по всему массиву
+    const size_t n = (size_t)n_;
+    float* out = out_.data();
+    const float* s0 = slots_.data() + (size_t)idx[0] * n;
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            simd::f32x8 v;
+            simd::load8(v, s0 + i);
+            simd::store8(out + i, w[0] * v);
+        }
+        for (; i < n; ++i) out[i] = w[0] * s0[i];
+    }
+    for (int j = 1; j < m; ++j) {
+        const float* s = slots_.data() + (size_t)idx[j] * n;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            simd::f32x8 acc, v;
+            simd::load8(acc, out + i);
+            simd::load8(v, s + i);
+            simd::store8(out + i, acc + w[j] * v);
+        }
+        for (; i < n; ++i) out[i] += w[j] * s[i];
+    }
+
+    // Log: exp(Σ wⱼ·ln vⱼ)
+    for (uint32_t i : current_->logIdx) {
+        float acc = 0.f;
+        for (int j = 0; j < m; ++j) acc += w[j] * std::log(std::max(slots_[(size_t)idx[j] * n + i], 1e-9f));
+        out[i] = std::exp(acc);
+    }
+
+    // Step: снимок с наибольшим весом; равенство — в пользу B из setMorph (середина A→B — уже B),
+    // без него (setWeights) — слота с большим номером
+    const int prefer = prefer_.load(std::memory_order_relaxed);
+    int best = 0;
+    for (int j = 1; j < m; ++j)
+        if (w[j] > w[best] || (w[j] == w[best] && idx[best] != prefer)) best = j;
+    const float* sb = slots_.data() + (size_t)idx[best] * n;
+    for (uint32_t i : current_->stepIdx) out[i] = sb[i];
+
+    store.setValues(out, n);
+}
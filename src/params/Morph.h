@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "params/Param.h"
+#include "utils/SpscRing.h"
+
+// Снимок всех параметров стора (сцена/пресет микса). capture/toBlob/fromBlob — НЕ RT.
+// Blob — плоский бинарник: "AMS1", u32 count, count × f32 значений подряд, затем count id
+// (u16 длина + байты). Id хранятся, чтобы снимок пережил смену раскладки (новые/удалённые параметры).
+struct MixSnapshot {
+    std::vector<std::string> ids;
+    std::vector<float>       values;
+
+    static MixSnapshot capture(IParameterStore& store);
+    std::vector<uint8_t> toBlob() const;
+    static bool fromBlob(std::span<const uint8_t> blob, MixSnapshot& out);
+};
+
+// Кривая морфа параметра: Linear — Σ wₖ·vₖ; Log — геометрически (частоты/времена, min > 0);
+// Step — дискретные (Bool/Int/Enum): значение снимка с наибольшим весом (на двух — переключение в середине;
+// ровно в середине setMorph(A, B, 0.5) — уже B).
+enum class MorphCurve : uint8_t { Linear, Log, Step };
+
+// Морф между снимками на аудио-потоке, раз в блок.
+//  - prepare(store) — НЕ RT, при остановленном аудио: слоты kMaxSlots × все параметры в раскладке стора,
+//    кривые по ParamMeta;
+//  - load(slot, snapshot) — НЕ RT, сопоставление по id; слот, участвующий в морфе, не перезагружать;
+//  - setCurve() — НЕ RT, один поток (UI), на ходу: списки Log/Step собираются здесь же и публикуются
+//    целиком (как полосы AutomationEngine), отработавшую копию аудио сдаёт обратно в retire_;
+//  - setWeights()/setMorph() — любой поток (атомики), веса нормируются;
+//  - process(store) — RT: веса не менялись → ноль работы; иначе один векторный проход
+//    out = Σ wₖ·slotₖ по непрерывному массиву (f32x8), поправки Log/Step по спискам индексов,
+//    запись пачкой через IParameterStore::setValues (в журнал — только изменившиеся).
+class MorphEngine {
+public:
+    static constexpr int kMaxSlots = 8;
+
+    void prepare(IParameterStore& store);
+    bool load(IParameterStore& store, int slot, const MixSnapshot& s);
+    void setCurve(ParamHandle h, MorphCurve c);     // НЕ RT: переопределить авто-кривую
+
+    void setWeights(std::span<const float> w) noexcept;
+    void setMorph(int slotA, int slotB, float t) noexcept; // A → B, t ∈ [0, 1]
+
+    void process(IParameterStore& store) noexcept;
+
+    int  size() const noexcept { return n_; }
+
+private:
+    struct Lists { std::vector<uint32_t> logIdx, stepIdx; }; // индексы параметров не-Linear кривых
+
+    void publishLists();                // НЕ RT: списки из curve_ → live_
+    void storeWeights(std::span<const float> w, int prefer) noexcept;
+
+    int n_ = 0;
+    std::vector<float> slots_;          // [kMaxSlots × n_], слот k — подряд
+    std::vector<float> out_;            // [n_]
+    std::vector<MorphCurve> curve_;     // [n_], черновик НЕ RT-стороны
+    std::array<bool, kMaxSlots> loaded_{};
+
+    std::shared_ptr<const Lists> live_;                 // atomic_load/store
+    std::shared_ptr<const Lists> current_;              // аудио: применяемые списки
+    SpscRing<std::shared_ptr<const Lists>, 16> retire_; // аудио → UI: отработавшие копии
+
+    std::array<std::atomic<float>, kMaxSlots> weights_{};
+    std::atomic<int> prefer_{-1};       // слот, выигрывающий равенство весов в Step (B из setMorph)
+    std::atomic<uint32_t> gen_{0};      // растёт на каждый setWeights/setCurve
+    uint32_t seen_ = 0;                 // поколение, уже применённое в process()
+};
@@ -2,6 +2,12 @@
 #include <string>
 #include <functional>
 #include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
 enum class ParamType { kFloat, kInt, kBool, kEnum };
 struct ParamMeta {
     std::string id;     // "mixer.ch1.gain", "sampler.pad01.pitch"
@@ -14,35 +20,155 @@ struct IParam {
     virtual ~IParam() = default;
     virtual const ParamMeta& meta() const = 0;
     virtual float getFloat() const = 0;
-    virtual void  setFloat(float v) = 0; // thread-safe + smoothing
+    virtual void  setFloat(float v) = 0; // thread-safe; сглаживание — у потребителя (params/Smoothing.h)
+    // НЕ RT (commitParams): стор переносит значение в свой плоский массив — дальше параметр живёт там
+    virtual void  attach(std::atomic<float>* slot) { (void)slot; }
 };
 
 class ParamFloat : public IParam {
 public:
-    explicit ParamFloat(ParamMeta m) : meta_(std::move(m)), value_(meta_.def) {}
+    explicit ParamFloat(ParamMeta m) : meta_(std::move(m)), own_(meta_.def) {}
     const ParamMeta& meta() const override { return meta_; }
-    float getFloat() const override { return value_.load(std::memory_order_relaxed); }
-    void  setFloat(float v) override { value_.store(v, std::memory_order_relaxed); }
+    float getFloat() const override { return value_->load(std::memory_order_relaxed); }
+    void  setFloat(float v) override { value_->store(v, std::memory_order_relaxed); }
+    void  attach(std::atomic<float>* slot) override {
+        slot->store(value_->load(std::memory_order_relaxed), std::memory_order_relaxed);
+        value_ = slot;
+    }
 private:
     ParamMeta meta_;
-    std::atomic<float> value_;
+    std::atomic<float>  own_;            // до commitParams
+    std::atomic<float>* value_ = &own_;
+};
+
+// Интернированный id параметра: индекс в плоском массиве значений стора (ParamValues).
+// Резолвится один раз в bindParams (IParameterStore::handle), дальше — без строк и хешей.
+struct ParamHandle {
+    static constexpr uint32_t kInvalid = ~0u;
+    uint32_t index = kInvalid;
+    bool valid() const noexcept { return index != kInvalid; }
+    explicit operator bool() const noexcept { return valid(); }
+};
+
+// Значения всех параметров стора — один непрерывный массив atomic<float>, выровненный по кэш-линии.
+// Раскладка (commitParams): сначала глобальные, затем master, затем track.0, track.1, ... —
+// параметры одного трека (и соседних треков) лежат подряд, нода читает их одним проходом (copy).
+// get/set/copy/gather — RT, lock-free; init/setGroups — НЕ RT.
+class ParamValues {
+public:
+    static constexpr size_t kAlign = 64;
+    struct Range { uint32_t begin = 0, count = 0; };
+
+    ParamValues() = default;
+    ParamValues(const ParamValues&) = delete;
+    ParamValues& operator=(const ParamValues&) = delete;
+
+    void init(size_t n) {
+        const size_t cap = std::max<size_t>(n, 1);
+        auto* p = static_cast<std::atomic<float>*>(
+                ::operator new[](cap * sizeof(std::atomic<float>), std::align_val_t{kAlign}));
+        for (size_t i = 0; i < cap; ++i) new (p + i) std::atomic<float>(0.f);
+        v_.reset(p);
+        size_ = n;
+        groups_.assign(2, 0);
+        automated_.assign((n + 63) / 64, 0);
+    }
+    // groupBegin[g] — начало группы g (0 — глобальные, 1 — master, 2 + t — track.t), последний — size()
+    void setGroups(std::vector<uint32_t> groupBegin) { groups_ = std::move(groupBegin); }
+
+    size_t size() const noexcept { return size_; }
+    std::atomic<float>* slot(uint32_t i) noexcept { return v_.get() + i; }
+
+    float get(ParamHandle h) const noexcept { return v_[h.index].load(std::memory_order_relaxed); }
+    void  set(ParamHandle h, float v) noexcept { v_[h.index].store(v, std::memory_order_relaxed); }
+
+    // Параметр ведёт автоматизация (params/Automation.h): значение — точка в конце блока,
+    // сглаживатели идут к нему ровно за блок (без своей рампы). Аудио-поток.
+    void setAutomated(ParamHandle h, bool on) noexcept {
+        if (!h || h.index >= size_) return;
+        const uint64_t bit = uint64_t{1} << (h.index % 64);
+        automated_[h.index / 64] = on ? (automated_[h.index / 64] | bit) : (automated_[h.index / 64] & ~bit);
+    }
+    bool automated(ParamHandle h) const noexcept {
+        return h && h.index < size_ && (automated_[h.index / 64] >> (h.index % 64) & 1u);
+    }
+
+    // треков с параметрами: track.0 .. track.(trackCount−1)
+    int trackCount() const noexcept { return std::max(0, (int)groups_.size() - 3); }
+    // параметры трека (kMasterTrack = −1 — мастер); нет таких — пустой диапазон
+    Range trackRange(int track) const noexcept { return tracksRange(track, 1); }
+    // count треков подряд начиная с first — тоже один непрерывный диапазон
+    Range tracksRange(int first, int count) const noexcept {
+        const int g0 = std::max(first + 2, 1);
+        const int g1 = std::min(first + 2 + count, (int)groups_.size() - 1);
+        if (g1 <= g0) return {};
+        return {groups_[(size_t)g0], groups_[(size_t)g1] - groups_[(size_t)g0]};
+    }
+
+    // out[k] = значение (r.begin + k)
+    void copy(Range r, float* out) const noexcept {
+        const std::atomic<float>* src = v_.get() + r.begin;
+        for (uint32_t k = 0; k < r.count; ++k) out[k] = src[k].load(std::memory_order_relaxed);
+    }
+    // out[k] = значение hs[k] (невалидный хэндл → 0)
+    void gather(std::span<const ParamHandle> hs, float* out) const noexcept {
+        for (size_t k = 0; k < hs.size(); ++k) out[k] = hs[k] ? get(hs[k]) : 0.f;
+    }
+
+private:
+    struct Free {
+        void operator()(std::atomic<float>* p) const noexcept { ::operator delete[](p, std::align_val_t{kAlign}); }
+    };
+    std::unique_ptr<std::atomic<float>[], Free> v_;
+    size_t size_ = 0;
+    std::vector<uint32_t> groups_;
+    std::vector<uint64_t> automated_;
+};
+
+// Блочный снимок диапазона значений: update() раз в блок (один линейный проход по массиву стора),
+// дальше нода читает свои ручки из локального буфера по хэндлам. reserve() — НЕ RT.
+class ParamSnapshot {
+public:
+    void reserve(size_t n) { buf_.assign(n, 0.f); }
+    void update(const ParamValues& v, ParamValues::Range r) noexcept {
+        r.count = std::min<uint32_t>(r.count, (uint32_t)buf_.size());
+        v.copy(r, buf_.data());
+        range_ = r;
+    }
+    bool  contains(ParamHandle h) const noexcept { return h.index - range_.begin < range_.count; }
+    float operator[](ParamHandle h) const noexcept { return buf_[h.index - range_.begin]; } // h ∈ range()
+    ParamValues::Range range() const noexcept { return range_; }
+
+private:
+    std::vector<float> buf_;
+    ParamValues::Range range_;
 };
 
 struct IParameterStore {
     virtual ~IParameterStore() = default;
     virtual IParam* find(const std::string& id) = 0;
+    // После commitParams: хэндл по id (НЕ RT — строка, один раз в bind), обратно — IParam
+    virtual ParamHandle handle(const std::string& id) = 0;
+    virtual IParam* param(ParamHandle h) = 0;
+    // Плоский массив значений (RT-чтение/запись по хэндлам); живёт до следующего commitParams
+    virtual ParamValues* values() = 0;
     virtual void add(std::unique_ptr<IParam> p) = 0;
     virtual void commitParams() = 0;
     virtual void commitListeners() = 0;
-        // Подписки для UI/контроллеров:
+        // Подписки для UI/контроллеров — вызываются ТОЛЬКО на UI-потоке:
     using Listener = std::function<void(const std::string& id, float value)>;
     virtual void addListener(Listener l) = 0;
-    virtual void notify(const std::string& id, float value) = 0; // вызывается при изменениях
+    virtual void notify(const std::string& id, float value) = 0; // UI-поток: синхронно, для правок из самого UI
     virtual void dumpMap() = 0;
-    // Можно вызывать из любого треда (UI/аудио).
-// Значение хранится в atomic<float>, чтение/запись lock-free.
-// Слушатели должны быть лёгкими и thread-safe.
-    bool set(const std::string& id, float value) noexcept;
+    // Запись из любого потока (в т.ч. аудио): значение — atomic<float>, изменение — бит в журнале
+    // (params/ParamJournal.h), без слушателей и строк на вызывающем потоке.
+    virtual bool set(ParamHandle h, float value) noexcept = 0;
+    // Пачкой: значения [0, n) в раскладке values() (морф снимков); в журнал — только изменившиеся
+    virtual void setValues(const float* src, size_t n) noexcept = 0;
+    // Аудио-поток, раз в блок: грязные параметры → кольцо журнала (схлопнуто по блоку)
+    virtual void flushChanges() noexcept = 0;
+    // UI-поток, с частотой кадров: изменения из журнала → слушатели; возвращает их число
+    virtual size_t dispatchChanges() = 0;
 };
 
 enum class ParamId : uint16_t {
@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include "params/Param.h"
+#include "utils/SpscRing.h"
+
+struct ParamChange {
+    ParamHandle handle;
+    float       value = 0.f;
+};
+
+// Журнал изменений параметров: аудио → UI без слушателей на аудио-потоке.
+//  - mark(h) — любой поток, один fetch_or в битсет «грязных» (повторы в блоке схлопываются);
+//  - flush() — аудио-поток в конце блока (единственный продюсер кольца): грязные хэндлы
+//    уходят в SPSC-кольцо с ТЕКУЩИМ значением — свип 768 параметров = 768 записей, не больше;
+//    кольцо полно — бит возвращается и уедет следующим блоком;
+//  - drain(f) — UI-поток с частотой кадров (единственный консюмер).
+// init() — НЕ RT (размер под число параметров стора).
+class ParamJournal {
+public:
+    static constexpr size_t kCapacity = 4096;
+
+    void init(size_t params) {
+        words_ = (params + 63) / 64;
+        dirty_ = std::make_unique<std::atomic<uint64_t>[]>(std::max<size_t>(words_, 1));
+        for (size_t i = 0; i < words_; ++i) dirty_[i].store(0, std::memory_order_relaxed);
+        ring_ = std::make_unique<SpscRing<ParamChange, kCapacity>>();
+    }
+
+    void mark(ParamHandle h) noexcept {
+        if (!h || h.index / 64 >= words_) return;
+        dirty_[h.index / 64].fetch_or(uint64_t{1} << (h.index % 64), std::memory_order_release);
+    }
+
+    // RT (аудио-поток): сбросить грязные в кольцо; возвращает число записей
+    size_t flush(const ParamValues& values) noexcept {
+        size_t pushed = 0;
+        for (size_t w = 0; w < words_; ++w) {
+            if (dirty_[w].load(std::memory_order_relaxed) == 0) continue;
+            uint64_t bits = dirty_[w].exchange(0, std::memory_order_acquire);
+            while (bits) {
+                const ParamHandle h{(uint32_t)(w * 64 + (size_t)std::countr_zero(bits))};
+                if (!ring_->push(ParamChange{h, values.get(h)})) {
+                    dirty_[w].fetch_or(bits, std::memory_order_relaxed); // не влезло — в следующий блок
+                    return pushed;
+                }
+                bits &= bits - 1;
+                ++pushed;
+            }
+        }
+        return pushed;
+    }
+
+    // UI-поток: f(ParamChange) на каждое изменение; возвращает число изменений
+    template<class F>
+    size_t drain(F&& f) {
+        return ring_ ? ring_->drain([&](const ParamChange& c) { f(c); }) : 0; // пачкой, без копий
+    }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> dirty_;
+    size_t words_ = 0;
+    std::unique_ptr<SpscRing<ParamChange, kCapacity>> ring_;
+};
@@ -1,6 +1,11 @@
 #pragma once
 #include "params/Param.h"
+#include "params/ParamJournal.h"
+#include "utils/TrackPath.h"
+#include <algorithm>
+#include <iostream>
 #include <mutex>
+#include <tuple>
 #include <unordered_map>
 #include <memory>
 
@@ -21,6 +26,7 @@ public:
         std::lock_guard<std::mutex> lk(mu_);
         mapSnap_ = std::make_shared<Map>(std::move(buildMap_));
         buildMap_.clear();
+        layoutSnap_ = buildLayout(*mapSnap_);
     }
     void commitListeners() override {               // вызвать ОДИН раз до старта аудио
         std::lock_guard<std::mutex> lk(mu_);
@@ -36,19 +42,55 @@ public:
         return (it == mapSnap_->end()) ? nullptr : it->second.get();
     }
 
-    // Установка значения + нотификация слушателей
+    // ---- хэндлы: резолв — НЕ RT (строка), значения — RT ----
+    ParamHandle handle(const std::string& id) override {
+        if (!layoutSnap_) return {};
+        auto it = layoutSnap_->index.find(id);
+        return it == layoutSnap_->index.end() ? ParamHandle{} : ParamHandle{it->second};
+    }
+    IParam* param(ParamHandle h) override {
+        if (!layoutSnap_ || !h || h.index >= layoutSnap_->byIndex.size()) return nullptr;
+        return layoutSnap_->byIndex[h.index];
+    }
+    ParamValues* values() override { return layoutSnap_ ? &layoutSnap_->values : nullptr; }
+
+    // Установка значения по id (НЕ RT — хеш строки); слушатели узнают через журнал
     bool set(const std::string& id, float value) noexcept {
-        if (!mapSnap_) return false;
-        auto it = mapSnap_->find(id);
-        if (it == mapSnap_->end()) return false;
+        return set(handle(id), value);
+    }
 
-        it->second->setFloat(value);   // меняем ТОЛЬКО в аудио-треде
+    // RT, любой поток: значение + бит в журнале (одна запись в кольцо на параметр за блок)
+    bool set(ParamHandle h, float value) noexcept override {
+        if (!layoutSnap_ || !h || h.index >= layoutSnap_->values.size()) return false;
+        layoutSnap_->values.set(h, value);
+        layoutSnap_->journal.mark(h);
+        return true;
+    }
 
-        if (lsSnap_) {                 // опциональная нотификация (дёшево)
-            for (auto& cb : *lsSnap_) cb(id, value);
+    void setValues(const float* src, size_t n) noexcept override {
+        if (!layoutSnap_) return;
+        Layout& l = *layoutSnap_;
+        n = std::min(n, l.values.size());
+        for (uint32_t i = 0; i < n; ++i) {
+            const ParamHandle h{i};
+            if (l.values.get(h) == src[i]) continue;
+            l.values.set(h, src[i]);
+            l.journal.mark(h);
         }
+    }
 
-        return true;
+    void flushChanges() noexcept override {
+        if (layoutSnap_) layoutSnap_->journal.flush(layoutSnap_->values);
+    }
+
+    size_t dispatchChanges() override {
+        if (!layoutSnap_) return 0;
+        Layout& l = *layoutSnap_;
+        return l.journal.drain([&](const ParamChange& c) {
+            if (!lsSnap_) return;
+            const std::string& id = l.byIndex[c.handle.index]->meta().id;
+            for (auto& cb : *lsSnap_) cb(id, c.value);
+        });
     }
 
     void notify(const std::string& id, float value) override {
@@ -65,6 +107,45 @@ public:
 private:
     using Map = std::unordered_map<std::string, std::unique_ptr<IParam>>;
 
+    // Раскладка значений: группа (глобальные, master, track.0, …) → id; параметры переезжают в массив
+    struct Layout {
+        ParamValues values;
+        ParamJournal journal;
+        std::vector<IParam*> byIndex;
+        std::unordered_map<std::string, uint32_t> index;
+    };
+    static std::shared_ptr<Layout> buildLayout(const Map& map) {
+        struct Entry { int group; const std::string* id; IParam* p; };
+        std::vector<Entry> order;
+        order.reserve(map.size());
+        int groups = 2;
+        for (const auto& [id, p] : map) {
+            TrackId t = 0;
+            const int g = TrackPath::trackOf(id, t) ? t + 2 : 0;
+            groups = std::max(groups, g + 1);
+            order.push_back({g, &id, p.get()});
+        }
+        std::sort(order.begin(), order.end(), [](const Entry& a, const Entry& b) {
+            return std::tie(a.group, *a.id) < std::tie(b.group, *b.id);
+        });
+
+        auto l = std::make_shared<Layout>();
+        l->values.init(order.size());
+        l->journal.init(order.size());
+        l->byIndex.resize(order.size());
+        l->index.reserve(order.size());
+        std::vector<uint32_t> begin((size_t)groups + 1, (uint32_t)order.size());
+        for (uint32_t i = (uint32_t)order.size(); i-- > 0;) begin[(size_t)order[i].group] = i;
+        for (int g = groups - 1; g >= 0; --g) begin[(size_t)g] = std::min(begin[(size_t)g], begin[(size_t)g + 1]);
+        l->values.setGroups(std::move(begin));
+        for (uint32_t i = 0; i < order.size(); ++i) {
+            order[i].p->attach(l->values.slot(i));
+            l->byIndex[i] = order[i].p;
+            l->index.emplace(*order[i].id, i);
+        }
+        return l;
+    }
+
     // build-структуры (меняются только в main до commit’ов)
     std::mutex              mu_;
     Map                     buildMap_;
@@ -73,4 +154,5 @@ private:
     // неизменяемые снапшоты после commit’ов (только читаются в RT)
     std::shared_ptr<Map>                     mapSnap_;
     std::shared_ptr<std::vector<Listener>>   lsSnap_;
+    std::shared_ptr<Layout>                  layoutSnap_;
 };
@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "params/Param.h"
+#include "utils/Simd.h"
+
+// x[i] *= from + (to − from)·(i+1)/n — линейная рампа усиления по блоку (векторно)
+inline void applyRamp(float* x, int n, float from, float to) noexcept {
+    int i = 0;
+    if (from == to) {
+        const simd::f32x4 g = simd::splat4(to);
+        for (; i + 4 <= n; i += 4) simd::store4(x + i, simd::load4(x + i) * g);
+        for (; i < n; ++i) x[i] *= to;
+        return;
+    }
+    const float step = (to - from) / (float)n;
+    simd::f32x4 v = simd::splat4(from) + simd::splat4(step) * simd::f32x4{1.f, 2.f, 3.f, 4.f};
+    const simd::f32x4 d = simd::splat4(4.f * step);
+    for (; i + 4 <= n; i += 4, v += d) simd::store4(x + i, simd::load4(x + i) * v);
+    for (; i < n; ++i) x[i] *= from + step * (float)(i + 1);
+}
+
+// Сглаживание непрерывных параметров на стороне потребителя (IParam хранит только цель).
+// Рампа линейная и целыми блоками: раз в блок advance() берёт цель и задаёт прирост на сэмпл,
+// значение внутри блока — start() + step()·(i+1). Новая цель посреди рампы — рампа от текущего.
+// Стоящий параметр: step() == 0, moving() == false — потребитель умножает на константу.
+// exact (автоматизация): цель — значение в конце блока, рампа ровно в один блок — сэмпл-точно.
+// RT: advance()/fill()/apply() — без аллокаций.
+class ParamSmoother {
+public:
+    static constexpr float kDefaultRampMs = 20.f;
+
+    void setRamp(float ms, int sampleRate) noexcept {
+        rampSamples_ = std::max(1, (int)(ms * 0.001f * (float)sampleRate));
+    }
+    void reset(float v) noexcept {
+        cur_ = start_ = target_ = v;
+        step_ = 0.f;
+        left_ = 0;
+        primed_ = true;
+    }
+
+    // RT: раз в блок из n сэмплов; true — в этом блоке значение движется
+    bool advance(float target, int n, bool exact = false) noexcept {
+        if (!primed_) reset(target);
+        start_ = cur_;
+        if (target != target_) {
+            target_ = target;
+            left_ = exact ? 1 : std::max(1, (rampSamples_ + n - 1) / n);
+            step_ = (target_ - cur_) / (float)(left_ * n);
+        }
+        if (left_ == 0) { step_ = 0.f; return false; }
+        if (--left_ == 0) { // последний блок рампы — приземляемся точно в цель
+            cur_ = target_;
+            step_ = (cur_ - start_) / (float)n;
+        } else {
+            cur_ = start_ + step_ * (float)n;
+        }
+        return true;
+    }
+
+    float start()  const noexcept { return start_; }   // значение до первого сэмпла блока
+    float end()    const noexcept { return cur_; }     // значение на последнем сэмпле блока
+    float step()   const noexcept { return step_; }
+    float target() const noexcept { return target_; }
+    bool  moving() const noexcept { return step_ != 0.f; }
+    float at(int i) const noexcept { return start_ + step_ * (float)(i + 1); }
+
+    // рампа блока по сэмплам (out[i] = at(i)); для стоящего — константа
+    void fill(float* out, int n) const noexcept {
+        int i = 0;
+        simd::f32x4 v = simd::splat4(start_) + simd::splat4(step_) * simd::f32x4{1.f, 2.f, 3.f, 4.f};
+        const simd::f32x4 d = simd::splat4(4.f * step_);
+        for (; i + 4 <= n; i += 4, v += d) simd::store4(out + i, v);
+        for (; i < n; ++i) out[i] = at(i);
+    }
+
+    // x[i] *= at(i)
+    void apply(float* x, int n) const noexcept { applyRamp(x, n, start_, cur_); }
+
+private:
+    float cur_ = 0.f, start_ = 0.f, target_ = 0.f, step_ = 0.f;
+    int   left_ = 0;                 // блоков до конца рампы
+    int   rampSamples_ = 960;        // 20 мс @ 48 кГц
+    bool  primed_ = false;
+};
+
+// Набор сглаживателей над IParam (пер-трековые ручки движка, параметры нод).
+// add()/prepare()/bind() — НЕ RT; process() — RT, раз в блок: читает цели и продвигает рампы;
+// стоящие параметры стоят одно сравнение. moving(i)/anyMoving() — чтобы потребитель пропускал работу.
+// С хэндлом и bind(values) автоматизированный параметр идёт рампой ровно в блок (exact).
+class SmootherBank {
+public:
+    int add(IParam* p, ParamHandle h = {}, float rampMs = ParamSmoother::kDefaultRampMs) {
+        src_.push_back(p);
+        handle_.push_back(h);
+        ramp_.push_back(rampMs);
+        sm_.emplace_back();
+        sm_.back().setRamp(rampMs, sr_);
+        if (p) sm_.back().reset(p->getFloat());
+        return (int)sm_.size() - 1;
+    }
+    void clear() { src_.clear(); handle_.clear(); ramp_.clear(); sm_.clear(); }
+    void bind(const ParamValues* values) { values_ = values; }
+    void prepare(int sampleRate) {
+        sr_ = sampleRate > 0 ? sampleRate : 48000;
+        for (size_t i = 0; i < sm_.size(); ++i) sm_[i].setRamp(ramp_[i], sr_);
+    }
+
+    void process(int n) noexcept {
+        any_ = false;
+        for (size_t i = 0; i < sm_.size(); ++i) {
+            if (!src_[i]) continue;
+            const bool exact = values_ && values_->automated(handle_[i]);
+            any_ |= sm_[i].advance(src_[i]->getFloat(), n, exact);
+        }
+    }
+
+    const ParamSmoother& operator[](int i) const noexcept { return sm_[(size_t)i]; }
+    bool  moving(int i) const noexcept { return sm_[(size_t)i].moving(); }
+    float value(int i)  const noexcept { return sm_[(size_t)i].end(); }
+    bool  anyMoving()   const noexcept { return any_; }
+    int   size()        const noexcept { return (int)sm_.size(); }
+
+private:
+    std::vector<IParam*> src_;
+    std::vector<ParamHandle> handle_;
+    std::vector<float> ramp_;
+    std::vector<ParamSmoother> sm_;
+    const ParamValues* values_ = nullptr;
+    int  sr_ = 48000;
+    bool any_ = false;
+};
@@ -1,11 +1,27 @@
 
 #pragma once
+#include <cstdint>
 #include <fstream>
 #include <string>
+#include <vector>
 #include "sequencer/Sequencer.h"
 
+// Сколько готовых экземпляров FX типа держать в пуле (FxRegistry::setPoolSize)
+struct FxPoolSize {
+    std::string type;
+    int count = 0;
+};
+
+// Снимок микса в проекте: имя (без пробелов) + blob MixSnapshot::toBlob (в файле — hex)
+struct ProjectSnapshot {
+    std::string name;
+    std::vector<uint8_t> blob;
+};
+
 struct Project {
     Pattern pattern;
+    std::vector<FxPoolSize> fxPools; // прогрев пулов FX под этот сет; нет записи — размер по умолчанию
+    std::vector<ProjectSnapshot> snapshots; // сцены для морфа (params/Morph.h)
     // TODO: samples/patches/mixer later
 
     bool save(const std::string& path) const {
@@ -17,6 +33,14 @@ struct Project {
             const auto& st = pattern.data[i];
             f << "step " << i << " " << (st.active?1:0) << " " << (st.isPad?1:0) << " " << st.padOrNote << " " << st.vel << " " << st.micro << "\n";
         }
+        for (const auto& fp : fxPools) f << "fxpool " << fp.type << " " << fp.count << "\n";
+        for (const auto& s : snapshots) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            std::string hex;
+            hex.reserve(s.blob.size() * 2);
+            for (uint8_t b : s.blob) { hex += kHex[b >> 4]; hex += kHex[b & 15]; }
+            f << "snapshot " << s.name << " " << hex << "\n";
+        }
         return true;
     }
 
@@ -27,6 +51,8 @@ struct Project {
         int steps=0;
         float swing=0.f;
         Pattern p;
+        std::vector<FxPoolSize> pools;
+        std::vector<ProjectSnapshot> snaps;
         while (f >> key) {
             if (key=="steps") { f >> steps; p.steps = steps; p.data.resize(steps); }
             else if (key=="swing") { f >> swing; p.swing = swing; }
@@ -41,8 +67,24 @@ struct Project {
                     p.data[idx].micro = m;
                 }
             }
+            else if (key=="fxpool") {
+                FxPoolSize fp;
+                f >> fp.type >> fp.count;
+                pools.push_back(fp);
+            }
+            else if (key=="snapshot") {
+                ProjectSnapshot s;
+                std::string hex;
+                f >> s.name >> hex;
+                auto nib = [](char c) { return c <= '9' ? c - '0' : c - 'a' + 10; };
+                s.blob.reserve(hex.size() / 2);
+                for (size_t i = 0; i + 1 < hex.size(); i += 2) s.blob.push_back((uint8_t)(nib(hex[i]) << 4 | nib(hex[i + 1])));
+                snaps.push_back(std::move(s));
+            }
         }
         pattern = p;
+        fxPools = pools;
+        snapshots = std::move(snaps);
         return true;
     }
 };
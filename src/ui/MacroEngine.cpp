@@ -0,0 +1,112 @@
+#include "MacroEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include "utils/TrackPath.h"
+
+namespace {
+
+// --- встроенные раскладки ---
+// RITUAL: decay↑, drift↑, reverb send↑, saturation↑
+constexpr MacroTarget kRitual[] = {
+    {"env.decayMs",    MacroCurve::Linear, 0.f, 900.f,  true},
+    {"drift.depth",    MacroCurve::Linear, 0.f, 0.7f,   false},
+    {"fx.reverb.send", MacroCurve::Linear, 0.f, 0.5f,   false},
+    {"fx.saturation",  MacroCurve::Linear, 0.f, 0.35f,  false},
+};
+constexpr MacroTarget kDrift[] = {
+    {"drift.depth",    MacroCurve::Linear, 0.f,  1.f,   false},
+    {"drift.rate",     MacroCurve::Linear, 0.1f, 1.f,   false},
+};
+// FOG: пока прокси в reverb send (позже можно добавить LP/smear)
+constexpr MacroTarget kFog[] = {
+    {"fx.reverb.send", MacroCurve::Linear, 0.f, 0.8f,   false},
+};
+constexpr MacroTarget kBleed[] = {
+    {"fx.saturation",  MacroCurve::Linear, 0.f, 0.8f,   false},
+};
+// DOOM: длиннее release (более «тёмный» хвост)
+constexpr MacroTarget kDoom[] = {
+    {"env.releaseMs",  MacroCurve::Linear, 0.f, 1500.f, true},
+};
+
+constexpr MacroDef kBuiltins[] = {
+    {MacroId::Ritual, "macro.ritual", kRitual},
+    {MacroId::Drift,  "macro.drift",  kDrift},
+    {MacroId::Fog,    "macro.fog",    kFog},
+    {MacroId::Bleed,  "macro.bleed",  kBleed},
+    {MacroId::Doom,   "macro.doom",   kDoom},
+};
+static_assert(std::size(kBuiltins) == MacroEngine::kMacroCount);
+
+inline float shape(MacroCurve c, float k) noexcept {
+    switch (c) {
+        case MacroCurve::Square: return k * k;
+        case MacroCurve::Sqrt:   return std::sqrt(k);
+        default:                 return k;
+    }
+}
+
+} // namespace
+
+std::span<const MacroDef> MacroEngine::builtins() { return kBuiltins; }
+
+void MacroEngine::compile(IParameterStore& store, std::span<const MacroDef> defs) {
+    targets_.clear();
+    slots_.clear();
+    values_ = store.values();
+    tracks_ = values_ ? values_->trackCount() : 0;
+    slots_.resize((size_t)(tracks_ + 1) * kMacroCount);
+
+    for (int t = kMasterTrack; t < tracks_; ++t) {
+        for (const MacroDef& d : defs) {
+            const int mi = (int)d.id;
+            if (mi < 0 || mi >= kMacroCount) continue;
+            Slot& s = slots_[(size_t)(t + 1) * kMacroCount + (size_t)mi];
+            s.begin = (uint32_t)targets_.size();
+            s.knob  = store.handle(TrackPath::trackParam(t, d.knob));
+            for (const MacroTarget& mt : d.targets) {
+                const ParamHandle h = store.handle(TrackPath::trackParam(t, mt.suffix));
+                const IParam* p = store.param(h);
+                if (!p) continue;
+                const ParamMeta& m = p->meta();
+                const float base = mt.fromDefault ? m.def : 0.f;
+                targets_.push_back({h, mt.curve, base + mt.from, base + mt.to,
+                                    m.min, m.max, m.step, m.type == ParamType::kBool});
+            }
+            s.count = (uint32_t)targets_.size() - s.begin;
+        }
+    }
+}
+
+const MacroEngine::Slot* MacroEngine::slot(int track, MacroId m) const noexcept {
+    const int mi = (int)m;
+    if (track < kMasterTrack || track >= tracks_ || mi < 0 || mi >= kMacroCount) return nullptr;
+    return &slots_[(size_t)(track + 1) * kMacroCount + (size_t)mi];
+}
+
+void MacroEngine::run(IParameterStore& store, const Slot& s, float k01) const noexcept {
+    for (uint32_t i = s.begin; i < s.begin + s.count; ++i) {
+        const Compiled& c = targets_[i];
+        float v = c.from + (c.to - c.from) * shape(c.curve, k01);
+        if (c.isBool) v = v >= 0.5f ? 1.f : 0.f;
+        v = std::clamp(v, c.min, c.max);
+        if (c.step > 0.f) v = std::clamp(c.min + std::round((v - c.min) / c.step) * c.step, c.min, c.max);
+        store.set(c.h, v);
+    }
+    if (s.knob) store.set(s.knob, k01);
+}
+
+void MacroEngine::apply(IParameterStore& store, int track, MacroId m, float k01) const noexcept {
+    if (const Slot* s = slot(track, m)) run(store, *s, std::clamp(k01, 0.f, 1.f));
+}
+
+void MacroEngine::apply(IParameterStore& store, std::span<const int> tracks, MacroId m, float k01) const noexcept {
+    k01 = std::clamp(k01, 0.f, 1.f);
+    for (int t : tracks) if (const Slot* s = slot(t, m)) run(store, *s, k01);
+}
+
+void MacroEngine::applyAll(IParameterStore& store, MacroId m, float k01) const noexcept {
+    k01 = std::clamp(k01, 0.f, 1.f);
+    for (int t = kMasterTrack; t < tracks_; ++t) run(store, *slot(t, m), k01);
+}
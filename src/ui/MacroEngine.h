@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "params/Param.h"   // IParameterStore, ParamHandle, MacroId
+
+// ------------------------------------------------------------
+// MacroEngine — макросы как данные: таблица (суффикс цели, кривая, диапазон) на макрос
+// компилируется один раз на трек в плоский массив (хэндл, from, to, кламп по ParamMeta).
+// Применение — цикл по хэндлам без строк/хешей; пачкой — по многим трекам за вызов.
+//   • compile() — НЕ RT (резолв id → хэндл); после каждого commitParams стора.
+//   • apply*()  — любой поток; запись через IParameterStore::set(handle) → журнал изменений.
+// ------------------------------------------------------------
+enum class MacroCurve : uint8_t { Linear, Square, Sqrt };
+
+struct MacroTarget {
+    std::string_view suffix;        // id без префикса трека: "env.decayMs"
+    MacroCurve curve;
+    float from, to;                 // значения при k = 0 и k = 1
+    bool  fromDefault;              // from/to — смещения от ParamMeta::def
+};
+
+struct MacroDef {
+    MacroId id;
+    std::string_view knob;          // "ручка" макроса на треке (для UI/сохранения)
+    std::span<const MacroTarget> targets;
+};
+
+class MacroEngine {
+public:
+    static constexpr int kMacroCount = 5;   // MacroId::Ritual..Doom
+
+    // Встроенные раскладки (как были в UiFacade::apply*OnTrack)
+    static std::span<const MacroDef> builtins();
+
+    // НЕ RT: master + track.0 .. track.(values()->trackCount()−1); незарегистрированные цели пропускаются
+    void compile(IParameterStore& store, std::span<const MacroDef> defs = builtins());
+    bool compiledFor(IParameterStore& store) const { return store.values() && store.values() == values_; }
+
+    void apply(IParameterStore& store, int track, MacroId m, float k01) const noexcept;
+    void apply(IParameterStore& store, std::span<const int> tracks, MacroId m, float k01) const noexcept;
+    void applyAll(IParameterStore& store, MacroId m, float k01) const noexcept; // master + все треки
+
+    int trackCount() const noexcept { return tracks_; }
+
+    // f(ParamHandle) по всему, что пишет apply(track, m): цели + ручка макроса (запись автоматизации)
+    template<class F>
+    void forEachTarget(int track, MacroId m, F&& f) const {
+        const Slot* s = slot(track, m);
+        if (!s) return;
+        for (uint32_t i = s->begin; i < s->begin + s->count; ++i) f(targets_[i].h);
+        if (s->knob) f(s->knob);
+    }
+
+private:
+    struct Compiled {
+        ParamHandle h;
+        MacroCurve  curve;
+        float from, to;
+        float min, max, step;
+        bool  isBool;
+    };
+    struct Slot {                       // [трек × макрос]
+        uint32_t begin = 0, count = 0;  // диапазон в targets_
+        ParamHandle knob;
+    };
+
+    const Slot* slot(int track, MacroId m) const noexcept;
+    void run(IParameterStore& store, const Slot& s, float k01) const noexcept;
+
+    std::vector<Compiled> targets_;
+    std::vector<Slot>     slots_;       // (track + 1) * kMacroCount + macro; track = −1 — master
+    int tracks_ = 0;
+    const ParamValues* values_ = nullptr;
+};
@@ -1,10 +1,13 @@
 #include "UiFacade.h"
 #include <cmath>
 #include <utility>
+#include "utils/TrackPath.h"
 
 // ----------------- ctor -----------------
 UiFacade::UiFacade(IParameterStore& store, IEventBus& bus)
-        : store_(store), bus_(bus) {}
+        : store_(store), bus_(bus) {
+    if (store_.values()) macros_.compile(store_); // раскладка уже есть — хэндлы сразу, не на первой ручке
+}
 
 // ----------------- helpers: track id -----------------
 std::string UiFacade::trackPrefix(int track) {
@@ -51,11 +54,16 @@ float UiFacade::mapTo01ByMeta(const ParamMeta& m, float v) {
 }
 
 // ----------------- params API -----------------
+void UiFacade::changed(const std::string& id, IParam& p) {
+    store_.notify(id, p.getFloat());                 // уведомить UI/контроллеров (если подписаны)
+    if (automation_ && automation_->armed()) automation_->record(store_.handle(id), p.getFloat());
+}
+
 void UiFacade::setParamRaw(const std::string& id, float value) {
     if (auto* p = findParam(id)) {
         const auto& meta = p->meta();
         p->setFloat(clampByMeta(meta, value));   // сглаживание — внутри реализации IParam::setFloat() или в DSP
-        store_.notify(id, p->getFloat());        // уведомить UI/контроллеров (если подписаны)
+        changed(id, *p);
     }
 }
 
@@ -63,7 +71,7 @@ void UiFacade::setParam01(const std::string& id, float k01) {
     if (auto* p = findParam(id)) {
         const auto& meta = p->meta();
         p->setFloat(clampByMeta(meta, map01ToByMeta(meta, k01)));
-        store_.notify(id, p->getFloat());
+        changed(id, *p);
     }
 }
 
@@ -72,7 +80,7 @@ void UiFacade::modParamRaw(const std::string& id, float delta) {
         const auto& meta = p->meta();
         const float cur  = p->getFloat();
         p->setFloat(clampByMeta(meta, cur + delta));
-        store_.notify(id, p->getFloat());
+        changed(id, *p);
     }
 }
 
@@ -88,7 +96,7 @@ void UiFacade::toggleParam(const std::string& id) {
             const float mid = meta.min + 0.5f * (meta.max - meta.min);
             p->setFloat(cur >= mid ? meta.def : meta.max);
         }
-        store_.notify(id, p->getFloat());
+        changed(id, *p);
     }
 }
 
@@ -110,7 +118,7 @@ void UiFacade::noteOff(int note) {
 }
 
 void UiFacade::loadSampleToPad(int pad, const std::string& path) {
-    bus_.publishFromUI(Event{EvLoadSample{pad, path}});
+    bus_.publishFromUI(Event{EvLoadSample{pad, bus_.strings().intern(path)}}); // строка — в арену, не в событие
 }
 
 // ----------------- sequencer -----------------
@@ -129,69 +137,31 @@ void UiFacade::setPattern(int index) {
 }
 
 // ----------------- macros per-track -----------------
-void UiFacade::setMacroOnTrack(int track, MacroId m, float k01) {
-    k01 = std::clamp(k01, 0.f, 1.f);
-    switch (m) {
-        case MacroId::Ritual: applyRitualOnTrack(track, k01); break;
-        case MacroId::Drift:  applyDriftOnTrack (track, k01); break;
-        case MacroId::Fog:    applyFogOnTrack   (track, k01); break;
-        case MacroId::Bleed:  applyBleedOnTrack (track, k01); break;
-        case MacroId::Doom:   applyDoomOnTrack  (track, k01); break;
-    }
-    // Обновим "ручку" макроса для UI/сохранения состояния
-    const std::string knobId =
-            (m == MacroId::Ritual) ? makeTrackParamId(track, SID_MAC_RIT) :
-            (m == MacroId::Drift)  ? makeTrackParamId(track, SID_MAC_DRF) :
-            (m == MacroId::Fog)    ? makeTrackParamId(track, SID_MAC_FOG) :
-            (m == MacroId::Bleed)  ? makeTrackParamId(track, SID_MAC_BLD) :
-            makeTrackParamId(track, SID_MAC_DOM);
-    setParamRaw(knobId, k01);
-}
-
-// --- helpers для чтения дефолтов (если параметр не зарегистрирован — fallback) ---
-static float defOf(UiFacade& ui, const std::string& id, float fallback) {
-    if (auto* p = ui.findParam(id)) return p->meta().def;
-    return fallback;
+const MacroEngine& UiFacade::macros() {
+    if (!macros_.compiledFor(store_)) macros_.compile(store_); // раскладка стора сменилась — хэндлы заново
+    return macros_;
 }
 
-// --- реализация раскладок ---
-void UiFacade::applyRitualOnTrack(int track, float k) {
-    // decay↑, drift↑, reverb send↑, saturation↑
-    const std::string idEnvD    = makeTrackParamId(track, SID_ENV_D);
-    const std::string idDriftD  = makeTrackParamId(track, SID_DRIFT_D);
-    const std::string idRevSend = makeTrackParamId(track, SID_REV_SEND);
-    const std::string idSat     = makeTrackParamId(track, SID_SAT);
-
-    const float baseD = defOf(*this, idEnvD, 200.f);
-
-    setParamRaw(idEnvD,    mix(baseD, baseD + 900.f, k));
-    setParamRaw(idDriftD,  mix(0.f,   0.7f,          k));
-    setParamRaw(idRevSend, mix(0.f,   0.5f,          k));
-    setParamRaw(idSat,     mix(0.f,   0.35f,         k));
+void UiFacade::macroChanged(int track, MacroId m) {
+    if (!automation_ || !automation_->armed()) return;
+    const ParamValues* vals = store_.values();
+    macros_.forEachTarget(track, m, [&](ParamHandle h) { automation_->record(h, vals->get(h)); });
 }
 
-void UiFacade::applyDriftOnTrack(int track, float k) {
-    const std::string idDriftD = makeTrackParamId(track, SID_DRIFT_D);
-    const std::string idDriftR = makeTrackParamId(track, SID_DRIFT_R);
-
-    setParamRaw(idDriftD, mix(0.f,   1.f,  k));
-    setParamRaw(idDriftR, mix(0.1f,  1.f,  k));
-}
-
-void UiFacade::applyFogOnTrack(int track, float k) {
-    // Проксируем FOG в reverb send (позже можно добавить LP/smear)
-    const std::string idRevSend = makeTrackParamId(track, SID_REV_SEND);
-    setParamRaw(idRevSend, mix(0.f, 0.8f, k));
+void UiFacade::setMacroOnTrack(int track, MacroId m, float k01) {
+    std::lock_guard<std::mutex> lk(macrosMx_);
+    macros().apply(store_, track, m, k01);
+    macroChanged(track, m);
 }
 
-void UiFacade::applyBleedOnTrack(int track, float k) {
-    const std::string idSat = makeTrackParamId(track, SID_SAT);
-    setParamRaw(idSat, mix(0.f, 0.8f, k));
+void UiFacade::setMacroOnTracks(std::span<const int> tracks, MacroId m, float k01) {
+    std::lock_guard<std::mutex> lk(macrosMx_);
+    macros().apply(store_, tracks, m, k01);
+    for (int t : tracks) macroChanged(t, m);
 }
 
-void UiFacade::applyDoomOnTrack(int track, float k) {
-    // Длиннее release (более «тёмный» хвост)
-    const std::string idEnvR = makeTrackParamId(track, SID_ENV_R);
-    const float baseR = defOf(*this, idEnvR, 250.f);
-    setParamRaw(idEnvR, mix(baseR, baseR + 1500.f, k));
+void UiFacade::setMacroOnAllTracks(MacroId m, float k01) {
+    std::lock_guard<std::mutex> lk(macrosMx_);
+    macros().applyAll(store_, m, k01);
+    for (int t = kMasterTrack; t < macros_.trackCount(); ++t) macroChanged(t, m);
 }
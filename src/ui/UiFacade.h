@@ -4,9 +4,12 @@
 #include <optional>
 #include <algorithm>
 #include <cassert>
+#include <mutex>
 
 #include "params/Param.h"   // IParameterStore, IParam, ParamMeta, ParamType
 #include "bus/EventBus.h"   // IEventBus и using Event=std::variant<...>
+#include "ui/MacroEngine.h" // макросы как данные (хэндлы целей на трек)
+#include "params/Automation.h"
 
 // ------------------------------------------------------------
 // UiFacade — единая точка входа для любого фронтенда (ImGui/Qt/консоль/MIDI).
@@ -14,8 +17,8 @@
 //   • Разовые действия → через EventBus (EvTransport, EvPadPressed, EvNoteOn/Off,
 //     EvLoadSample, EvSeqSet*).
 //   • Непрерывные параметры → через IParameterStore (атомики), кламп по ParamMeta.
-//   • Макросы применяются PER-TRACK (включая master=-1), пишем нужные параметры
-//     по строковым id с префиксом трека: "track.N.*" или "master.*".
+//   • Макросы применяются PER-TRACK (включая master=-1): раскладки — данные (MacroEngine),
+//     цели резолвятся в хэндлы один раз, дальше — запись по хэндлам без строк.
 // ------------------------------------------------------------
 class UiFacade {
 public:
@@ -36,10 +39,19 @@ public:
 
     // ---------- Макросы по трекам ----------
     // track >= 0 → соответствующий трек; track == -1 → мастер-трек.
+    // Из любого НЕ RT потока (UI, MIDI-контроллер): таблица хэндлов и запись — под macrosMx_.
     void setMacroOnTrack(int track, MacroId m, float k01);
+    // Пачкой: один макрос на многих треках (свип с контроллера) / на всех (master + треки)
+    void setMacroOnTracks(std::span<const int> tracks, MacroId m, float k01);
+    void setMacroOnAllTracks(MacroId m, float k01);
 
     IParam*       findParam(const std::string& id) const;
 
+    // ---------- Автоматизация ----------
+    // Движок автоматизации (AudioEngine::automation()); при arm() ходы ручек пишутся в полосы
+    void setAutomation(AutomationEngine* a) { automation_ = a; }
+    void armAutomation(bool on) { if (automation_) automation_->arm(on); }
+
     // ---------- Транспорт / пэды / ноты ----------
     void play();                              // EvTransport{true}
     void stop();                              // EvTransport{false}
@@ -60,38 +72,26 @@ public:
 private:
     IParameterStore& store_;
     IEventBus&       bus_;
+    AutomationEngine* automation_ = nullptr;
+
+    // значение ручки изменено с UI: уведомить слушателей и (если идёт запись) записать в полосу
+    void changed(const std::string& id, IParam& p);
+    // то же для макроса на треке: его цели и ручку — в полосы (слушатели узнают из журнала стора); под macrosMx_
+    void macroChanged(int track, MacroId m);
 
     // ---- Доступ к параметрам/нормализация ----
     static float  clampByMeta(const ParamMeta& m, float v);
     static float  map01ToByMeta(const ParamMeta& m, float k01);
     static float  mapTo01ByMeta(const ParamMeta& m, float v);
 
-    // ---- Макросы per-track (реализации) ----
-    void applyRitualOnTrack(int track, float k01);
-    void applyDriftOnTrack (int track, float k01);
-    void applyFogOnTrack   (int track, float k01);
-    void applyBleedOnTrack (int track, float k01);
-    void applyDoomOnTrack  (int track, float k01);
+    // ---- Макросы per-track: таблицы хэндлов ----
+    // Компилируются в конструкторе (стор уже закоммичен) и заново, если раскладка сменилась
+    // (следующий commitParams). Проверка, пересборка и apply — под одним мьютексом: два потока
+    // с ручками не пересобирают таблицу друг у друга из-под apply().
+    std::mutex  macrosMx_;
+    MacroEngine macros_;
+    const MacroEngine& macros();              // под macrosMx_
 
     // ---- Сервис ----
-    static inline float mix(float a, float b, float t) { return a + (b - a) * t; }
     static std::string  trackPrefix(int track);
-
-    // Базовые суффиксы параметров (без префикса трека). Подгони под свои реальные id при регистрации.
-    static constexpr std::string_view SID_ENV_A    = "env.attack.ms";
-    static constexpr std::string_view SID_ENV_D    = "env.decay.ms";
-    static constexpr std::string_view SID_ENV_S    = "env.sustain";
-    static constexpr std::string_view SID_ENV_R    = "env.release.ms";
-
-    static constexpr std::string_view SID_REV_SEND = "fx.reverb.send";
-    static constexpr std::string_view SID_SAT      = "fx.saturation";
-    static constexpr std::string_view SID_DRIFT_D  = "drift.depth";
-    static constexpr std::string_view SID_DRIFT_R  = "drift.rate";
-
-    // сами «ручки макросов» (для UI состояния/автосейва), тоже пер-трековые
-    static constexpr std::string_view SID_MAC_RIT  = "macro.ritual";
-    static constexpr std::string_view SID_MAC_DRF  = "macro.drift";
-    static constexpr std::string_view SID_MAC_FOG  = "macro.fog";
-    static constexpr std::string_view SID_MAC_BLD  = "macro.bleed";
-    static constexpr std::string_view SID_MAC_DOM  = "macro.doom";
 };
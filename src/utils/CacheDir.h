@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// Пользовательский каталог кеша (генерируемые данные: мипы волновых таблиц и т.п.). НЕ RT.
+//  - ALCHEMY_CACHE_DIR — явный путь (настройка, тесты, портативная установка);
+//  - macOS: ~/Library/Caches/Alchemy; иначе $XDG_CACHE_HOME/alchemy или ~/.cache/alchemy;
+//  - без HOME — системный temp/alchemy.
+// Каталог создаётся при первом вызове. Не вышло — пустой путь: кеш не пишем, всё строится в памяти.
+inline std::filesystem::path userCacheDir() {
+    namespace fs = std::filesystem;
+    auto env = [](const char* name) -> fs::path {
+        const char* v = std::getenv(name);
+        return v && *v ? fs::path(v) : fs::path{};
+    };
+
+    fs::path dir = env("ALCHEMY_CACHE_DIR");
+    if (dir.empty()) {
+        const fs::path home = env("HOME");
+#ifdef __APPLE__
+        if (!home.empty()) dir = home / "Library" / "Caches" / "Alchemy";
+#else
+        if (const fs::path xdg = env("XDG_CACHE_HOME"); !xdg.empty()) dir = xdg / "alchemy";
+        else if (!home.empty())                                       dir = home / ".cache" / "alchemy";
+#endif
+    }
+    std::error_code ec;
+    if (dir.empty()) {
+        dir = fs::temp_directory_path(ec);
+        if (ec) return {};
+        dir /= "alchemy";
+    }
+    fs::create_directories(dir, ec);
+    return ec ? fs::path{} : dir;
+}
+
+// Полный путь к файлу кеша (пустой — каталога нет, кеш отключён)
+inline std::string userCachePath(std::string_view file) {
+    const std::filesystem::path dir = userCacheDir();
+    return dir.empty() ? std::string{} : (dir / file).string();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cmath>
+#include "utils/Simd.h"
+
+// Быстрые аппроксимации для DSP-циклов (без libm, без ветвлений там, где это важно для векторизации).
+// Точность указана для каждой функции; для «звука» её достаточно, для UI/оффлайна берите std::.
+
+namespace fastmath {
+
+inline constexpr float kPi    = 3.14159265358979f;
+inline constexpr float kTwoPi = 6.28318530717959f;
+inline constexpr float kHalfPi= 1.57079632679490f;
+
+// Свернуть фазу в [-π, π]
+inline float wrapPi(float x) {
+    return x - kTwoPi * std::nearbyint(x * (1.f / kTwoPi));
+}
+
+// sin(x), x ∈ [-π, π]; ошибка < 4e-6
+inline float sin(float x) {
+    // симметрия к [-π/2, π/2]
+    if (x >  kHalfPi) x =  kPi - x;
+    if (x < -kHalfPi) x = -kPi - x;
+    const float x2 = x * x;
+    return x * (1.f + x2 * (-1.f/6.f + x2 * (1.f/120.f + x2 * (-1.f/5040.f + x2 * (1.f/362880.f)))));
+}
+
+// cos(x), x ∈ [-π, π]
+inline float cos(float x) {
+    return fastmath::sin(wrapPi(x + kHalfPi));
+}
+
+// atan2(y, x); ошибка < 1e-5 рад
+inline float atan2(float y, float x) {
+    const float ax = std::fabs(x), ay = std::fabs(y);
+    const float mx = ax > ay ? ax : ay;
+    const float mn = ax > ay ? ay : ax;
+    if (mx == 0.f) return 0.f;
+    const float a = mn / mx;
+    const float s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    if (ay > ax) r = kHalfPi - r;
+    if (x < 0.f) r = kPi - r;
+    return y < 0.f ? -r : r;
+}
+
+// ---- векторные (f32x4): те же формулы без ветвлений, для пооборотной обработки блоков ----
+
+// floor для |x| < 2^31
+inline simd::f32x4 floor(simd::f32x4 x) {
+    const simd::i32x4 i = __builtin_convertvector(x, simd::i32x4);
+    const simd::f32x4 f = __builtin_convertvector(i, simd::f32x4);
+    return simd::select(f > x, f - simd::splat4(1.f), f);
+}
+
+// 2^x, x ∈ [-126, 126] (вне — кламп); относительная ошибка < 1e-5
+inline simd::f32x4 exp2(simd::f32x4 x) {
+    x = simd::min(simd::max(x, simd::splat4(-126.f)), simd::splat4(126.f));
+    const simd::f32x4 fl = fastmath::floor(x);
+    const simd::f32x4 f  = x - fl;
+    const simd::f32x4 p = simd::splat4(1.f) + f * (simd::splat4(0.693147182f) + f * (simd::splat4(0.240226507f) +
+                          f * (simd::splat4(0.0555041086f) + f * (simd::splat4(0.00961812911f) +
+                          f * (simd::splat4(0.00133335581f) + f * simd::splat4(0.000154035304f))))));
+    // p ∈ [1, 2): прибавляем целую часть прямо к полю экспоненты
+    return (simd::f32x4)((simd::i32x4)p + (__builtin_convertvector(fl, simd::i32x4) << 23));
+}
+
+// log2(x), x > 0 (нормализованные); абсолютная ошибка < 2e-6
+inline simd::f32x4 log2(simd::f32x4 x) {
+    const simd::i32x4 bits = (simd::i32x4)x;
+    const simd::f32x4 e = __builtin_convertvector(((bits >> 23) & 255) - 127, simd::f32x4);
+    const simd::f32x4 m = (simd::f32x4)((bits & 0x7fffff) | 0x3f800000);   // [1, 2)
+    const simd::f32x4 t = (m - simd::splat4(1.f)) / (m + simd::splat4(1.f)); // [0, 1/3)
+    const simd::f32x4 t2 = t * t;
+    const simd::f32x4 s = t * (simd::splat4(1.f) + t2 * (simd::splat4(1.f / 3.f) + t2 * (simd::splat4(0.2f) +
+                          t2 * (simd::splat4(1.f / 7.f) + t2 * simd::splat4(1.f / 9.f)))));
+    return e + s * simd::splat4(2.88539008f); // 2/ln2
+}
+
+inline simd::f32x4 exp(simd::f32x4 x) { return fastmath::exp2(x * simd::splat4(1.44269504f)); }
+inline simd::f32x4 log(simd::f32x4 x) { return fastmath::log2(x) * simd::splat4(0.693147181f); }
+
+// tanh(x) = sign(x)·(1 − e^{−2|x|}) / (1 + e^{−2|x|})
+inline simd::f32x4 tanh(simd::f32x4 x) {
+    const simd::f32x4 t = fastmath::exp(simd::splat4(-2.f) * simd::abs(x));
+    const simd::f32x4 r = (simd::splat4(1.f) - t) / (simd::splat4(1.f) + t);
+    return simd::select(x < simd::splat4(0.f), -r, r);
+}
+
+// ln(cosh(x)) = |x| + ln(1 + e^{−2|x|}) − ln 2 — первообразная tanh, без переполнения
+inline simd::f32x4 logcosh(simd::f32x4 x) {
+    const simd::f32x4 a = simd::abs(x);
+    return a + fastmath::log(simd::splat4(1.f) + fastmath::exp(simd::splat4(-2.f) * a)) - simd::splat4(0.693147181f);
+}
+
+} // namespace fastmath
@@ -0,0 +1,100 @@
+#include "utils/Fft.h"
+#include <cmath>
+#include <utility>
+
+void RealFft::init(int n) {
+    if (n < 4 || (n & (n - 1)) != 0) n = 4;
+    n_ = n;
+    m_ = n / 2;
+
+    int bits = 0;
+    while ((1 << bits) < m_) ++bits;
+    bitrev_.resize((size_t)m_);
+    for (int i = 0; i < m_; ++i) {
+        int r = 0;
+        for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1) << (bits - 1 - b);
+        bitrev_[(size_t)i] = r;
+    }
+
+    twRe_.resize((size_t)std::max(1, m_ / 2));
+    twIm_.resize((size_t)std::max(1, m_ / 2));
+    for (int k = 0; k < m_ / 2; ++k) {
+        const double a = -2.0 * M_PI * (double)k / (double)m_;
+        twRe_[(size_t)k] = (float)std::cos(a);
+        twIm_[(size_t)k] = (float)std::sin(a);
+    }
+
+    rtRe_.resize((size_t)m_ + 1);
+    rtIm_.resize((size_t)m_ + 1);
+    for (int k = 0; k <= m_; ++k) {
+        const double a = -2.0 * M_PI * (double)k / (double)n_;
+        rtRe_[(size_t)k] = (float)std::cos(a);
+        rtIm_[(size_t)k] = (float)std::sin(a);
+    }
+
+    zr_.assign((size_t)m_, 0.f);
+    zi_.assign((size_t)m_, 0.f);
+}
+
+void RealFft::complexFft(float* re, float* im, bool inverse) noexcept {
+    for (int i = 0; i < m_; ++i) {
+        const int j = bitrev_[(size_t)i];
+        if (j > i) { std::swap(re[i], re[j]); std::swap(im[i], im[j]); }
+    }
+    const float sgn = inverse ? -1.f : 1.f;
+    for (int len = 2; len <= m_; len <<= 1) {
+        const int half = len >> 1;
+        const int step = m_ / len;
+        for (int base = 0; base < m_; base += len) {
+            for (int k = 0; k < half; ++k) {
+                const float wr = twRe_[(size_t)(k * step)];
+                const float wi = twIm_[(size_t)(k * step)] * sgn;
+                const int a = base + k, b = a + half;
+                const float xr = re[b] * wr - im[b] * wi;
+                const float xi = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - xr; im[b] = im[a] - xi;
+                re[a] += xr;        im[a] += xi;
+            }
+        }
+    }
+}
+
+void RealFft::forward(const float* in, float* re, float* im) noexcept {
+    // z[k] = x[2k] + i·x[2k+1]
+    for (int k = 0; k < m_; ++k) { zr_[(size_t)k] = in[2 * k]; zi_[(size_t)k] = in[2 * k + 1]; }
+    complexFft(zr_.data(), zi_.data(), false);
+
+    // X[k] = E[k] + W^k·O[k];  E = (Z[k] + Z*[m-k])/2,  O = -i·(Z[k] - Z*[m-k])/2
+    for (int k = 0; k <= m_; ++k) {
+        const int a = k % m_, b = (m_ - k) % m_;
+        const float zr = zr_[(size_t)a], zi = zi_[(size_t)a];
+        const float cr = zr_[(size_t)b], ci = -zi_[(size_t)b];
+        const float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        const float orr = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+        const float wr = rtRe_[(size_t)k], wi = rtIm_[(size_t)k];
+        re[k] = er + (orr * wr - oi * wi);
+        im[k] = ei + (orr * wi + oi * wr);
+    }
+}
+
+void RealFft::inverse(const float* re, const float* im, float* out) noexcept {
+    // Обратно к Z[k] = E[k] + i·O[k];  E = (X[k] + X*[m-k])/2,  O = conj(W^k)·(X[k] - X*[m-k])/2
+    for (int k = 0; k < m_; ++k) {
+        const int b = m_ - k;
+        const float xr = re[k], xi = im[k];
+        const float cr = re[b], ci = -im[b];
+        const float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+        const float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+        const float wr = rtRe_[(size_t)k], wi = -rtIm_[(size_t)k];
+        const float orr = dr * wr - di * wi, oi = dr * wi + di * wr;
+        zr_[(size_t)k] = er - oi;
+        zi_[(size_t)k] = ei + orr;
+    }
+    complexFft(zr_.data(), zi_.data(), true);
+
+    const float k1 = 1.f / (float)m_;
+    for (int k = 0; k < m_; ++k) {
+        out[2 * k]     = zr_[(size_t)k] * k1;
+        out[2 * k + 1] = zi_[(size_t)k] * k1;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+
+// Вещественное FFT размера N (степень двойки) через комплексное FFT размера N/2.
+// Спектр — split-формат: re[0..N/2], im[0..N/2] (N/2+1 бинов).
+// init() аллоцирует таблицы (НЕ RT); forward()/inverse() — RT (без аллокаций).
+// Один экземпляр не потокобезопасен (внутренний скретч): заводите по объекту на владельца.
+class RealFft {
+public:
+    RealFft() = default;
+    explicit RealFft(int n) { init(n); }
+
+    void init(int n);
+    int  size() const { return n_; }
+    int  bins() const { return n_ / 2 + 1; }
+
+    // in[N] → re/im[N/2+1], без нормировки
+    void forward(const float* in, float* re, float* im) noexcept;
+    // re/im[N/2+1] → out[N], с нормировкой 1/N (forward→inverse = тождество)
+    void inverse(const float* re, const float* im, float* out) noexcept;
+
+private:
+    void complexFft(float* re, float* im, bool inverse) noexcept; // in-place, размер m_
+
+    int n_ = 0, m_ = 0;                    // N и N/2
+    std::vector<int>   bitrev_;            // [m_]
+    std::vector<float> twRe_, twIm_;       // [m_/2]  e^{-2πik/m}
+    std::vector<float> rtRe_, rtIm_;       // [m_+1]  e^{-2πik/N} — сборка вещественного спектра
+    std::vector<float> zr_, zi_;           // [m_]    скретч
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+/**
+ * MpscRing
+ * ----------------------------------------------------------------
+ * Ограниченная lock-free очередь «много продюсеров → один консюмер» (схема Вьюкова:
+ * у каждой ячейки свой счётчик-последовательность).
+ *
+ * ► push(): любой поток. Продюсер занимает номер CAS-ом по tail_ и пишет в свою ячейку,
+ *   не мешая остальным; полна — false (не блокируемся, не ждём).
+ * ► pop()/drain(): только один поток-консюмер (аудио). Wait-free: ни CAS, ни ожиданий —
+ *   ячейка готова (seq == pos + 1) → забрали, нет → выходим.
+ * ► Порядок: номера выдаются по возрастанию, консюмер читает строго по номерам — команды
+ *   одного продюсера приходят в порядке push. Между продюсерами — порядок захвата номера.
+ * ► Продюсер, вытесненный между захватом номера и публикацией, задерживает следующие за ним
+ *   элементы до следующего drain (консюмер не крутится на его ячейке) — ничего не теряется.
+ * ► T не обязан быть trivially copyable, но для RT-консюмера лучше, чтобы был:
+ *   pop() перемещает элемент, ячейка остаётся в moved-from состоянии до следующей записи.
+ */
+template<class T, size_t N>
+class MpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be power of two");
+
+public:
+    MpscRing() noexcept {
+        for (size_t i = 0; i < N; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    static constexpr size_t capacity() noexcept { return N; }
+
+    // ---- любой поток ----
+    bool push(const T& v) noexcept(std::is_nothrow_copy_assignable_v<T>) { return emplace(v); }
+    bool push(T&& v) noexcept(std::is_nothrow_move_assignable_v<T>)      { return emplace(std::move(v)); }
+
+    // ---- поток-консюмер ----
+    bool pop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        Cell& c = cells_[head_ & (N - 1)];
+        if (c.seq.load(std::memory_order_acquire) != head_ + 1) return false; // пусто / продюсер ещё пишет
+        out = std::move(c.v);
+        c.seq.store(head_ + N, std::memory_order_release);                      // ячейка свободна на следующий круг
+        ++head_;
+        return true;
+    }
+
+    // Пакетная выборка: f(T&) для готовых элементов по порядку, не больше max. Элемент обрабатывается
+    // прямо в ячейке (без копии); f не должен бросать. Возвращает количество.
+    template<class F>
+    size_t drain(F&& f, size_t max = N) {
+        size_t n = 0;
+        for (; n < max; ++n) {
+            Cell& c = cells_[head_ & (N - 1)];
+            if (c.seq.load(std::memory_order_acquire) != head_ + 1) break;
+            f(c.v);
+            c.seq.store(head_ + N, std::memory_order_release);
+            ++head_;
+        }
+        return n;
+    }
+
+    // Есть ли готовый элемент в голове (консюмер).
+    bool ready() const noexcept {
+        return cells_[head_ & (N - 1)].seq.load(std::memory_order_acquire) == head_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq{0};   // pos — свободна для номера pos; pos + 1 — записана; pos + N — прочитана
+        T v{};
+    };
+
+    template<class U>
+    bool emplace(U&& v) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells_[pos & (N - 1)];
+            const size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto dif = (std::intptr_t)seq - (std::intptr_t)pos;
+            if (dif == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;                                   // консюмер ещё не освободил ячейку — полна
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);    // номер занял другой продюсер
+            }
+        }
+        c->v = std::forward<U>(v);
+        c->seq.store(pos + 1, std::memory_order_release);       // публикуем
+        return true;
+    }
+
+    alignas(64) std::atomic<size_t> tail_{0};   // продюсеры
+    alignas(64) size_t head_ = 0;               // только консюмер
+    alignas(64) Cell cells_[N];
+};
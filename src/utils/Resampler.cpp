@@ -0,0 +1,147 @@
+#include "utils/Resampler.h"
+#include "utils/SampleCompact.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Модифицированная функция Бесселя I0 (ряд) — для окна Кайзера
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    const double q = x * x * 0.25;
+    for (int k = 1; k < 64; ++k) {
+        term *= q / ((double)k * (double)k);
+        sum  += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+// Полифазная таблица: row(q) — 2*W коэффициентов для дробной позиции q/phases.
+// Строк phases+1, чтобы интерполировать между q и q+1 без проверки края.
+struct SincTable {
+    int W = 0;                 // полуширина в отсчётах источника
+    int phases = 0;
+    std::vector<float> taps;   // [(phases+1) * 2W]
+
+    const float* row(int q) const { return taps.data() + (size_t)q * (size_t)(2 * W); }
+};
+
+SincTable buildTable(double ratio, const ResampleOptions& opt) {
+    // ratio = dst/src; при даунсемплинге режем на новом Найквисте и расширяем ядро
+    const double fc      = std::min(1.0, ratio) * (double)opt.passband;
+    const double halfLen = (double)opt.zeroCrossings / fc;
+
+    SincTable t;
+    t.W      = (int)std::ceil(halfLen);
+    t.phases = std::max(1, opt.phases);
+    t.taps.resize((size_t)(t.phases + 1) * (size_t)(2 * t.W));
+
+    const double i0b = besselI0(opt.kaiserBeta);
+    for (int q = 0; q <= t.phases; ++q) {
+        const double frac = (double)q / (double)t.phases;
+        float* r = t.taps.data() + (size_t)q * (size_t)(2 * t.W);
+        for (int k = -t.W + 1; k <= t.W; ++k) {
+            const double x = (double)k - frac;          // расстояние от точки вывода
+            double h = 0.0;
+            if (std::abs(x) < halfLen) {
+                const double a    = M_PI * fc * x;
+                const double sinc = (std::abs(a) < 1e-9) ? 1.0 : std::sin(a) / a;
+                const double u    = x / halfLen;
+                const double win  = besselI0(opt.kaiserBeta * std::sqrt(std::max(0.0, 1.0 - u * u))) / i0b;
+                h = fc * sinc * win;
+            }
+            r[k + t.W - 1] = (float)h;
+        }
+    }
+    return t;
+}
+
+// Свёртка одного канала на диапазоне выходных кадров [o0, o1)
+void convolveRange(const float* in, int inFrames, float* out, int o0, int o1,
+                   double step, const SincTable& t)
+{
+    const int taps = 2 * t.W;
+    for (int o = o0; o < o1; ++o) {
+        const double pos  = (double)o * step;
+        const int    i0   = (int)std::floor(pos);
+        const double ph   = (pos - (double)i0) * (double)t.phases;
+        const int    q    = std::min((int)ph, t.phases - 1);
+        const float  a    = (float)(ph - (double)q);
+        const float* c0   = t.row(q);
+        const float* c1   = t.row(q + 1);
+
+        const int first = i0 - t.W + 1;
+        const int kLo   = std::max(0, -first);
+        const int kHi   = std::min(taps, inFrames - first);
+
+        float acc = 0.f;
+        for (int k = kLo; k < kHi; ++k) {
+            const float c = c0[k] + (c1[k] - c0[k]) * a;
+            acc += in[first + k] * c;
+        }
+        out[o] = acc;
+    }
+}
+
+} // namespace
+
+SampleBufferPtr ResampleSampleBuffer(const SampleBufferPtr& srcAny, int targetSr,
+                                     const ResampleOptions& opt)
+{
+    if (!srcAny || !srcAny->hasData() || srcAny->frames <= 0 || srcAny->sr <= 0 || targetSr <= 0) return nullptr;
+    if (srcAny->sr == targetSr) return srcAny;
+
+    // Ядро работает во float: компактный источник сначала разворачиваем
+    const SampleBufferPtr src = ExpandSampleBuffer(srcAny);
+    if (!src) return nullptr;
+
+    const double ratio = (double)targetSr / (double)src->sr;
+    const double step  = 1.0 / ratio;                        // кадров источника на выходной кадр
+    const int outFrames = (int)std::ceil((double)src->frames * ratio);
+    if (outFrames <= 0) return nullptr;
+
+    const SincTable table = buildTable(ratio, opt);
+
+    auto dst = std::make_shared<SampleBuffer>();
+    dst->sr       = targetSr;
+    dst->channels = src->channels;
+    dst->frames   = outFrames;
+    dst->dataL.reset(new float[(size_t)outFrames], std::default_delete<float[]>());
+    if (src->channels > 1 && src->dataR) {
+        dst->dataR.reset(new float[(size_t)outFrames], std::default_delete<float[]>());
+    }
+
+    struct Plane { const float* in; float* out; };
+    std::vector<Plane> planes{ {src->dataL.get(), dst->dataL.get()} };
+    if (dst->dataR) planes.push_back({src->dataR.get(), dst->dataR.get()});
+
+    // Большие файлы режем на куски по выходным кадрам: куски независимы, синхронизация не нужна
+    int threads = 1;
+    if (outFrames >= opt.parallelMinFrames) {
+        const unsigned hw = opt.maxThreads > 0 ? (unsigned)opt.maxThreads
+                                               : std::max(1u, std::thread::hardware_concurrency());
+        threads = (int)std::min<unsigned>(hw, (unsigned)(outFrames / 4096 + 1));
+    }
+
+    if (threads <= 1) {
+        for (auto& pl : planes) convolveRange(pl.in, src->frames, pl.out, 0, outFrames, step, table);
+        return dst;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve((size_t)threads);
+    const int chunk = (outFrames + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t) {
+        const int o0 = t * chunk;
+        const int o1 = std::min(outFrames, o0 + chunk);
+        if (o0 >= o1) break;
+        pool.emplace_back([&, o0, o1]{
+            for (auto& pl : planes) convolveRange(pl.in, src->frames, pl.out, o0, o1, step, table);
+        });
+    }
+    for (auto& th : pool) th.join();
+    return dst;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "devices/SamplerNode.h"
+
+// Оффлайн-конвертер частоты дискретизации (НЕ RT).
+// Windowed-sinc (Kaiser) с полифазной таблицей и линейной интерполяцией между фазами.
+// Вызывается в пайплайне загрузки, чтобы воспроизведение шло 1:1 (Voice::rate == 1.0).
+struct ResampleOptions {
+    int zeroCrossings = 32;        // полуширина ядра в нулях sinc (качество/скорость)
+    int phases        = 512;       // разрешение полифазной таблицы
+    float passband    = 0.97f;     // доля полосы Найквиста, которую пропускаем без среза
+    float kaiserBeta  = 9.f;       // ≈ -90 дБ подавления
+    int parallelMinFrames = 1 << 18; // с какого размера (выходных кадров) резать на потоки
+    int maxThreads    = 0;         // 0 = std::thread::hardware_concurrency()
+};
+
+// Возвращает новый Float32-буфер с частотой targetSr (Int16-источник разворачивается).
+// Если частоты совпадают — вернёт src как есть.
+// nullptr при ошибке (пустой источник / неверная частота).
+SampleBufferPtr ResampleSampleBuffer(const SampleBufferPtr& src, int targetSr,
+                                     const ResampleOptions& opt = {});
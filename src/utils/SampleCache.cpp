@@ -0,0 +1,40 @@
+#include "utils/SampleCache.h"
+#include "utils/SampleCompact.h"
+
+SampleBufferPtr SampleCache::convert(const SampleBufferPtr& src, int targetSr, SampleFormat fmt) {
+    if (!src) return nullptr;
+    if (src->sr == targetSr && src->format == fmt) return src;
+
+    const auto key = std::make_tuple(static_cast<const SampleBuffer*>(src.get()), targetSr, fmt);
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        prune();
+        auto it = bySample_.find(key);
+        if (it != bySample_.end() && it->second.src.lock() == src) {
+            if (auto out = it->second.out.lock()) return out;
+        }
+    }
+
+    auto out = ToSampleFormat(ResampleSampleBuffer(src, targetSr, opt_), fmt);
+    if (!out) return nullptr;
+
+    std::lock_guard<std::mutex> lk(mu_);
+    bySample_[key] = Converted{src, out};
+    return out;
+}
+
+void SampleCache::prune() {
+    std::erase_if(bySample_, [](const auto& kv) { return kv.second.src.expired() || kv.second.out.expired(); });
+}
+
+void SampleCache::clear() {
+    std::lock_guard<std::mutex> lk(mu_);
+    bySample_.clear();
+}
+
+size_t SampleCache::size() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    size_t n = 0;
+    for (const auto& kv : bySample_) n += !kv.second.src.expired() && !kv.second.out.expired();
+    return n;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "devices/SamplerNode.h"
+#include "utils/Resampler.h"
+
+// Кеш сконвертированных буферов, ключ — (семпл, целевая частота, формат). НЕ RT (mutex + аллокации).
+//  - convert(src, sr, …) — уже загруженный буфер → ресемплинг → формат; ключ (src.get(), sr, fmt)
+// Повторная загрузка того же семпла на той же частоте отдаёт тот же SampleBufferPtr, пока его
+// кто-то держит (пэд, зона). Кеш не владеет ничем: и источник, и итог — weak_ptr, поэтому
+// заменённые семплы и копии под прежнюю частоту умирают вместе с последним владельцем;
+// мёртвые записи вычищает каждый convert().
+class SampleCache {
+public:
+    explicit SampleCache(ResampleOptions opt = {}) : opt_(opt) {}
+
+    SampleBufferPtr convert(const SampleBufferPtr& src, int targetSr,
+                            SampleFormat fmt = SampleFormat::Float32);
+
+    void clear();
+    size_t size() const; // записи с живыми источником и итогом
+
+private:
+    ResampleOptions opt_;
+    mutable std::mutex mu_;
+
+    // weak_ptr на источник: если исходный буфер умер, адрес мог переиспользоваться → запись протухла;
+    // weak_ptr на итог: держат его зоны/пэды, а не кеш
+    struct Converted { std::weak_ptr<SampleBuffer> src, out; };
+    void prune(); // под mu_
+    std::map<std::tuple<const SampleBuffer*, int, SampleFormat>, Converted> bySample_;
+};
@@ -0,0 +1,56 @@
+#include "utils/SampleCompact.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::shared_ptr<int16_t[]> packPlane(const float* in, int frames) {
+    std::shared_ptr<int16_t[]> out(new int16_t[(size_t)frames], std::default_delete<int16_t[]>());
+    int16_t* o = out.get();
+    for (int i = 0; i < frames; ++i) {
+        const float v = std::clamp(in[i] * 32768.f, -32768.f, 32767.f);
+        o[i] = (int16_t)std::lrint(v);
+    }
+    return out;
+}
+
+std::shared_ptr<float[]> unpackPlane(const int16_t* in, int frames) {
+    std::shared_ptr<float[]> out(new float[(size_t)frames], std::default_delete<float[]>());
+    simd::convertI16ToF32(in, out.get(), frames, 1.f / 32768.f);
+    return out;
+}
+
+} // namespace
+
+SampleBufferPtr CompactSampleBuffer(const SampleBufferPtr& src) {
+    if (!src || !src->hasData() || src->frames <= 0) return nullptr;
+    if (src->format == SampleFormat::Int16) return src;
+
+    auto dst = std::make_shared<SampleBuffer>();
+    dst->sr       = src->sr;
+    dst->channels = src->channels;
+    dst->frames   = src->frames;
+    dst->format   = SampleFormat::Int16;
+    dst->pcmL     = packPlane(src->dataL.get(), src->frames);
+    if (src->stereo()) dst->pcmR = packPlane(src->dataR.get(), src->frames);
+    return dst;
+}
+
+SampleBufferPtr ExpandSampleBuffer(const SampleBufferPtr& src) {
+    if (!src || !src->hasData() || src->frames <= 0) return nullptr;
+    if (src->format == SampleFormat::Float32) return src;
+
+    auto dst = std::make_shared<SampleBuffer>();
+    dst->sr       = src->sr;
+    dst->channels = src->channels;
+    dst->frames   = src->frames;
+    dst->format   = SampleFormat::Float32;
+    dst->dataL    = unpackPlane(src->pcmL.get(), src->frames);
+    if (src->stereo()) dst->dataR = unpackPlane(src->pcmR.get(), src->frames);
+    return dst;
+}
+
+SampleBufferPtr ToSampleFormat(const SampleBufferPtr& src, SampleFormat fmt) {
+    return fmt == SampleFormat::Int16 ? CompactSampleBuffer(src) : ExpandSampleBuffer(src);
+}
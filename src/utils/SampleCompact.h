@@ -0,0 +1,15 @@
+#pragma once
+#include "devices/SamplerNode.h"
+
+// Конверсия форматов хранения семпла (НЕ RT).
+// Float32 → Int16: округление к ближайшему; для 16-битных исходников преобразование
+// точное (dr_wav отдаёт их как pcm/32768), т.е. разница неслышима по определению.
+
+// Вернёт Int16-копию (или src, если он уже Int16). nullptr при ошибке.
+SampleBufferPtr CompactSampleBuffer(const SampleBufferPtr& src);
+
+// Вернёт Float32-копию (или src, если он уже Float32). nullptr при ошибке.
+SampleBufferPtr ExpandSampleBuffer(const SampleBufferPtr& src);
+
+// Привести к нужному формату (обёртка над двумя функциями выше)
+SampleBufferPtr ToSampleFormat(const SampleBufferPtr& src, SampleFormat fmt);
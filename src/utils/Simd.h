@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Портативные SIMD-типы на векторных расширениях GCC/Clang (vector_size).
+// Один и тот же код собирается в NEON (Apple Silicon) и SSE/AVX (x86) без интринсиков.
+// Правила: загрузка/выгрузка — только через load*/store* (memcpy, без требований к выравниванию),
+// маски сравнений — целые векторы (-1/0), выбор — через select().
+// f32x8 (32 байта) на x86-64 без -mavx передаётся по значению не так, как с ним (psABI), поэтому
+// f32x8 в сигнатурах — только по ссылке: хелперы пишут результат в первый аргумент, арифметика и
+// сравнения — встроенные операторы (скаляр расширяется сам: 0.5f * v).
+
+namespace simd {
+
+typedef float        f32x4 __attribute__((vector_size(16)));
+typedef std::int32_t i32x4 __attribute__((vector_size(16)));
+typedef std::uint32_t u32x4 __attribute__((vector_size(16)));
+typedef std::int16_t i16x8 __attribute__((vector_size(16)));
+typedef float        f32x8 __attribute__((vector_size(32)));
+typedef std::int32_t i32x8 __attribute__((vector_size(32)));
+
+inline f32x4 load4(const float* p)            { f32x4 v; std::memcpy(&v, p, sizeof v); return v; }
+inline void  store4(float* p, f32x4 v)        { std::memcpy(p, &v, sizeof v); }
+inline void  load8(f32x8& v, const float* p)  { std::memcpy(&v, p, sizeof v); }
+inline void  store8(float* p, const f32x8& v) { std::memcpy(p, &v, sizeof v); }
+inline f32x4 splat4(float x)                  { return f32x4{x, x, x, x}; }
+inline void  splat8(f32x8& v, float x)        { v = f32x8{} + x; }
+
+// mask ? a : b (mask — результат сравнения, -1 в «истинных» лейнах)
+inline f32x4 select(i32x4 mask, f32x4 a, f32x4 b) {
+    const i32x4 ai = (i32x4)a, bi = (i32x4)b;
+    return (f32x4)((ai & mask) | (bi & ~mask));
+}
+inline void select(f32x8& out, const i32x8& mask, const f32x8& a, const f32x8& b) { // out может совпадать с a/b
+    const i32x8 ai = (i32x8)a, bi = (i32x8)b;
+    out = (f32x8)((ai & mask) | (bi & ~mask));
+}
+
+inline f32x4 min(f32x4 a, f32x4 b) { return select(a < b, a, b); }
+inline f32x4 max(f32x4 a, f32x4 b) { return select(a > b, a, b); }
+inline f32x4 abs(f32x4 a)          { return (f32x4)((i32x4)a & i32x4{0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff}); }
+inline void min(f32x8& out, const f32x8& a, const f32x8& b) { select(out, a < b, a, b); }
+inline void max(f32x8& out, const f32x8& a, const f32x8& b) { select(out, a > b, a, b); }
+inline void abs(f32x8& out, const f32x8& a)                 { out = (f32x8)((i32x8)a & (i32x8{} + 0x7fffffff)); }
+
+inline float hsum(f32x4 v) { return (v[0] + v[1]) + (v[2] + v[3]); }
+inline float hmax(f32x4 v) { const float a = v[0] > v[1] ? v[0] : v[1]; const float b = v[2] > v[3] ? v[2] : v[3]; return a > b ? a : b; }
+inline float hsum(const f32x8& v) { return ((v[0] + v[1]) + (v[2] + v[3])) + ((v[4] + v[5]) + (v[6] + v[7])); }
+inline float hmax(const f32x8& v) {
+    float m = v[0];
+    for (int i = 1; i < 8; ++i) m = v[i] > m ? v[i] : m;
+    return m;
+}
+
+// int16 → float (x * scale), по 8 за шаг
+inline void convertI16ToF32(const std::int16_t* in, float* out, int n, float scale) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        i16x8 v; std::memcpy(&v, in + i, sizeof v);
+        const f32x8 f = __builtin_convertvector(v, f32x8) * scale;
+        store8(out + i, f);
+    }
+    for (; i < n; ++i) out[i] = (float)in[i] * scale;
+}
+
+} // namespace simd
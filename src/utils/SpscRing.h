@@ -1,38 +1,138 @@
 #pragma once
-#include <cstddef>
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 // ну это типа у нас очередь lock-free )))
+//
+// v2:
+//  - каждая сторона держит КЭШ чужого индекса и перечитывает его (acquire) только когда кэш
+//    говорит «полно»/«пусто» — в потоке событий кэш-линия соседа тянется раз на пачку, а не на элемент;
+//  - пачки: pushN/popN и представления без копий — writeView()/commitWrite(), readView()/commitRead(),
+//    drain(f) обрабатывает элементы прямо в ячейках;
+//  - pop() перемещает, push(T&&) — тоже: годятся move-only T (unique_ptr и т.п.).
+// Ёмкость — N−1 (одна ячейка разделяет «полно» и «пусто»).
 
 template<class T, size_t N>                // шаблон: T — тип элементов, N — размер очереди (кол-во слотов)
 struct SpscRing {
     static_assert((N & (N-1)) == 0,          // компиляционная проверка: N — степень двойки (1<<k)
                   "N must be power of two"); // нужно, чтобы быстрый модуль по маске работал корректно
 
+    // линия продюсера: свой индекс + кэш индекса консюмера
     alignas(64) std::atomic<size_t> w{0};    // индекс записи (write), атомик; alignas(64) — чтобы лежал на своей кэш-линии
+    size_t rCache_ = 0;                      // последний увиденный r (только продюсер)
+    // линия консюмера: свой индекс + кэш индекса продюсера
     alignas(64) std::atomic<size_t> r{0};    // индекс чтения (read), атомик; отделён от w, чтобы избежать false sharing
+    size_t wCache_ = 0;                      // последний увиденный w (только консюмер)
     alignas(64) T q[N];                      // сам буфер фиксированного размера на N элементов; тоже выровняли «на всякий»
 
-    bool push(const T& v) noexcept {         // метод продюсера (UI-поток): попытаться записать элемент v
-        size_t w0 = w.load(std::memory_order_relaxed);      // локально читаем текущий индекс записи (без барьеров)
-        size_t w1 = (w0 + 1) & (N - 1);                     // считаем следующий индекс по кольцу: (w0+1) mod N через маску
-        if (w1 == r.load(std::memory_order_acquire))        // если следующий write встретился с read → буфер полон
-            return false;                                     // нет места — сообщаем об этом (не блокируемся)
+    static constexpr size_t capacity() noexcept { return N - 1; }
+
+    // ---------------- продюсер ----------------
 
-        q[w0] = v;                                          // кладём элемент в текущую ячейку (w0)
-        // важно: T желательно trivially copyable для RT (никаких аллокаций)
+    bool push(const T& v) noexcept(std::is_nothrow_copy_assignable_v<T>) { return put(v); }
+    bool push(T&& v) noexcept(std::is_nothrow_move_assignable_v<T>)      { return put(std::move(v)); }
+
+    // Свободные ячейки подряд от w (до конца буфера), не больше max: пишем в них напрямую,
+    // затем commitWrite(k) публикует первые k. Пустой span — полно.
+    std::span<T> writeView(size_t max = N) noexcept { return freeRun(w.load(std::memory_order_relaxed), max); }
+    void commitWrite(size_t n) noexcept {
+        w.store((w.load(std::memory_order_relaxed) + n) & (N - 1), std::memory_order_release);
+    }
 
-        w.store(w1, std::memory_order_release);             // публикуем новую позицию записи (release, чтобы запись в q увидел потребитель)
-        return true;                                        // удачно записали
+    // Пачкой: копирует сколько влезло (с переходом через край — две части), одна публикация.
+    size_t pushN(std::span<const T> src) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+        size_t w0 = w.load(std::memory_order_relaxed), done = 0;
+        for (int part = 0; part < 2 && done < src.size(); ++part) {
+            const std::span<T> dst = freeRun(w0, src.size() - done);
+            std::copy_n(src.begin() + done, dst.size(), dst.begin());
+            done += dst.size();
+            w0 = (w0 + dst.size()) & (N - 1);
+        }
+        if (done) w.store(w0, std::memory_order_release);
+        return done;
     }
 
-    bool pop(T& v) noexcept {               // метод консюмера (аудио-поток): попытаться прочитать элемент в v
-        size_t r0 = r.load(std::memory_order_relaxed);      // локально читаем текущий индекс чтения
-        if (r0 == w.load(std::memory_order_acquire))        // если read догнал write → пусто
-            return false;                                     // нечего читать — сразу выходим
+    // ---------------- консюмер ----------------
+
+    bool pop(T& v) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const size_t r0 = r.load(std::memory_order_relaxed);
+        if (r0 == wCache_) {                                    // по кэшу пусто — перечитать w
+            wCache_ = w.load(std::memory_order_acquire);
+            if (r0 == wCache_) return false;
+        }
+        v = std::move(q[r0]);
+        r.store((r0 + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Готовые элементы подряд от r (до конца буфера), не больше max; commitRead(k) освобождает первые k.
+    std::span<T> readView(size_t max = N) noexcept { return readyRun(r.load(std::memory_order_relaxed), max); }
+    void commitRead(size_t n) noexcept {
+        r.store((r.load(std::memory_order_relaxed) + n) & (N - 1), std::memory_order_release);
+    }
+
+    // Пачкой: перемещает до dst.size() элементов, одна публикация r.
+    size_t popN(std::span<T> dst) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        size_t r0 = r.load(std::memory_order_relaxed), done = 0;
+        for (int part = 0; part < 2 && done < dst.size(); ++part) {
+            const std::span<T> src = readyRun(r0, dst.size() - done);
+            std::move(src.begin(), src.end(), dst.begin() + done);
+            done += src.size();
+            r0 = (r0 + src.size()) & (N - 1);
+        }
+        if (done) r.store(r0, std::memory_order_release);
+        return done;
+    }
+
+    // f(T&) по готовым элементам прямо в ячейках, не больше max; ячейки освобождаются одной публикацией.
+    template<class F>
+    size_t drain(F&& f, size_t max = N) {
+        size_t r0 = r.load(std::memory_order_relaxed), done = 0;
+        for (int part = 0; part < 2 && done < max; ++part) {
+            const std::span<T> src = readyRun(r0, max - done);
+            for (T& v : src) f(v);
+            done += src.size();
+            r0 = (r0 + src.size()) & (N - 1);
+        }
+        if (done) r.store(r0, std::memory_order_release);
+        return done;
+    }
+
+private:
+    // свободные ячейки подряд от w0 (до конца буфера), не больше max
+    std::span<T> freeRun(size_t w0, size_t max) noexcept {
+        size_t room = (rCache_ - w0 - 1) & (N - 1);
+        if (room < max) {                                       // кэш мог устареть — перечитать r
+            rCache_ = r.load(std::memory_order_acquire);
+            room = (rCache_ - w0 - 1) & (N - 1);
+        }
+        return { q + w0, std::min({room, N - w0, max}) };
+    }
+
+    // готовые ячейки подряд от r0 (до конца буфера), не больше max
+    std::span<T> readyRun(size_t r0, size_t max) noexcept {
+        size_t avail = (wCache_ - r0) & (N - 1);
+        if (avail < max) {
+            wCache_ = w.load(std::memory_order_acquire);
+            avail = (wCache_ - r0) & (N - 1);
+        }
+        return { q + r0, std::min({avail, N - r0, max}) };
+    }
 
-        v = q[r0];                                          // читаем элемент из текущей ячейки (r0)
-        r.store((r0 + 1) & (N - 1), std::memory_order_release); // сдвигаем read вперёд и публикуем (release)
-        return true;                                        // успешно прочитали
+    template<class U>
+    bool put(U&& v) {
+        const size_t w0 = w.load(std::memory_order_relaxed);    // локально читаем текущий индекс записи (без барьеров)
+        const size_t w1 = (w0 + 1) & (N - 1);                   // следующий индекс по кольцу: (w0+1) mod N через маску
+        if (w1 == rCache_) {                                    // по кэшу полно — перечитать r
+            rCache_ = r.load(std::memory_order_acquire);
+            if (w1 == rCache_) return false;                    // нет места — сообщаем об этом (не блокируемся)
+        }
+        q[w0] = std::forward<U>(v);                             // кладём элемент в текущую ячейку (w0)
+        w.store(w1, std::memory_order_release);                 // публикуем (release, чтобы запись в q увидел потребитель)
+        return true;
     }
-};
\ No newline at end of file
+};
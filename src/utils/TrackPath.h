@@ -26,4 +26,17 @@ namespace TrackPath {
         return s;
     }
 
+    // Обратно: трек из id параметра ("track.N.…" / "master.…"); false — не трековый
+    inline bool trackOf(std::string_view id, TrackId& track) {
+        if (id.substr(0, 7) == "master.") { track = kMasterTrack; return true; }
+        if (id.substr(0, 6) != "track.") return false;
+        int t = 0;
+        size_t i = 6;
+        if (i >= id.size() || id[i] < '0' || id[i] > '9') return false;
+        for (; i < id.size() && id[i] >= '0' && id[i] <= '9'; ++i) t = t * 10 + (id[i] - '0');
+        if (i >= id.size() || id[i] != '.') return false;
+        track = t;
+        return true;
+    }
+
 }
\ No newline at end of file
@@ -3,4 +3,5 @@
 #include "devices/SamplerNode.h"
 
 // Загружает WAV в наш non-interleaved SampleBufferPtr (float32). nullptr при ошибке.
-SampleBufferPtr LoadWavToSampleBuffer(const std::string& path, bool forceStereo);
\ No newline at end of file
+// Конверсия в частоту движка — SampleCache::convert (utils/Resampler.h).
+SampleBufferPtr LoadWavToSampleBuffer(const std::string& path, bool forceStereo);
@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "params/Automation.h"
+#include "params/ParamStoreSimple.h"
+#include "params/Smoothing.h"
+
+namespace {
+
+// эталон без курсора: линейная интерполяция по ломаной
+float reference(const std::vector<AutoPoint>& pts, double beat) {
+    if (beat <= pts.front().beat) return pts.front().value;
+    if (beat >= pts.back().beat) return pts.back().value;
+    size_t c = 0;
+    while (beat >= pts[c + 1].beat) ++c;
+    const double t = (beat - pts[c].beat) / (pts[c + 1].beat - pts[c].beat);
+    return pts[c].value + (pts[c + 1].value - pts[c].value) * (float)t;
+}
+
+bool near(float a, float b) { return std::fabs(a - b) < 1e-5f; }
+
+std::vector<double> beatsOf(const AutomationLane& l) {
+    std::vector<double> b;
+    for (const auto& p : l.points) b.push_back(p.beat);
+    return b;
+}
+
+} // namespace
+
+TEST_CASE("AutomationLane: eval follows the polyline forward and after a jump back") {
+AutomationLane l;
+l.points = {{0.0, 0.f}, {1.0, 1.f}, {2.0, 0.f}, {2.5, 0.5f}, {4.0, 2.f}};
+
+CHECK(l.eval(-1.0) == 0.f);                  // до первой точки — первое значение
+CHECK(l.eval(9.0) == 2.f);                   // после последней — последнее
+
+// вперёд мелкими шагами (курсор) и крупными (перескок сегментов)
+for (double b = 0.0; b < 4.5; b += 1.0 / 64) REQUIRE(near(l.eval(b), reference(l.points, b)));
+CHECK(near(l.eval(0.5), 0.5f));
+CHECK(near(l.eval(3.25), 1.25f));
+
+// скачок назад (луп) из конца — бинарный поиск, дальше снова вперёд
+CHECK(near(l.eval(3.9), reference(l.points, 3.9)));
+CHECK(near(l.eval(0.25), 0.25f));
+CHECK(near(l.eval(1.5), 0.5f));
+CHECK(near(l.eval(1.0), 1.f));               // ровно в точке
+CHECK(near(l.eval(0.75), 0.75f));            // назад внутри соседнего сегмента
+}
+
+TEST_CASE("AutomationLane: eval with fewer than two points") {
+AutomationLane l;
+CHECK(l.eval(1.0) == 0.f);
+l.points = {{2.0, 0.7f}};
+CHECK(l.eval(0.0) == 0.7f);
+CHECK(l.eval(5.0) == 0.7f);
+}
+
+TEST_CASE("AutomationLane: record replaces the passed range with one point") {
+AutomationLane l;
+l.points = {{0.0, 0.f}, {1.0, 1.f}, {2.0, 2.f}, {3.0, 3.f}, {4.0, 4.f}};
+
+// (1, 3] → одна точка в 3: точка в 1 остаётся, 2 и 3 заменены
+l.record(1.0, 3.0, 9.f);
+CHECK(beatsOf(l) == std::vector<double>{0.0, 1.0, 3.0, 4.0});
+CHECK(l.points[2].value == 9.f);
+
+// from == beat (транспорт стоит) — заменяется точка в этом же бите
+l.record(1.0, 1.0, 5.f);
+CHECK(beatsOf(l) == std::vector<double>{0.0, 1.0, 3.0, 4.0});
+CHECK(l.points[1].value == 5.f);
+
+// новая точка между существующими — просто вставка по порядку
+l.record(3.0, 3.5, 7.f);
+CHECK(beatsOf(l) == std::vector<double>{0.0, 1.0, 3.0, 3.5, 4.0});
+
+// в пустую полосу
+AutomationLane e;
+e.record(2.0, 2.0, 1.f);
+REQUIRE(e.points.size() == 1);
+CHECK(e.points[0].beat == 2.0);
+}
+
+TEST_CASE("AutomationEngine: automated smoother lands on the lane value every block") {
+ParameterStoreSimple store;
+store.add(std::make_unique<ParamFloat>(ParamMeta{"a", "a", ParamType::kFloat, 0.f, 1.f, 0.f, 0.f}));
+store.add(std::make_unique<ParamFloat>(ParamMeta{"b", "b", ParamType::kFloat, 0.f, 1.f, 0.f, 0.f}));
+store.commitParams();
+const ParamHandle ha = store.handle("a"), hb = store.handle("b");
+REQUIRE(ha);
+REQUIRE(hb);
+
+const std::vector<AutoPoint> pts = {{0.0, 0.f}, {1.0, 1.f}, {1.5, 0.2f}, {4.0, 0.2f}};
+AutomationEngine autom;
+autom.setLane(ha, pts);
+autom.publish();
+
+constexpr int kN = 480;                      // 10 мс @ 48 кГц — короче рампы 20 мс по умолчанию
+constexpr double kBlockBeats = 0.125;
+SmootherBank bank;
+bank.prepare(48000);
+const int ia = bank.add(store.param(ha), ha);
+const int ib = bank.add(store.param(hb), hb);
+bank.bind(store.values());
+
+for (int b = 0; b < 24; ++b) {
+    const double from = b * kBlockBeats, to = from + kBlockBeats;
+    autom.process(store, to, true);
+    store.set(hb, store.values()->get(ha));  // тот же ход руками — без флага automated
+    bank.process(kN);
+
+    // рампа ровно в блок: от значения в начале блока до значения полосы в его конце
+    const ParamSmoother& s = bank[ia];
+    REQUIRE(near(s.start(), reference(pts, from)));
+    REQUIRE(near(s.end(), reference(pts, to)));
+    REQUIRE(near(s.at(kN - 1), reference(pts, to)));
+    REQUIRE(near(s.at(kN / 2 - 1), 0.5f * (reference(pts, from) + reference(pts, to))));
+}
+CHECK(store.values()->automated(ha));
+CHECK_FALSE(store.values()->automated(hb));
+
+// контроль: неавтоматизированный параметр после излома ещё догоняет рампой 20 мс
+autom.clear();
+autom.publish();
+autom.process(store, 0.0, true);
+CHECK_FALSE(store.values()->automated(ha));
+store.set(hb, 1.f);
+bank.process(kN);
+CHECK(bank[ib].end() < 1.f);
+bank.process(kN);
+CHECK(bank[ib].end() == 1.f);
+}
+
+TEST_CASE("AutomationEngine: touched lane stops playing while recording") {
+ParameterStoreSimple store;
+store.add(std::make_unique<ParamFloat>(ParamMeta{"a", "a", ParamType::kFloat, 0.f, 1.f, 0.f, 0.f}));
+store.commitParams();
+const ParamHandle h = store.handle("a");
+
+AutomationEngine autom;
+autom.setLane(h, {{0.0, 0.f}, {4.0, 1.f}});
+autom.publish();
+autom.process(store, 2.0, true);
+CHECK(near(store.values()->get(h), 0.5f));
+
+autom.arm(true);
+autom.setPosition(2.0);
+autom.record(h, 0.9f);                       // касание — полоса молчит
+store.set(h, 0.9f);
+autom.process(store, 3.0, true);
+CHECK(store.values()->get(h) == 0.9f);
+CHECK_FALSE(store.values()->automated(h));
+
+autom.arm(false);                            // запись кончилась — снова играет, с записанной точкой
+autom.process(store, 2.0, true);
+CHECK(near(store.values()->get(h), 0.9f));
+autom.process(store, 3.0, true);
+CHECK(near(store.values()->get(h), 0.95f));
+}
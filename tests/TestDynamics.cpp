@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "fx/Dynamics.h"
+
+namespace {
+
+constexpr int kSr = 48000;
+constexpr int kBlock = 512;
+
+// блок синуса (амплитуда a) или тишины, стерео; phase — сквозной счётчик сэмплов
+void fill(std::vector<float>& L, std::vector<float>& R, float a, long& phase) {
+    for (int i = 0; i < kBlock; ++i, ++phase) {
+        L[(size_t)i] = R[(size_t)i] = a * (float)std::sin(2.0 * M_PI * 440.0 * (double)phase / kSr);
+    }
+}
+
+float peakOf(const std::vector<float>& x, int from, int to) {
+    float p = 0.f;
+    for (int i = from; i < to; ++i) p = std::max(p, std::fabs(x[(size_t)i]));
+    return p;
+}
+
+// тон → тишина → снова тон: хвост задержки выходит в первом тихом блоке, на возобновлении
+// первые latency сэмплов — задержанная тишина (ничего устаревшего не проигрывается)
+template<class Fx>
+void checkTailAndResume(Fx& fx) {
+    fx.prepare(kSr, kBlock);
+    const int lat = fx.latencySamples();
+    REQUIRE(lat > 0);
+    REQUIRE(lat < kBlock);
+
+    std::vector<float> L(kBlock), R(kBlock);
+    long phase = 0;
+    for (int b = 0; b < 8; ++b) { fill(L, R, 0.5f, phase); fx.process(L.data(), R.data(), kBlock); }
+
+    // первый тихий блок: хвост look-ahead
+    fill(L, R, 0.f, phase);
+    fx.process(L.data(), R.data(), kBlock);
+    CHECK(peakOf(L, 0, lat) > 0.1f);
+    CHECK(peakOf(L, lat, kBlock) == 0.f);
+
+    // ещё тишина — простой
+    for (int b = 0; b < 4; ++b) {
+        fill(L, R, 0.f, phase);
+        fx.process(L.data(), R.data(), kBlock);
+        CHECK(peakOf(L, 0, kBlock) == 0.f);
+        CHECK(peakOf(R, 0, kBlock) == 0.f);
+    }
+
+    // возобновление: до latency — только тишина из задержки
+    fill(L, R, 0.5f, phase);
+    fx.process(L.data(), R.data(), kBlock);
+    CHECK(peakOf(L, 0, lat) == 0.f);
+    CHECK(peakOf(R, 0, lat) == 0.f);
+    CHECK(peakOf(L, lat, kBlock) > 0.1f);
+}
+
+// мастер-цепочку движок готовит один раз под максимальный блок: хост шлёт блоки короче
+// и длиннее (их process() режет по bs_) — выход тот же, что при блоках ровно по kBlock
+template<class Fx>
+void checkAnyBlockSize(Fx& ref, Fx& fx) {
+    constexpr int kTotal = 16 * kBlock;
+    std::vector<float> inL(kTotal), inR(kTotal);
+    long phase = 0;
+    for (int off = 0; off < kTotal; off += kBlock) { // громкий тон с паузой — компрессия, release и простой
+        std::vector<float> L(kBlock), R(kBlock);
+        fill(L, R, off / kBlock == 6 ? 0.f : 1.5f, phase);
+        std::copy(L.begin(), L.end(), inL.begin() + off);
+        std::copy(R.begin(), R.end(), inR.begin() + off);
+    }
+
+    ref.prepare(kSr, kBlock);
+    fx.prepare(kSr, kBlock);
+    std::vector<float> refL = inL, refR = inR, L = inL, R = inR;
+    for (int off = 0; off < kTotal; off += kBlock) ref.process(refL.data() + off, refR.data() + off, kBlock);
+    REQUIRE(ref.reductionDb() < -1.f);           // эталон действительно давит
+
+    const int sizes[] = {1, 37, kBlock, 3 * kBlock + 5, 100};
+    bool same = true;
+    for (int off = 0, k = 0; off < kTotal; ++k) {
+        const int n = std::min(sizes[k % 5], kTotal - off);
+        fx.process(L.data() + off, R.data() + off, n);
+        off += n;
+    }
+    for (int i = 0; i < kTotal; ++i)
+        same = same && std::fabs(L[(size_t)i] - refL[(size_t)i]) < 1e-5f && std::fabs(R[(size_t)i] - refR[(size_t)i]) < 1e-5f;
+    CHECK(same);
+}
+
+} // namespace
+
+TEST_CASE("Limiter: look-ahead tail is flushed on silence, nothing replayed on resume") {
+Limiter lim;
+checkTailAndResume(lim);
+}
+
+TEST_CASE("BusCompressor: look-ahead tail is flushed on silence, nothing replayed on resume") {
+BusCompressor comp;
+checkTailAndResume(comp);
+}
+
+TEST_CASE("Limiter and BusCompressor: prepared once, any host block size gives the same output") {
+Limiter limRef, lim;
+checkAnyBlockSize(limRef, lim);
+BusCompressor compRef, comp;
+checkAnyBlockSize(compRef, comp);
+}
+
+TEST_CASE("Limiter: output stays under the ceiling") {
+Limiter lim;
+lim.prepare(kSr, kBlock);
+REQUIRE(lim.setParam("ceiling", -1.f));
+const float ceiling = std::pow(10.f, -1.f / 20.f);
+
+std::vector<float> L(kBlock), R(kBlock);
+long phase = 0;
+float peak = 0.f;
+for (int b = 0; b < 40; ++b) {
+    fill(L, R, 2.f, phase);                      // +6 дБ над полной шкалой
+    lim.process(L.data(), R.data(), kBlock);
+    if (b > 0) peak = std::max(peak, peakOf(L, 0, kBlock));
+}
+CHECK(peak <= ceiling * 1.001f);
+CHECK(peak > ceiling * 0.9f);
+CHECK(lim.reductionDb() < -5.f);
+}
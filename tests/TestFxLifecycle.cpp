@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "core/FxLifecycle.h"
+#include "core/TrackManager.h"
+
+namespace {
+
+// эффект-зонд: где и с каким SR звали prepare()
+struct ProbeFx : IFx {
+    static inline std::atomic<int> prepares{0};
+    static inline std::atomic<int> lastSr{0};
+    static inline std::atomic<bool> onMain{false};
+    static inline std::thread::id mainId;
+
+    void prepare(int sampleRate, int) override {
+        prepares.fetch_add(1);
+        lastSr.store(sampleRate);
+        if (std::this_thread::get_id() == mainId) onMain.store(true);
+    }
+    void reset() override {}
+    void process(float*, float*, int) override {}
+    std::span<const FxParamDesc> params() const override { return {}; }
+    bool setParam(std::string_view, float) override { return false; }
+    float getParam(std::string_view) const override { return 0.f; }
+    void setBypass(bool) override {}
+    bool bypass() const override { return false; }
+};
+
+struct ProbeRegistry : IFxRegistry {
+    std::atomic<int> created{0};
+    std::atomic<int> sr{0};
+    std::atomic<bool> preparedOnMain{false};
+    void prepare(int sampleRate, int) override {
+        sr.store(sampleRate);
+        if (std::this_thread::get_id() == ProbeFx::mainId) preparedOnMain.store(true);
+    }
+    bool registerFx(std::string_view, FxFactoryFn) override { return false; }
+    bool isRegistered(std::string_view type) const override { return type == "probe"; }
+    std::unique_ptr<IFx> create(std::string_view type) const override {
+        if (type != "probe") return nullptr;
+        const_cast<std::atomic<int>&>(created).fetch_add(1);
+        return std::make_unique<ProbeFx>();
+    }
+    std::vector<std::string> listTypes() const override { return {"probe"}; }
+};
+
+template<class Pred>
+bool waitFor(Pred p) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!p()) {
+        if (std::chrono::steady_clock::now() > until) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("FxLifecycle: insert prepared for a stale SR is re-prepared off the audio thread") {
+ProbeFx::mainId = std::this_thread::get_id();   // здесь — «аудиопоток»
+ProbeRegistry reg;
+TrackManager tm(1, 256, &reg);
+tm.prepare(48000, 256);
+{
+    FxLifecycle life;
+    tm.setLifecycle(&life);
+    life.setRegistry(&reg);
+    life.prepare(48000, 256);
+    life.start();
+
+    REQUIRE(life.submit(CmdAddFx{0, "probe"}));
+    REQUIRE(waitFor([&] { return reg.created.load() == 1; }));
+
+    // SR сменился, пока готовая вставка шла к аудио
+    tm.prepare(44100, 256);
+    life.prepare(44100, 256);
+
+    const bool inserted = waitFor([&] {
+        life.drainCommands([&](const TrackCommand& c) { tm.apply(c); });
+        return tm.track(0).chainSize() == 1;
+    });
+    REQUIRE(inserted);
+    CHECK(ProbeFx::lastSr.load() == 44100);
+    CHECK(ProbeFx::prepares.load() == 2);          // builder: 48000, затем переготовка 44100
+    CHECK_FALSE(ProbeFx::onMain.load());           // ни одного prepare() на «аудиопотоке»
+    CHECK(reg.created.load() == 1);
+    tm.setLifecycle(nullptr);
+}
+}
+
+TEST_CASE("FxLifecycle: SR change from the audio thread reaches the registry via the builder") {
+ProbeFx::mainId = std::this_thread::get_id();
+ProbeRegistry reg;
+FxLifecycle life;
+life.setRegistry(&reg);
+life.prepare(48000, 256);
+life.start();
+REQUIRE(waitFor([&] { return reg.sr.load() == 48000; }));
+
+life.prepare(96000, 256);                          // повторный prepare движка при работающих потоках
+REQUIRE(waitFor([&] { return reg.sr.load() == 96000; }));
+CHECK_FALSE(reg.preparedOnMain.load());
+}
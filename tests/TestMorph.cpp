@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "params/Morph.h"
+#include "params/ParamStoreSimple.h"
+
+namespace {
+
+void addParam(ParameterStoreSimple& s, const std::string& id, ParamType t, float min, float max, float def) {
+    s.add(std::make_unique<ParamFloat>(ParamMeta{id, id, t, min, max, def, 0.f}));
+}
+
+float valueOf(ParameterStoreSimple& s, const std::string& id) {
+    return s.values()->get(s.handle(id));
+}
+
+MixSnapshot snap(std::vector<std::string> ids, std::vector<float> values) {
+    MixSnapshot s;
+    s.ids = std::move(ids);
+    s.values = std::move(values);
+    return s;
+}
+
+bool near(float a, float b) { return std::fabs(a - b) <= 1e-4f * std::max(1.f, std::fabs(b)); }
+
+} // namespace
+
+TEST_CASE("MixSnapshot: blob round-trip, truncated and foreign blobs are rejected") {
+const MixSnapshot s = snap({"mix.gain", "", "track.3.fx.0.cutoff"}, {0.25f, -1.f, 1234.5f});
+const std::vector<uint8_t> blob = s.toBlob();
+
+MixSnapshot back;
+REQUIRE(MixSnapshot::fromBlob(blob, back));
+CHECK(back.ids == s.ids);
+CHECK(back.values == s.values);
+
+// обрезанный на любом байте — отказ, out не тронут
+for (size_t cut = 0; cut < blob.size(); ++cut) {
+    MixSnapshot out = snap({"keep"}, {7.f});
+    REQUIRE_FALSE(MixSnapshot::fromBlob(std::span(blob.data(), cut), out));
+    REQUIRE(out.ids.size() == 1);
+}
+std::vector<uint8_t> foreign = blob;
+foreign[3] = '9';
+MixSnapshot out;
+CHECK_FALSE(MixSnapshot::fromBlob(foreign, out));
+}
+
+TEST_CASE("MorphEngine: snapshot is matched by id across layouts") {
+// снимок снят в другой раскладке: порядок другой, "gone" удалён, "fresh" добавлен позже
+const MixSnapshot s = snap({"c", "gone", "a", "b"}, {0.3f, 0.9f, 0.1f, 0.2f});
+
+ParameterStoreSimple store;
+addParam(store, "a", ParamType::kFloat, 0.f, 1.f, 0.5f);
+addParam(store, "b", ParamType::kFloat, 0.f, 1.f, 0.5f);
+addParam(store, "c", ParamType::kFloat, 0.f, 1.f, 0.5f);
+addParam(store, "fresh", ParamType::kFloat, 0.f, 1.f, 0.75f);
+store.commitParams();
+
+MorphEngine morph;
+morph.prepare(store);
+REQUIRE(morph.size() == 4);
+REQUIRE(morph.load(store, 0, s));
+CHECK_FALSE(morph.load(store, MorphEngine::kMaxSlots, s));
+
+morph.setMorph(0, -1, 0.f);
+morph.process(store);
+CHECK(valueOf(store, "a") == 0.1f);
+CHECK(valueOf(store, "b") == 0.2f);
+CHECK(valueOf(store, "c") == 0.3f);
+CHECK(valueOf(store, "fresh") == 0.75f); // нет в снимке — текущее на момент load
+
+// capture → blob → load: то же, что в сторе
+MixSnapshot again;
+REQUIRE(MixSnapshot::fromBlob(MixSnapshot::capture(store).toBlob(), again));
+store.set(store.handle("a"), 0.9f);
+REQUIRE(morph.load(store, 1, again));
+morph.setMorph(1, -1, 0.f);
+morph.process(store);
+CHECK(valueOf(store, "a") == 0.1f);
+}
+
+TEST_CASE("MorphEngine: Linear, Log and Step curves") {
+ParameterStoreSimple store;
+addParam(store, "lin",  ParamType::kFloat, 0.f, 1.f, 0.f);
+addParam(store, "freq", ParamType::kFloat, 20.f, 20000.f, 1000.f); // широкий положительный — Log
+addParam(store, "mode", ParamType::kInt, 0.f, 4.f, 0.f);           // дискретный — Step
+store.commitParams();
+
+MorphEngine morph;
+morph.prepare(store);
+REQUIRE(morph.load(store, 1, snap({"lin", "freq", "mode"}, {0.f, 100.f, 1.f})));
+REQUIRE(morph.load(store, 3, snap({"lin", "freq", "mode"}, {1.f, 10000.f, 3.f})));
+
+SECTION("weights between A and B") {
+    morph.setMorph(1, 3, 0.25f);
+    morph.process(store);
+    CHECK(near(valueOf(store, "lin"), 0.25f));
+    CHECK(near(valueOf(store, "freq"), 100.f * std::pow(100.f, 0.25f))); // геометрически: 316.2
+    CHECK(valueOf(store, "mode") == 1.f);
+
+    morph.setMorph(1, 3, 0.75f);
+    morph.process(store);
+    CHECK(near(valueOf(store, "lin"), 0.75f));
+    CHECK(near(valueOf(store, "freq"), 100.f * std::pow(100.f, 0.75f)));
+    CHECK(valueOf(store, "mode") == 3.f);
+}
+
+SECTION("Step tie goes to B in argument order, not slot order") {
+    morph.setMorph(1, 3, 0.5f);
+    morph.process(store);
+    CHECK(valueOf(store, "mode") == 3.f);
+
+    morph.setMorph(3, 1, 0.5f);                 // B — слот 1, хотя номер меньше
+    morph.process(store);
+    CHECK(valueOf(store, "mode") == 1.f);
+    CHECK(near(valueOf(store, "freq"), 1000.f));
+
+    const float w[] = {0.f, 1.f, 0.f, 1.f};     // setWeights без A/B — слот с большим номером
+    morph.setWeights(w);
+    morph.process(store);
+    CHECK(valueOf(store, "mode") == 3.f);
+}
+
+SECTION("setCurve overrides the automatic curve and re-applies the morph") {
+    morph.setMorph(1, 3, 0.5f);
+    morph.process(store);
+    CHECK(near(valueOf(store, "freq"), 1000.f));
+
+    morph.setCurve(store.handle("freq"), MorphCurve::Linear);
+    morph.process(store);                       // веса те же — пересчёт из-за кривой
+    CHECK(near(valueOf(store, "freq"), 5050.f));
+
+    morph.setCurve(store.handle("lin"), MorphCurve::Step);
+    morph.process(store);
+    CHECK(valueOf(store, "lin") == 1.f);
+}
+
+SECTION("unchanged weights leave the store alone") {
+    morph.setMorph(1, 3, 0.5f);
+    morph.process(store);
+    store.set(store.handle("lin"), 0.9f);       // ручка после морфа
+    morph.process(store);
+    CHECK(valueOf(store, "lin") == 0.9f);
+}
+}
+
+// Бенчмарк — скрыт от ctest: ./TestsMorph "[bench]"
+TEST_CASE("MorphEngine: 768 params per morph step", "[.][bench]") {
+constexpr int kParams = 768;
+ParameterStoreSimple store;
+for (int i = 0; i < kParams; ++i) {
+    const std::string id = "p" + std::to_string(i);
+    if (i % 8 == 0)      addParam(store, id, ParamType::kFloat, 20.f, 20000.f, 1000.f); // Log
+    else if (i % 8 == 1) addParam(store, id, ParamType::kInt, 0.f, 4.f, 0.f);           // Step
+    else                 addParam(store, id, ParamType::kFloat, 0.f, 1.f, 0.5f);
+}
+store.commitParams();
+
+MorphEngine morph;
+morph.prepare(store);
+MixSnapshot a = MixSnapshot::capture(store), b = a;
+for (int i = 0; i < kParams; ++i) b.values[(size_t)i] = i % 8 == 0 ? 5000.f : i % 8 == 1 ? 3.f : 0.1f;
+REQUIRE(morph.load(store, 0, a));
+REQUIRE(morph.load(store, 1, b));
+
+float t = 0.f;
+BENCHMARK("A→B morph step, 1/8 Log, 1/8 Step") {
+    t = t > 0.99f ? 0.f : t + 0.01f;
+    morph.setMorph(0, 1, t);
+    morph.process(store);
+    return store.values()->get(ParamHandle{0});
+};
+}
@@ -0,0 +1,168 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+#include "utils/MpscRing.h"
+#include "utils/SpscRing.h"
+
+TEST_CASE("MpscRing: basic push/pop FIFO order") {
+MpscRing<int, 8> q;
+
+int out = 0;
+REQUIRE_FALSE(q.pop(out));
+REQUIRE_FALSE(q.ready());
+
+REQUIRE(q.push(1));
+REQUIRE(q.push(2));
+REQUIRE(q.push(3));
+REQUIRE(q.ready());
+
+REQUIRE(q.pop(out)); CHECK(out == 1);
+REQUIRE(q.pop(out)); CHECK(out == 2);
+REQUIRE(q.pop(out)); CHECK(out == 3);
+REQUIRE_FALSE(q.pop(out));
+}
+
+TEST_CASE("MpscRing: capacity and wrap-around") {
+// в отличие от SpscRing ёмкость — все N ячеек
+constexpr size_t N = 4;
+MpscRing<int, N> q;
+
+for (int i = 0; i < (int)N; ++i) REQUIRE(q.push(i));
+REQUIRE_FALSE(q.push(100));
+
+int x;
+REQUIRE(q.pop(x)); CHECK(x == 0);
+REQUIRE(q.pop(x)); CHECK(x == 1);
+
+// несколько кругов подряд — последовательности ячеек не ломаются
+for (int round = 0; round < 10; ++round) {
+    REQUIRE(q.push(10 + round * 2));
+    REQUIRE(q.push(11 + round * 2));
+    REQUIRE_FALSE(q.push(-1));
+    REQUIRE(q.pop(x));
+    REQUIRE(q.pop(x));
+}
+REQUIRE(q.pop(x)); CHECK(x == 28);
+REQUIRE(q.pop(x)); CHECK(x == 29);
+REQUIRE_FALSE(q.pop(x));
+}
+
+TEST_CASE("MpscRing: drain takes a batch in order and respects max") {
+MpscRing<int, 16> q;
+for (int i = 0; i < 10; ++i) REQUIRE(q.push(i));
+
+std::vector<int> got;
+CHECK(q.drain([&](int& v){ got.push_back(v); }, 4) == 4);
+CHECK(q.drain([&](int& v){ got.push_back(v); }) == 6);
+CHECK(q.drain([&](int& v){ got.push_back(v); }) == 0);
+
+REQUIRE(got.size() == 10);
+for (int i = 0; i < 10; ++i) CHECK(got[(size_t)i] == i);
+
+// после drain освободились все ячейки
+for (int i = 0; i < 16; ++i) REQUIRE(q.push(i));
+REQUIRE_FALSE(q.push(16));
+}
+
+TEST_CASE("MpscRing: move-only payload") {
+MpscRing<std::unique_ptr<int>, 4> q;
+REQUIRE(q.push(std::make_unique<int>(7)));
+std::unique_ptr<int> out;
+REQUIRE(q.pop(out));
+REQUIRE(out);
+CHECK(*out == 7);
+}
+
+TEST_CASE("MpscRing: multi-producer stress keeps per-producer order") {
+constexpr int PRODUCERS = 4;
+constexpr int PER = 200000;
+struct Msg { int producer = 0; int seq = 0; };
+MpscRing<Msg, 1024> q;
+
+std::atomic<bool> start{false};
+std::vector<std::thread> producers;
+for (int p = 0; p < PRODUCERS; ++p) {
+    producers.emplace_back([&, p]{
+        while (!start.load(std::memory_order_acquire)) {}
+        for (int i = 1; i <= PER; ) {
+            if (q.push(Msg{p, i})) ++i;
+            else std::this_thread::yield();
+        }
+    });
+}
+
+// консюмер — в этом потоке: REQUIRE только отсюда
+std::vector<int> last(PRODUCERS, 0);
+bool ordered = true;
+long total = 0;
+start.store(true, std::memory_order_release);
+while (total < (long)PRODUCERS * PER) {
+    const size_t n = q.drain([&](Msg& m){
+        if (m.seq != last[(size_t)m.producer] + 1) ordered = false;
+        last[(size_t)m.producer] = m.seq;
+    }, 64);
+    if (n == 0) std::this_thread::yield();
+    total += (long)n;
+}
+for (auto& t : producers) t.join();
+
+CHECK(ordered);
+for (int p = 0; p < PRODUCERS; ++p) CHECK(last[(size_t)p] == PER);
+Msg rest;
+REQUIRE_FALSE(q.pop(rest));
+}
+
+// Бенчмарки — скрыты от ctest: ./TestsMpscRing "[bench]"
+TEST_CASE("MpscRing: push/pop throughput", "[.][bench]") {
+constexpr int BATCH = 512;
+MpscRing<int, 1024> mpsc;
+SpscRing<int, 1024> spsc;
+
+BENCHMARK("SpscRing push+pop x512") {
+    int s = 0, x = 0;
+    for (int i = 0; i < BATCH; ++i) (void)spsc.push(i);
+    while (spsc.pop(x)) s += x;
+    return s;
+};
+BENCHMARK("MpscRing push+pop x512") {
+    int s = 0, x = 0;
+    for (int i = 0; i < BATCH; ++i) (void)mpsc.push(i);
+    while (mpsc.pop(x)) s += x;
+    return s;
+};
+BENCHMARK("MpscRing push+drain x512") {
+    int s = 0;
+    for (int i = 0; i < BATCH; ++i) (void)mpsc.push(i);
+    mpsc.drain([&](int& v){ s += v; });
+    return s;
+};
+}
+
+TEST_CASE("MpscRing: 4 contended producers", "[.][bench]") {
+constexpr int PRODUCERS = 4;
+constexpr int PER = 50000;
+MpscRing<int, 1024> q;
+
+BENCHMARK("4 producers -> 1 consumer, 200k items") {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ts;
+    for (int p = 0; p < PRODUCERS; ++p)
+        ts.emplace_back([&]{
+            while (!go.load(std::memory_order_acquire)) {}
+            for (int i = 0; i < PER; ) { if (q.push(i)) ++i; else std::this_thread::yield(); }
+        });
+    long got = 0, s = 0;
+    go.store(true, std::memory_order_release);
+    while (got < (long)PRODUCERS * PER) {
+        const size_t n = q.drain([&](int& v){ s += v; });
+        if (n == 0) std::this_thread::yield();
+        got += (long)n;
+    }
+    for (auto& t : ts) t.join();
+    return s;
+};
+}
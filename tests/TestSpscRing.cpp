@@ -4,6 +4,8 @@
 #include <vector>
 #include <atomic>
 #include <chrono>
+#include <memory>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 // подстрой путь инклуда под проект (например, "utils/SpscRing.h")
 #include "utils/SpscRing.h"
@@ -114,4 +116,217 @@ consumer.join();
 
 CHECK(produced.load() == TOTAL);
 CHECK(consumed.load() == TOTAL);
-}
\ No newline at end of file
+}
+
+TEST_CASE("SpscRing: pushN/popN wrap around in two parts") {
+SpscRing<int, 8> q;                      // ёмкость 7
+int x;
+for (int i = 0; i < 5; ++i) REQUIRE(q.push(i));
+for (int i = 0; i < 5; ++i) REQUIRE(q.pop(x));   // w = r = 5
+
+const int src[7] = {1, 2, 3, 4, 5, 6, 7};
+CHECK(q.pushN(src) == 7);                // 3 до края + 4 с начала
+CHECK(q.pushN(src) == 0);                // полна
+
+int dst[10] = {};
+CHECK(q.popN(std::span<int>(dst, 3)) == 3);
+CHECK(q.popN(std::span<int>(dst + 3, 7)) == 4);
+for (int i = 0; i < 7; ++i) CHECK(dst[i] == i + 1);
+REQUIRE_FALSE(q.pop(x));
+}
+
+TEST_CASE("SpscRing: write/read views are zero-copy and publish on commit") {
+SpscRing<int, 8> q;
+
+auto wv = q.writeView(3);
+REQUIRE(wv.size() == 3);
+wv[0] = 10; wv[1] = 20; wv[2] = 30;
+CHECK(q.readView().empty());             // не опубликовано — консюмер не видит
+q.commitWrite(2);                        // публикуем только два
+
+auto rv = q.readView();
+REQUIRE(rv.size() == 2);
+CHECK(rv[0] == 10);
+CHECK(rv[1] == 20);
+q.commitRead(1);
+
+int x;
+REQUIRE(q.pop(x)); CHECK(x == 20);
+REQUIRE_FALSE(q.pop(x));
+
+// drain: по месту, с ограничением
+for (int i = 0; i < 6; ++i) REQUIRE(q.push(i));
+int sum = 0;
+CHECK(q.drain([&](int& v){ sum += v; }, 4) == 4);
+CHECK(sum == 0 + 1 + 2 + 3);
+CHECK(q.drain([&](int& v){ sum += v; }) == 2);
+CHECK(sum == 15);
+}
+
+TEST_CASE("SpscRing: move-only payload") {
+SpscRing<std::unique_ptr<int>, 4> q;
+REQUIRE(q.push(std::make_unique<int>(1)));
+REQUIRE(q.push(std::make_unique<int>(2)));
+
+std::unique_ptr<int> out;
+REQUIRE(q.pop(out));
+REQUIRE(out);
+CHECK(*out == 1);
+
+std::unique_ptr<int> batch[2];
+CHECK(q.popN(batch) == 1);
+REQUIRE(batch[0]);
+CHECK(*batch[0] == 2);
+}
+
+TEST_CASE("SpscRing: batched producer/consumer (multithread)") {
+constexpr int TOTAL = 1000000;
+SpscRing<int, 1024> q;
+
+std::thread producer([&]{
+    int next = 1;
+    while (next <= TOTAL) {
+        auto v = q.writeView((size_t)(TOTAL - next + 1));
+        for (auto& slot : v) slot = next++;
+        q.commitWrite(v.size());
+        if (v.empty()) std::this_thread::yield();
+    }
+});
+
+int last = 0;
+bool ordered = true;
+while (last < TOTAL) {
+    const size_t n = q.drain([&](int& x){ if (x != last + 1) ordered = false; last = x; });
+    if (n == 0) std::this_thread::yield();
+}
+producer.join();
+CHECK(ordered);
+CHECK(last == TOTAL);
+}
+
+// Бенчмарки — скрыты от ctest: ./TestsSpscRing "[bench]"
+// v1 — кольцо до кэширования индексов и пачек (каждый push/pop читает чужой атомик acquire):
+// копия здесь, чтобы сравнивать старое и новое на одной машине.
+namespace v1 {
+template<class T, size_t N>
+struct SpscRing {
+    alignas(64) std::atomic<size_t> w{0};
+    alignas(64) std::atomic<size_t> r{0};
+    alignas(64) T q[N];
+
+    bool push(const T& v) noexcept {
+        const size_t w0 = w.load(std::memory_order_relaxed);
+        const size_t w1 = (w0 + 1) & (N - 1);
+        if (w1 == r.load(std::memory_order_acquire)) return false;
+        q[w0] = v;
+        w.store(w1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& v) noexcept {
+        const size_t r0 = r.load(std::memory_order_relaxed);
+        if (r0 == w.load(std::memory_order_acquire)) return false;
+        v = q[r0];
+        r.store((r0 + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+};
+} // namespace v1
+
+namespace {
+
+constexpr int kBenchTotal = 1 << 20;
+constexpr int kBenchBatch = 256;
+
+// продюсер в своём потоке, консюмер — здесь; поэлементно
+template<class Q>
+long crossPerElement() {
+    auto q = std::make_unique<Q>();
+    std::thread producer([&]{
+        for (int i = 0; i < kBenchTotal; ) { if (q->push(i)) ++i; else std::this_thread::yield(); }
+    });
+    long s = 0;
+    int x;
+    for (int got = 0; got < kBenchTotal; ) { if (q->pop(x)) { s += x; ++got; } else std::this_thread::yield(); }
+    producer.join();
+    return s;
+}
+
+// один поток: push x256, затем pop до пусто — стоимость самих операций без ожидания соседа
+template<class Q>
+long samePerElement(Q& q) {
+    long s = 0;
+    int x;
+    for (int i = 0; i < kBenchBatch; ++i) (void)q.push(i);
+    while (q.pop(x)) s += x;
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("SpscRing: v1 vs v2, per element and batched", "[.][bench]") {
+// На одном ядре кросс-поточные замеры меряют в основном yield(); сравнивать их — на многоядерной машине.
+BENCHMARK("v1 push/pop per element, cross-thread, 1M ints") { return crossPerElement<v1::SpscRing<int, 1024>>(); };
+BENCHMARK("v2 push/pop per element, cross-thread, 1M ints") { return crossPerElement<SpscRing<int, 1024>>(); };
+
+// v1 пачек не умеет: её «пачка» — те же поэлементные push/pop, каждый со своим acquire чужого индекса
+BENCHMARK("v1 batched (256 x push, pop until empty), cross-thread, 1M ints") {
+    auto q = std::make_unique<v1::SpscRing<int, 1024>>();
+    std::thread producer([&]{
+        for (int i = 0; i < kBenchTotal; ) {
+            const int k = std::min(kBenchBatch, kBenchTotal - i);
+            int j = 0;
+            while (j < k && q->push(i + j)) ++j;
+            if (j == 0) std::this_thread::yield();
+            i += j;
+        }
+    });
+    long s = 0;
+    int x;
+    for (long got = 0; got < kBenchTotal; ) {
+        long n = 0;
+        while (q->pop(x)) { s += x; ++n; }
+        if (n == 0) std::this_thread::yield();
+        got += n;
+    }
+    producer.join();
+    return s;
+};
+
+BENCHMARK("v2 pushN/drain, cross-thread, 1M ints in 256-batches") {
+    auto q = std::make_unique<SpscRing<int, 1024>>();
+    std::thread producer([&]{
+        int buf[kBenchBatch];
+        for (int i = 0; i < kBenchTotal; ) {
+            const int k = std::min(kBenchBatch, kBenchTotal - i);
+            for (int j = 0; j < k; ++j) buf[j] = i + j;
+            const size_t n = q->pushN(std::span<const int>(buf, (size_t)k));
+            if (n == 0) std::this_thread::yield();
+            i += (int)n;
+        }
+    });
+    long s = 0;
+    for (long got = 0; got < kBenchTotal; ) {
+        const size_t n = q->drain([&](int& v){ s += v; });
+        if (n == 0) std::this_thread::yield();
+        got += (long)n;
+    }
+    producer.join();
+    return s;
+};
+
+// Поэлементно в одном потоке v2 может быть медленнее v1: чужой индекс и так в своём кэше (acquire на
+// x86 — обычная загрузка), а v2 сверх того читает/пишет кэш-поле. Выигрыш v2 — когда соседи на разных
+// ядрах (чужая линия тянется раз на пачку) и в пачках; аудиопоток забирает очереди drain-ом.
+auto a = std::make_unique<v1::SpscRing<int, 1024>>();
+auto b = std::make_unique<SpscRing<int, 1024>>();
+BENCHMARK("v1 push x256 + pop x256, one thread") { return samePerElement(*a); };
+BENCHMARK("v2 push x256 + pop x256, one thread") { return samePerElement(*b); };
+BENCHMARK("v2 pushN x256 + drain, one thread") {
+    int buf[kBenchBatch];
+    for (int j = 0; j < kBenchBatch; ++j) buf[j] = j;
+    (void)b->pushN(std::span<const int>(buf, (size_t)kBenchBatch));
+    long s = 0;
+    b->drain([&](int& v){ s += v; });
+    return s;
+};
+}
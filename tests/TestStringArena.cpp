@@ -0,0 +1,36 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+#include "bus/StringArena.h"
+
+TEST_CASE("StringArena: view returns interned string, 0 is empty") {
+StringArena a;
+const StringId id = a.intern("snare.wav");
+REQUIRE(id);
+CHECK(a.view(id) == "snare.wav");
+CHECK(a.view(StringId{}).empty());
+}
+
+TEST_CASE("StringArena: re-interned string survives the next intern") {
+// повторная строка получает свежий id — не тот, что стоит на вытеснении следующим
+StringArena a;
+const StringId first = a.intern("kick.wav");
+for (uint32_t i = 1; i < StringArena::kCapacity; ++i) a.intern("other_" + std::to_string(i));
+
+const StringId again = a.intern("kick.wav");
+a.intern("new.wav");
+
+CHECK(a.view(again) == "kick.wav");
+CHECK(a.view(first).empty());             // вытеснен через kCapacity интернов
+}
+
+TEST_CASE("StringArena: id stays valid for kCapacity interns, then reads empty") {
+StringArena a;
+const StringId id = a.intern("pad.wav");
+for (uint32_t i = 1; i < StringArena::kCapacity; ++i) {
+    a.intern("x" + std::to_string(i));
+    REQUIRE(a.view(id) == "pad.wav");
+}
+a.intern("evicts");
+CHECK(a.view(id).empty());
+}
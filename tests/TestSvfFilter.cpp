@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "fx/SvfFilter.h"
+
+namespace {
+
+constexpr int kSr = 48000;
+constexpr int kBlock = 256;
+constexpr float kFc = 1000.f;
+constexpr float kButterworthQ = 0.70710678f;
+
+// АЧХ на частоте f, дБ: синус через фильтр, RMS выхода / RMS входа после установления
+double gainDb(float mode, float q, double f) {
+    SvfFilter flt;
+    flt.prepare(kSr, kBlock);
+    REQUIRE(flt.setParam("mode", mode));
+    REQUIRE(flt.setParam("cutoff", kFc));
+    REQUIRE(flt.setParam("q", q));
+
+    std::vector<float> L(kBlock), R(kBlock);
+    double in2 = 0.0, out2 = 0.0;
+    bool same = true;
+    long t = 0;
+    for (int b = 0; b < 400; ++b) {              // ~2 с: первые 100 блоков — установление
+        for (int i = 0; i < kBlock; ++i, ++t) L[(size_t)i] = R[(size_t)i] = (float)std::sin(2.0 * M_PI * f * (double)t / kSr);
+        if (b >= 100) for (float x : L) in2 += (double)x * x;
+        flt.process(L.data(), R.data(), kBlock);
+        if (b >= 100) for (float y : L) out2 += (double)y * y;
+        same = same && L == R;
+    }
+    CHECK(same);                                 // L/R — одинаковые лейны
+    return 10.0 * std::log10(out2 / in2);
+}
+
+// аналоговая частота ω (в долях среза) → цифровая: g = tan(π·f/sr) предискажён на срезе
+double digitalHz(double w) {
+    const double g = std::tan(M_PI * kFc / kSr);
+    return kSr / M_PI * std::atan(w * g);
+}
+
+} // namespace
+
+TEST_CASE("SvfFilter: LP and HP are -3 dB at cutoff (Q = 1/sqrt 2)") {
+const float lp = (float)SvfMode::LowPass, hp = (float)SvfMode::HighPass;
+CHECK(std::fabs(gainDb(lp, kButterworthQ, kFc) + 3.01) < 0.1);
+CHECK(std::fabs(gainDb(hp, kButterworthQ, kFc) + 3.01) < 0.1);
+
+// полоса пропускания / задерживания на декаду от среза
+CHECK(std::fabs(gainDb(lp, kButterworthQ, kFc / 10.0)) < 0.1);
+CHECK(gainDb(lp, kButterworthQ, kFc * 10.0) < -38.0);
+CHECK(std::fabs(gainDb(hp, kButterworthQ, kFc * 10.0)) < 0.1);
+CHECK(gainDb(hp, kButterworthQ, kFc / 10.0) < -38.0);
+}
+
+TEST_CASE("SvfFilter: BP peaks at 0 dB on cutoff and is -3 dB at the band edges") {
+// BP = k·v1 — единичный пик на срезе; −3 дБ — на краях полосы ω = √(1 + k²/4) ± k/2 (ширина fc/Q)
+const float bp = (float)SvfMode::BandPass;
+for (float q : {kButterworthQ, 2.f, 8.f}) {
+    const double k = 1.0 / q;
+    const double lo = std::sqrt(1.0 + k * k / 4.0) - k / 2.0, hi = lo + k;
+    CHECK(std::fabs(gainDb(bp, q, kFc)) < 0.1);
+    CHECK(std::fabs(gainDb(bp, q, digitalHz(lo)) + 3.01) < 0.15);
+    CHECK(std::fabs(gainDb(bp, q, digitalHz(hi)) + 3.01) < 0.15);
+}
+}
+
+TEST_CASE("SvfFilter: stable under fast cutoff/Q/mode sweeps") {
+constexpr int kSmall = 16;                       // новые цели каждые 16 сэмплов
+SvfFilter flt;
+flt.prepare(kSr, kSmall);
+
+std::vector<float> L(kSmall), R(kSmall);
+std::uint32_t rng = 1;
+auto noise = [&] { rng = rng * 1664525u + 1013904223u; return (float)(int32_t)rng * (1.f / 2147483648.f); };
+
+float peak = 0.f;
+bool finite = true;
+for (int b = 0; b < 3 * kSr / kSmall; ++b) {     // 3 с
+    // срез прыгает по всей шкале (20 Гц ↔ 20 кГц), Q до максимума, режим меняется каждые 64 блока
+    const double ph = (double)b / 37.0;
+    flt.setParam("cutoff", (float)(20.0 * std::pow(1000.0, 0.5 + 0.5 * std::sin(ph))));
+    flt.setParam("q", (b & 1) ? 20.f : 0.5f);
+    flt.setParam("mode", (float)((b / 64) % 4));
+    for (int i = 0; i < kSmall; ++i) L[(size_t)i] = R[(size_t)i] = 0.5f * noise();
+    flt.process(L.data(), R.data(), kSmall);
+    for (float y : L) {
+        finite = finite && std::isfinite(y);
+        peak = std::max(peak, std::fabs(y));
+    }
+}
+CHECK(finite);
+CHECK(peak < 50.f);                              // резонанс Q = 20 даёт пики, но не разнос
+
+// после свипа (ручки вернули) тишина гасит состояния: фильтр засыпает, выход — ноль
+flt.setParam("cutoff", kFc);
+flt.setParam("q", kButterworthQ);
+for (int b = 0; b < kSr / kSmall; ++b) {
+    std::fill(L.begin(), L.end(), 0.f);
+    std::fill(R.begin(), R.end(), 0.f);
+    flt.process(L.data(), R.data(), kSmall);
+}
+CHECK(std::all_of(L.begin(), L.end(), [](float y) { return std::fabs(y) < 1e-6f; }));
+}
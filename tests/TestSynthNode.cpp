@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <vector>
+
+#include "devices/SynthNode.h"
+
+namespace {
+
+constexpr int kSr = 48000;
+constexpr int kBlock = 512;
+
+// синт без трекового слоя и стора: пишет прямо в io (прибавляет)
+struct Rig {
+    SynthNode synth{"synth"};
+    std::vector<float> L = std::vector<float>(kBlock), R = std::vector<float>(kBlock);
+    float* ch[2] = {L.data(), R.data()};
+    AlchemyAudioBuffer io{ch, 2, kBlock};
+    MidiBuffer midi;
+    ProcessContext ctx{};
+
+    Rig() {
+        ctx.sampleRate = kSr;
+        ctx.blockSize = kBlock;
+        synth.prepare(ctx);
+    }
+    void block() {
+        std::fill(L.begin(), L.end(), 0.f);
+        std::fill(R.begin(), R.end(), 0.f);
+        synth.process(io, midi, ctx);
+    }
+};
+
+float rms(const std::vector<float>& x) {
+    double s = 0.0;
+    for (float v : x) s += (double)v * v;
+    return (float)std::sqrt(s / (double)x.size());
+}
+
+} // namespace
+
+TEST_CASE("SynthNode: unison note is spread in stereo, single note is centred") {
+Rig mono;
+mono.synth.noteOn(57, 1.f);
+for (int b = 0; b < 4; ++b) mono.block();
+REQUIRE(rms(mono.L) > 0.f);
+CHECK(mono.L == mono.R);                         // один лейн — по центру
+
+Rig wide;
+wide.synth.setUnison(7, 0.5f);
+wide.synth.noteOn(57, 1.f);
+for (int b = 0; b < 4; ++b) wide.block();
+REQUIRE(rms(wide.L) > 0.f);
+CHECK(wide.L != wide.R);                         // разнос лейнов по панораме
+// громкость нормирована 1/√N: 7 некоррелированных лейнов ≈ одна нота, а не в 7 раз громче
+CHECK(rms(wide.L) < 2.f * rms(mono.L));
+}
+
+// Бенчмарки — скрыты от ctest: ./TestsSynthNode "[bench]"
+TEST_CASE("SynthNode: 7-lane unison note vs 7 separate notes", "[.][bench]") {
+Rig one, uni, seven;
+one.synth.noteOn(57, 1.f);
+uni.synth.setUnison(7, 0.5f);
+uni.synth.noteOn(57, 1.f);
+for (int k = 0; k < 7; ++k) seven.synth.noteOn(45 + 3 * k, 1.f);
+
+BENCHMARK("1 note, no unison, 512 frames") { one.block(); return one.L[0]; };
+BENCHMARK("1 note, 7-lane unison, 512 frames") { uni.block(); return uni.L[0]; };
+BENCHMARK("7 notes, no unison, 512 frames") { seven.block(); return seven.L[0]; };
+}
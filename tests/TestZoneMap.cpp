@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <memory>
+
+#include "devices/ZoneMap.h"
+#include "utils/SampleCache.h"
+
+namespace {
+
+SampleBufferPtr makeSample(int frames, int sr) {
+    auto sb = std::make_shared<SampleBuffer>();
+    sb->sr = sr;
+    sb->channels = 1;
+    sb->frames = frames;
+    sb->dataL = std::shared_ptr<float[]>(new float[(size_t)frames]);
+    for (int i = 0; i < frames; ++i) sb->dataL[i] = std::sin(0.01f * (float)i);
+    return sb;
+}
+
+SampleZone zone(SampleBufferPtr s, int loVel, int hiVel) {
+    SampleZone z;
+    z.sample = std::move(s);
+    z.loVel = loVel;
+    z.hiVel = hiVel;
+    return z;
+}
+
+} // namespace
+
+TEST_CASE("ZoneMap: velocity layers and round-robin") {
+auto a = makeSample(1000, 48000), b = makeSample(1000, 48000), c = makeSample(1000, 48000);
+auto m = ZoneMap::build({zone(a, 1, 63), zone(b, 64, 127), zone(c, 64, 127)});
+REQUIRE(m->zoneCount() == 3);
+
+CHECK(m->pick(60, 0.2f)->sample == a);
+const SampleZone* z1 = m->pick(60, 0.9f);
+const SampleZone* z2 = m->pick(60, 0.9f);
+CHECK(z1->sample != z2->sample);             // loud-слой: b/c по кругу
+CHECK(m->pick(60, 0.9f)->sample == z1->sample);
+CHECK(m->pick(-1, 0.5f) == nullptr);
+}
+
+TEST_CASE("ZoneMap: keeps source zones so a rebuild at a new rate starts from originals") {
+SampleCache cache;
+auto src = makeSample(44100, 44100);
+SampleZone z = zone(src, 1, 127);
+z.region = {1000, 20000, 2000, 10000, LoopMode::Forward};
+
+auto m48 = ZoneMap::build({z}, &cache, 48000);
+REQUIRE(m48->zoneCount() == 1);
+CHECK(m48->targetSr() == 48000);
+REQUIRE(m48->sources().size() == 1);
+CHECK(m48->sources()[0].sample == src);      // оригинал, не сконвертированный буфер
+CHECK(m48->sources()[0].region.start == 1000);
+
+const SampleZone* p48 = m48->pick(60, 0.5f);
+CHECK(p48->sample->sr == 48000);
+CHECK(std::abs(p48->region.start - 1088) <= 1);   // 1000 · 48000/44100
+
+// как SamplerNode::prepare при смене частоты: из sources(), а не из сконвертированных зон
+auto m96 = ZoneMap::build(m48->sources(), &cache, 96000, m48->format());
+const SampleZone* p96 = m96->pick(60, 0.5f);
+CHECK(p96->sample->sr == 96000);
+CHECK(std::abs(p96->region.start - 2177) <= 1);   // 1000 · 96000/44100
+CHECK(std::abs(p96->region.loopEnd - 21769) <= 1);
+
+// без кеша — без конверсии: таблица не привязана к частоте
+CHECK(ZoneMap::build({z})->targetSr() == 0);
+}
+
+TEST_CASE("SampleCache: converted buffers live only as long as their users") {
+SampleCache cache;
+auto src = makeSample(4410, 44100);
+auto a = cache.convert(src, 48000);
+REQUIRE(a);
+CHECK(cache.convert(src, 48000) == a);       // пока держат — тот же буфер
+CHECK(cache.size() == 1);
+
+// копия под прежнюю частоту никому не нужна — кеш её не держит
+std::weak_ptr<SampleBuffer> old = a;
+a.reset();
+CHECK(old.expired());
+CHECK(cache.size() == 0);
+auto b = cache.convert(src, 96000);          // convert() заодно вычищает мёртвые записи
+CHECK(cache.size() == 1);
+
+// заменённый семпл: источник умер — запись тоже, итог живёт у владельца
+src.reset();
+CHECK(cache.size() == 0);
+CHECK(b->sr == 96000);
+}